@@ -135,6 +135,13 @@ execute function x and set the error code equal to its return value.
 #include <malloc.h>
 #include <math.h>
 #include <float.h>                                                             //(2.00.12 - LR)
+#ifdef WINDOWS
+#include <process.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#endif
 #include "hash.h"    
 #include "text.h"
 #include "types.h"
@@ -1839,6 +1846,7 @@ int DLLEXPORT ENsetnodevalue(int index, int code, float v)
             {
                if (demand->next == NULL) demand->Base = value/Ucf[FLOW];
             }
+            resetdemands();
          }
          break;
 
@@ -1852,6 +1860,7 @@ int DLLEXPORT ENsetnodevalue(int index, int code, float v)
             {
                if (demand->next == NULL) demand->Pat = j;
             }
+            resetdemands();
          }
          else Tank[index-Njuncs].Pat = j;
          break;
@@ -2925,6 +2934,69 @@ char* getTmpName(char* fname)
 }
 
 
+FILE *opentmpfile(char *fname, char *tmpname)
+/*---------------------------------------------------------------
+**  Input:   fname = name of a file about to be written
+**  Output:  tmpname = name of the file opened (MAXFNAME+1 chars)
+**  Returns: a new file opened for binary output (or NULL)
+**  Purpose: creates a uniquely named file in the same directory
+**           as fname that can be written and then renamed to
+**           fname without clashing with other runs writing the
+**           same file
+**---------------------------------------------------------------
+*/
+{
+   FILE *f = NULL;
+
+/* For Windows systems, add the process ID to the file name */
+#ifdef WINDOWS
+   if (snprintf(tmpname,MAXFNAME+1,"%s.%d.tmp",fname,_getpid())
+       > MAXFNAME) return(NULL);
+   f = fopen(tmpname,"wb");
+
+/* For other systems, add the process ID and a counter to the */
+/* file name, creating only a file that does not yet exist    */
+#else
+   int fd = -1;
+   int k;
+   for (k=0; k<100 && fd < 0; k++)
+   {
+      if (snprintf(tmpname,MAXFNAME+1,"%s.%ld.%d.tmp",fname,
+                   (long)getpid(),k) > MAXFNAME) return(NULL);
+      fd = open(tmpname,O_WRONLY | O_CREAT | O_EXCL,0666);
+      if (fd < 0 && errno != EEXIST) return(NULL);
+   }
+   if (fd < 0) return(NULL);
+   if ((f = fdopen(fd,"wb")) == NULL)
+   {
+      close(fd);
+      remove(tmpname);
+   }
+#endif
+   return(f);
+}                                       /*  End of opentmpfile  */
+
+
+unsigned long long hashbytes(void *buf, size_t n, unsigned long long hash)
+/*---------------------------------------------------------------
+**  Input:   buf  = array of bytes
+**           n    = number of bytes in buf
+**           hash = hash of any bytes that precede buf (0 if none)
+**  Returns: 64-bit FNV-1a hash of all the bytes
+**  Purpose: computes a checksum of data saved to or read from
+**           a file
+**---------------------------------------------------------------
+*/
+{
+   unsigned char *bytes = (unsigned char *)buf;
+   size_t k;
+
+   if (hash == 0) hash = 14695981039346656037ULL;
+   for (k=0; k<n; k++) hash = (hash ^ bytes[k]) * 1099511628211ULL;
+   return(hash);
+}                                       /*  End of hashbytes  */
+
+
 int  strcomp(char *s1, char *s2)
 /*---------------------------------------------------------------
 **  Input:   s1 = character string
@@ -35,6 +35,9 @@ int     openhydfile(void);                /* Opens hydraulics file      */
 int     openoutfile(void);                /* Opens binary output file   */
 int     strcomp(char *, char *);          /* Compares two strings       */
 char*   getTmpName(char* fname);          /* Gets temporary file name   */     //(2.00.12 - LR)
+FILE    *opentmpfile(char *, char *);     /* Opens unique temp. file    */
+unsigned long long hashbytes(void *,      /* Checksum of bytes          */
+               size_t, unsigned long long);
 double  interp(int, double *,             /* Interpolates a data curve  */
                double *, double);
 int     findnode(char *);                 /* Finds node's index from ID */
@@ -73,6 +76,12 @@ int     getfloat(char *, double *);       /* Converts string to double   */
 double  hour(char *, char *);             /* Converts time to hours     */
 int     setreport(char *);                /* Processes reporting command*/
 void    inperrmsg(int,int,char *);        /* Input error message        */
+int     openinpcache(void);               /* Reads cached input lines   */
+void    saveinpcache(void);               /* Saves cached input lines   */
+void    freeinpcache(void);               /* Frees cached input lines   */
+int     nextline(char *);                 /* Reads next line of input   */
+int     cachedtokens(char *);             /* Gets tokens of cached line */
+void    addcacheline(char *);             /* Adds line to input cache   */
 
 /* ---------- INPUT3.C -----------------*/
 int     juncdata(void);                   /* Processes junction data    */
@@ -109,6 +118,7 @@ void    addrule(char *);                  /* Adds rule to rule base     */
 int     allocrules(void);                 /* Allocates memory for rule  */
 int     ruledata(void);                   /* Processes rule input data  */
 int     checkrules(long);                 /* Checks all rules           */
+long    nextruleevent(long);              /* Time till premise can change*/
 void    freerules(void);                  /* Frees rule base memory     */  
 
 /* ------------- REPORT.C --------------*/
@@ -154,6 +164,9 @@ void    setlinkstatus(int, char, char *,  /* Sets link status           */
 void    setlinksetting(int, double,       /* Sets pump/valve setting    */
                        char *, double *);
 void    resistance(int);                  /* Computes resistance coeff. */
+int     initdemands(void);                /* Compresses demand data     */
+void    freedemands(void);                /* Frees compressed demands   */
+void    resetdemands(void);               /* Flags edited demand data   */
 void    demands(void);                    /* Computes current demands   */
 int     controls(void);                   /* Controls link settings     */
 long    timestep(void);                   /* Computes new time step     */
@@ -221,6 +234,12 @@ int     storesparse(int);                 /* Stores sparse matrix       */
 int     ordersparse(int);                 /* Orders matrix storage      */
 void    transpose(int,int *,int *,        /* Transposes sparse matrix   */
         int *,int *,int *,int *,int *);
+void    sparsekey(char *, SSparseKey *);  /* Identifies matrix cache    */
+int    *linkends(void);                   /* Lists links' end nodes     */
+int     readsparse(void);                 /* Reads cached matrix struct.*/
+void    savesparse(void);                 /* Saves matrix struct.       */
+unsigned long long sparsechecksum(       /* Checksum of matrix struct. */
+               unsigned long long);
 int     linsolve(int, double *, double *, /* Solution of linear eqns.   */
                  double *);               /* via Cholesky factorization */
 
@@ -28,6 +28,7 @@ AUTHOR:     L. Rossman
      nexthyd()    -- called from ENnextH() in EPANET.C
      closehyd()   -- called from ENcloseH() in EPANET.C
      tankvolume() -- called from ENsetnodevalue() in EPANET.C
+     resetdemands() -- called from ENsetnodevalue() in EPANET.C
      setlinkstatus(),
      setlinksetting(),
      resistance()-- all called from ENsetlinkvalue() in EPANET.C
@@ -82,6 +83,19 @@ double RelaxFactor;                                                            /
 /* Function to find flow coeffs. through open/closed valves */                 //(2.00.11 - LR)
 void valvecoeff(int k);                                                        //(2.00.11 - LR)
 
+/* Junction demands flattened into compressed arrays for use by demands() */
+int     *DemStart;     /* Position of each junction's first demand         */
+int     *DemPat;       /* Pattern index of each demand category            */
+double  *DemBase;      /* Baseline value of each demand category           */
+int     *PatJuncStart; /* Position of each pattern's first junction        */
+int     *PatJunc;      /* Junctions with a demand that uses each pattern   */
+double  *PatMult;      /* Current demand multiplier of each pattern        */
+double  *Djunc;        /* Current demand at each junction                  */
+double  *Dpos;         /* Sum of positive demand categories at a junction  */
+char    *Dchange;      /* Flags junctions whose demands must be recomputed */
+int     DemNpats;      /* Number of patterns when arrays were built        */
+int     Dreset;        /* Flag to rebuild arrays after demand edits        */
+
 
 int  openhyd()
 /*
@@ -96,6 +110,7 @@ int  openhyd()
    int  errcode = 0;
    ERRCODE(createsparse());     /* See SMATRIX.C  */
    ERRCODE(allocmatrix());      /* Allocate solution matrices */
+   ERRCODE(initdemands());      /* Compress demand categories */
    for (i=1; i<=Nlinks; i++)    /* Initialize flows */
       initlinkflow(i,Link[i].Stat,Link[i].Kc);
    return(errcode);
@@ -268,6 +283,7 @@ void  closehyd()
 {
    freesparse();           /* see SMATRIX.C */
    freematrix();
+   freedemands();
 }
 
 
@@ -561,6 +577,156 @@ void  resistance(int k)
 }
 
 
+int  initdemands()
+/*
+**--------------------------------------------------------------------
+**  Input:   none                                                      
+**  Output:  returns error code                                        
+**  Purpose: flattens the demand categories of all junctions into      
+**           compressed arrays, together with an index of the          
+**           junctions that use each time pattern                      
+**--------------------------------------------------------------------
+*/
+{
+   int  i,j,m,n;
+   int  *last;
+   int  errcode = 0;
+   Pdemand demand;
+
+   /* Count total number of demand categories */
+   m = 0;
+   for (i=1; i<=Njuncs; i++)
+   {
+      for (demand = Node[i].D; demand != NULL; demand = demand->next) m++;
+   }
+   n = MAX(m,1);
+
+   /* Allocate memory */
+   Dreset = FALSE;
+   DemNpats = Npats;
+   DemStart = (int *) calloc(Njuncs+2,sizeof(int));
+   DemPat   = (int *) calloc(n,sizeof(int));
+   DemBase  = (double *) calloc(n,sizeof(double));
+   PatJuncStart = (int *) calloc(Npats+2,sizeof(int));
+   PatJunc  = (int *) calloc(n,sizeof(int));
+   PatMult  = (double *) calloc(Npats+1,sizeof(double));
+   Djunc    = (double *) calloc(Njuncs+1,sizeof(double));
+   Dpos     = (double *) calloc(Njuncs+1,sizeof(double));
+   Dchange  = (char *) calloc(Njuncs+1,sizeof(char));
+   last     = (int *) calloc(Npats+1,sizeof(int));
+   ERRCODE(MEMCHECK(DemStart));
+   ERRCODE(MEMCHECK(DemPat));
+   ERRCODE(MEMCHECK(DemBase));
+   ERRCODE(MEMCHECK(PatJuncStart));
+   ERRCODE(MEMCHECK(PatJunc));
+   ERRCODE(MEMCHECK(PatMult));
+   ERRCODE(MEMCHECK(Djunc));
+   ERRCODE(MEMCHECK(Dpos));
+   ERRCODE(MEMCHECK(Dchange));
+   ERRCODE(MEMCHECK(last));
+   if (errcode)
+   {
+      free(last);
+      freedemands();
+      return(errcode);
+   }
+
+   /* Copy each junction's demands in the order of its demand list */
+   m = 0;
+   for (i=1; i<=Njuncs; i++)
+   {
+      DemStart[i] = m;
+      for (demand = Node[i].D; demand != NULL; demand = demand->next)
+      {
+         DemBase[m] = demand->Base;
+         DemPat[m] = demand->Pat;
+         m++;
+      }
+      Dchange[i] = 1;
+   }
+   DemStart[Njuncs+1] = m;
+
+   /* Count the junctions that use each pattern */
+   for (j=0; j<=Npats; j++)
+   {
+      last[j] = 0;
+      PatMult[j] = MISSING;
+   }
+   for (i=1; i<=Njuncs; i++)
+   {
+      for (m=DemStart[i]; m<DemStart[i+1]; m++)
+      {
+         j = DemPat[m];
+         if (last[j] == i) continue;
+         last[j] = i;
+         PatJuncStart[j+1]++;
+      }
+   }
+   for (j=0; j<=Npats; j++) PatJuncStart[j+1] += PatJuncStart[j];
+
+   /* List the junctions that use each pattern */
+   /* (last[] now holds next free position in PatJunc[]) */
+   for (j=0; j<=Npats; j++) last[j] = PatJuncStart[j];
+   for (i=1; i<=Njuncs; i++)
+   {
+      for (m=DemStart[i]; m<DemStart[i+1]; m++)
+      {
+         j = DemPat[m];
+         n = last[j];
+         if (n > PatJuncStart[j] && PatJunc[n-1] == i) continue;
+         PatJunc[n] = i;
+         last[j]++;
+      }
+   }
+   free(last);
+   return(errcode);
+}
+
+
+void  freedemands()
+/*
+**--------------------------------------------------------------------
+**  Input:   none                                                      
+**  Output:  none                                                      
+**  Purpose: frees memory used by the compressed demand arrays         
+**--------------------------------------------------------------------
+*/
+{
+   free(DemStart);
+   free(DemPat);
+   free(DemBase);
+   free(PatJuncStart);
+   free(PatJunc);
+   free(PatMult);
+   free(Djunc);
+   free(Dpos);
+   free(Dchange);
+   DemStart = NULL;
+   DemPat = NULL;
+   DemBase = NULL;
+   PatJuncStart = NULL;
+   PatJunc = NULL;
+   PatMult = NULL;
+   Djunc = NULL;
+   Dpos = NULL;
+   Dchange = NULL;
+}
+
+
+void  resetdemands()
+/*
+**--------------------------------------------------------------------
+**  Input:   none                                                      
+**  Output:  none                                                      
+**  Purpose: signals that a junction's demands were edited so the      
+**           compressed demand arrays must be rebuilt                  
+**--------------------------------------------------------------------
+*/
+{
+   Dreset = TRUE;
+}
+
+
 void  demands()
 /*
 **--------------------------------------------------------------------
@@ -572,15 +738,59 @@ void  demands()
 {
    int i,j,n;
    long k,p;
-   double djunc, sum;
+   double djunc, sum, pos;
    Pdemand demand;
 
    /* Determine total elapsed number of pattern periods */
    p = (Htime+Pstart)/Pstep;
 
-   /* Update demand at each node according to its assigned pattern */
+   /* Rebuild compressed demand arrays if demands or patterns were added */
+   if (DemStart != NULL && (Dreset || DemNpats != Npats))
+   {
+      freedemands();
+      initdemands();
+   }
+
+   /* Update demands using the compressed demand arrays */
    Dsystem = 0.0;          /* System-wide demand */
-   for (i=1; i<=Njuncs; i++)
+   if (DemStart != NULL)
+   {
+      /* Find each pattern's multiplier for the current period and */
+      /* flag the junctions that use any multiplier that changed   */
+      for (j=0; j<=Npats; j++)
+      {
+         k = p % (long) Pattern[j].Length;
+         djunc = Pattern[j].F[k]*Dmult;
+         if (djunc == PatMult[j]) continue;
+         PatMult[j] = djunc;
+         for (n=PatJuncStart[j]; n<PatJuncStart[j+1]; n++)
+            Dchange[PatJunc[n]] = 1;
+      }
+
+      /* Re-compute demands only at flagged junctions */
+      for (i=1; i<=Njuncs; i++)
+      {
+         if (Dchange[i])
+         {
+            sum = 0.0;
+            pos = 0.0;
+            for (n=DemStart[i]; n<DemStart[i+1]; n++)
+            {
+               djunc = DemBase[n]*PatMult[DemPat[n]];
+               if (djunc > 0.0) pos += djunc;
+               sum += djunc;
+            }
+            Djunc[i] = sum;
+            Dpos[i] = pos;
+            Dchange[i] = 0;
+         }
+         D[i] = Djunc[i];
+         Dsystem += Dpos[i];
+      }
+   }
+
+   /* Otherwise update demand at each node according to its pattern */
+   else for (i=1; i<=Njuncs; i++)
    {
       sum = 0.0;
       for (demand = Node[i].D; demand != NULL; demand = demand->next)
@@ -849,7 +1059,8 @@ void  ruletimestep(long *tstep)
    long tnow,      /* Start of time interval for rule evaluation */
         tmax,      /* End of time interval for rule evaluation   */
         dt,        /* Normal time increment for rule evaluation  */
-        dt1;       /* Actual time increment for rule evaluation  */
+        dt1,       /* Actual time increment for rule evaluation  */
+        te;        /* Time until a rule premise can change       */
 
    /* Find interval of time for rule evaluation */
    tnow = Htime;
@@ -885,7 +1096,9 @@ void  ruletimestep(long *tstep)
    **       It is restored to its original value after the
    **       rule evaluation process is completed (see below).
    **       Also note that dt1 will equal dt after the first
-   **       time increment is taken.
+   **       time increment is taken, except when no rule premise
+   **       can change before a later rule time is reached, in
+   **       which case the intermediate rule times are skipped.
    */
    do
    {
@@ -894,6 +1107,18 @@ void  ruletimestep(long *tstep)
       if (checkrules(dt1)) break; /* Stop if rules fire      */
       dt = MIN(dt, tmax - Htime); /* Update time increment   */
       dt1 = dt;                   /* Update actual increment */
+
+      /* Jump to the last rule time before the next premise event */
+      if (dt > 0)
+      {
+         te = nextruleevent(tmax - Htime);
+         if (te >= tmax - Htime) dt1 = tmax - Htime;
+         else
+         {
+            te = ((Htime + te - 1)/Rulestep)*Rulestep - Htime;
+            if (te > dt1) dt1 = te;
+         }
+      }
    }  while (dt > 0);             /* Stop if no time left    */
 
    /* Compute an updated simulation time step (*tstep) */
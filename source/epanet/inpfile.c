@@ -546,6 +546,8 @@ int  saveinpfile(char *fname)
    fprintf(f, "\n CHECKFREQ           %-d", CheckFreq);
    fprintf(f, "\n MAXCHECK            %-d", MaxCheck);
    fprintf(f, "\n DAMPLIMIT           %-.8f", DampLimit);
+   if (!Cacheflag)
+   fprintf(f, "\n CACHE               NO");
 
 /* Write [REPORT] section */
 
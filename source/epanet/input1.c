@@ -113,6 +113,7 @@ void  setdefaults()
    Pressflag = PSI;             /* Pressure units are psi         */
    Tstatflag = SERIES;          /* Generate time series output    */
    Warnflag  = FALSE;           /* Warning flag is off            */
+   Cacheflag = TRUE;            /* Save & re-use cache files      */
    Htol      = HTOL;            /* Default head tolerance         */
    Qtol      = QTOL;            /* Default flow tolerance         */
    Hacc      = HACC;            /* Default hydraulic accuracy     */
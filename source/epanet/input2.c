@@ -16,6 +16,16 @@ The entry points for this module are:
    netsize()   -- called from ENopen() in EPANET.C
    readdata()  -- called from getdata() in INPUT1.C
 
+Lines of data read from the input file, together with their tokens,
+are kept in a binary cache file (the input file's name with ".icc"
+appended) once the file has been read without error, unless the
+CACHE option is NO. While the input file's contents stay the same
+(judged by its size and a 64-bit hash of its bytes) and the cache's
+checksum matches, netsize() and readdata() read the cached lines
+instead, skipping over blank & comment lines and the tokenizing of
+each line. (A file that sets CACHE to NO never has a cache saved
+for it.)
+
 The following utility functions are all called from INPUT3.C
    addnodeID()
    addlinkID()
@@ -47,6 +57,32 @@ char   *Tok[MAXTOKS];     /* Array of token strings            */
 STmplist  *PrevPat;       /* Pointer to pattern list element   */
 STmplist  *PrevCurve;     /* Pointer to curve list element     */
 
+typedef struct            /* Identifies data in an input cache */
+{
+   unsigned long long Size;  /* Size of input file (bytes)     */
+   unsigned long long Hash;  /* Hash of input file's contents  */
+   int    Maxline;        /* Max. characters per input line    */
+   int    Maxtoks;        /* Max. tokens per input line        */
+}  SInpCacheKey;
+
+typedef struct            /* Heading of a cached input line    */
+{
+   int    Linesize;       /* Bytes in text of line             */
+   int    Toksize;        /* Bytes in line's tokens            */
+   int    Ntoks;          /* Number of tokens on line          */
+}  SInpCacheLine;
+
+                          /* Cache of tokenized input lines:   */
+char   *InpCache;         /* Cached lines of input             */
+size_t InpCacheSize,      /* Bytes of cached lines             */
+       InpCacheMax,       /* Bytes allocated for cached lines  */
+       InpCachePos;       /* Position of next cached line      */
+int    InpCacheUse,       /* TRUE if reading from input cache  */
+       InpCacheSave;      /* TRUE if saving to input cache     */
+char   InpCacheName[MAXFNAME+1]; /* Name of input cache file   */
+SInpCacheKey  InpCacheKey;       /* Identifies input cache data*/
+SInpCacheLine InpCacheLine;      /* Current cached line        */
+
                           /* Defined in enumstxt.h in EPANET.C */
 extern char *SectTxt[];   /* Input section keywords            */
 extern char *RptSectTxt[];
@@ -81,8 +117,11 @@ int  netsize()
    MaxPats = -1;
    addpattern("");
 
+/* See if lines of input can be read from a cache file */
+   openinpcache();
+
 /* Make pass through data file counting number of each component */
-   while (fgets(line,MAXLINE,InFile) != NULL)
+   while (nextline(line))
    {
    /* Skip blank lines & those beginning with a comment */
       tok = strtok(line,SEPSTR);
@@ -129,6 +168,7 @@ int  netsize()
       if (MaxJuncs < 1) errcode = 223;       /* Not enough nodes */
       else if (MaxTanks == 0) errcode = 224; /* No tanks */
    }
+   if (errcode) freeinpcache();
    return(errcode);
 }                        /*  End of netsize  */
 
@@ -174,16 +214,23 @@ int  readdata()
       errsum    = 0;
 
    /* Read each line from input file. */
-      while (fgets(line,MAXLINE,InFile) != NULL)
+      InpCachePos = 0;
+      while (nextline(line))
       {
 
       /* Make copy of line and scan for tokens */
-         strcpy(wline,line);
-         Ntokens = gettokens(wline);
+      /* (or retrieve them from input cache)   */
+         if (InpCacheUse) Ntokens = cachedtokens(wline);
+         else
+         {
+            strcpy(wline,line);
+            Ntokens = gettokens(wline);
+         }
 
        /* Skip blank lines and comments */
          if (Ntokens == 0) continue;
          if (*Tok[0] == ';') continue;
+         if (InpCacheSave) addcacheline(line);
 
       /* Check if max. length exceeded */
          if (strlen(line) >= MAXLINE)
@@ -229,7 +276,9 @@ int  readdata()
 
    /* Check for errors */
       if (errsum > 0)  errcode = 200;
+      else if (InpCacheSave && Cacheflag) saveinpcache();
    }
+   freeinpcache();
 
 /* Check for unlinked nodes */
    if (!errcode) errcode = unlinked();
@@ -961,6 +1010,252 @@ void  inperrmsg(int err, int sect, char *line)
    else writeline("");
 }
 
+
+int  openinpcache()
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  returns TRUE if lines of input are read from the
+**           input cache file, FALSE if not
+**  Purpose: reads in lines of input from the input file's
+**           cache file if it holds the file's current data
+**--------------------------------------------------------------
+*/
+{
+   FILE   *f;
+   char   stamp[] = "EPANET2-INPCACHE";
+   char   fstamp[] = "EPANET2-INPCACHE";
+   char   buf[4096];
+   size_t n;
+   unsigned long long size = 0;
+   unsigned long long hash = 0;
+   unsigned long long checksum = 0;
+   SInpCacheKey filekey;
+
+/* Identify the data held in the cache file */
+   freeinpcache();
+   InpCacheUse = FALSE;
+   InpCacheSave = FALSE;
+   InpCachePos = 0;
+   if (snprintf(InpCacheName,sizeof(InpCacheName),"%s.icc",InpFname)
+       >= (int)sizeof(InpCacheName)) return(FALSE);
+
+/* Key the cache on a 64-bit FNV-1a hash of the input file's bytes */
+   rewind(InFile);
+   while ((n = fread(buf,1,sizeof(buf),InFile)) > 0)
+   {
+      hash = hashbytes(buf,n,hash);
+      size += n;
+   }
+   if (ferror(InFile)) return(FALSE);
+   rewind(InFile);
+   memset(&InpCacheKey,0,sizeof(SInpCacheKey));
+   InpCacheKey.Size = size;
+   InpCacheKey.Hash = hash;
+   InpCacheKey.Maxline = MAXLINE;
+   InpCacheKey.Maxtoks = MAXTOKS;
+   InpCacheSave = TRUE;
+
+/* Check that cache file holds data with the same key */
+   if ((f = fopen(InpCacheName,"rb")) == NULL) return(FALSE);
+   memset(&filekey,0,sizeof(SInpCacheKey));
+   size = 0;
+   fread(fstamp,sizeof(char),strlen(stamp),f);
+   fread(&filekey,sizeof(SInpCacheKey),1,f);
+   fread(&size,sizeof(size),1,f);
+   if (strcmp(fstamp,stamp) != 0
+   ||  memcmp(&filekey,&InpCacheKey,sizeof(SInpCacheKey)) != 0
+   ||  size == 0)
+   {
+      fclose(f);
+      return(FALSE);
+   }
+
+/* Read the cached lines & check that they match the */
+/* checksum saved after them                          */
+   InpCache = (char *) malloc((size_t)size);
+   if (InpCache == NULL || fread(InpCache,1,(size_t)size,f) < (size_t)size
+   ||  fread(&checksum,sizeof(checksum),1,f) < 1
+   ||  checksum != hashbytes(InpCache,(size_t)size,0))
+   {
+      freeinpcache();
+      fclose(f);
+      return(FALSE);
+   }
+   fclose(f);
+   InpCacheSize = (size_t)size;
+   InpCacheMax = InpCacheSize;
+   InpCacheUse = TRUE;
+   InpCacheSave = FALSE;
+   return(TRUE);
+}                        /* End of openinpcache */
+
+
+void  saveinpcache()
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: saves lines of input to the input file's cache file
+**
+**  Failure to save the cache file is not an error; the input
+**  file will simply be read again next time. The file is written
+**  under a unique temporary name and then renamed, so that a
+**  partly written cache file is never read and concurrent runs
+**  saving the same cache do not write into each other's file.
+**--------------------------------------------------------------
+*/
+{
+   FILE  *f;
+   char  stamp[] = "EPANET2-INPCACHE";
+   char  tmpname[MAXFNAME+1];
+   unsigned long long size = InpCacheSize;
+   unsigned long long checksum;
+   int   ok;
+
+   if (InpCache == NULL) return;
+   checksum = hashbytes(InpCache,InpCacheSize,0);
+   if ((f = opentmpfile(InpCacheName,tmpname)) == NULL) return;
+   fwrite(stamp,sizeof(char),strlen(stamp),f);
+   fwrite(&InpCacheKey,sizeof(SInpCacheKey),1,f);
+   fwrite(&size,sizeof(size),1,f);
+   ok = (fwrite(InpCache,1,InpCacheSize,f) == InpCacheSize);
+   if (fwrite(&checksum,sizeof(checksum),1,f) < 1) ok = FALSE;
+   if (fclose(f) != 0) ok = FALSE;
+   if (!ok)
+   {
+      remove(tmpname);
+      return;
+   }
+
+/* Replace any existing cache file (rename() fails */
+/* on Windows if the new name already exists)      */
+   if (rename(tmpname,InpCacheName) != 0)
+   {
+      remove(InpCacheName);
+      if (rename(tmpname,InpCacheName) != 0) remove(tmpname);
+   }
+}                        /* End of saveinpcache */
+
+
+void  freeinpcache()
+/*
+**--------------------------------------------------------------
+**  Input:   none
+**  Output:  none
+**  Purpose: frees memory used for cached lines of input
+**--------------------------------------------------------------
+*/
+{
+   if (InpCache != NULL) free(InpCache);
+   InpCache = NULL;
+   InpCacheSize = 0;
+   InpCacheMax = 0;
+}                        /* End of freeinpcache */
+
+
+int  nextline(char *line)
+/*
+**--------------------------------------------------------------
+**  Input:   *line = buffer of MAXLINE+1 characters
+**  Output:  returns TRUE if a line was read, FALSE at end of input
+**  Purpose: reads next line of input, either from the input file
+**           or, skipping over blank & comment lines, from the
+**           input cache
+**--------------------------------------------------------------
+*/
+{
+   if (InpCacheUse)
+   {
+      if (InpCachePos >= InpCacheSize) return(FALSE);
+      memcpy(&InpCacheLine,InpCache+InpCachePos,sizeof(SInpCacheLine));
+      InpCachePos += sizeof(SInpCacheLine);
+      memcpy(line,InpCache+InpCachePos,InpCacheLine.Linesize);
+      InpCachePos += InpCacheLine.Linesize + InpCacheLine.Toksize;
+      return(TRUE);
+   }
+   return(fgets(line,MAXLINE,InFile) != NULL);
+}                        /* End of nextline */
+
+
+int  cachedtokens(char *s)
+/*
+**--------------------------------------------------------------
+**  Input:   *s = buffer of MAXLINE+1 characters
+**  Output:  returns number of tokens retrieved
+**  Purpose: copies tokens of the line last read from the input
+**           cache into s, saving pointers to them in module
+**           global variable Tok[]
+**--------------------------------------------------------------
+*/
+{
+   int n;
+
+/* Copy the line's tokens into s */
+   memcpy(s,InpCache+InpCachePos-InpCacheLine.Toksize,InpCacheLine.Toksize);
+
+/* Point to each token */
+   for (n=0; n<MAXTOKS; n++) Tok[n] = NULL;
+   for (n=0; n<InpCacheLine.Ntoks; n++)
+   {
+      Tok[n] = s;
+      s += strlen(s) + 1;
+   }
+   return(InpCacheLine.Ntoks);
+}                        /* End of cachedtokens */
+
+
+void  addcacheline(char *line)
+/*
+**--------------------------------------------------------------
+**  Input:   *line = line read from input file
+**  Output:  none
+**  Purpose: adds a line of input and its tokens to input cache
+**
+**  The input cache is simply not saved if memory runs short.
+**--------------------------------------------------------------
+*/
+{
+   int    n;
+   size_t size;
+   char   *newcache, *c;
+   SInpCacheLine cacheline;
+
+/* Find size of the line and its tokens */
+   cacheline.Linesize = strlen(line) + 1;
+   cacheline.Toksize = 0;
+   cacheline.Ntoks = Ntokens;
+   for (n=0; n<Ntokens; n++) cacheline.Toksize += strlen(Tok[n]) + 1;
+   size = sizeof(SInpCacheLine) + cacheline.Linesize + cacheline.Toksize;
+
+/* Enlarge the cache if need be */
+   if (InpCacheSize + size > InpCacheMax)
+   {
+      InpCacheMax = 2*InpCacheMax + size + 65536;
+      newcache = (char *) realloc(InpCache,InpCacheMax);
+      if (newcache == NULL)
+      {
+         freeinpcache();
+         InpCacheSave = FALSE;
+         return;
+      }
+      InpCache = newcache;
+   }
+
+/* Append the line and its tokens */
+   c = InpCache + InpCacheSize;
+   memcpy(c,&cacheline,sizeof(SInpCacheLine));
+   c += sizeof(SInpCacheLine);
+   memcpy(c,line,cacheline.Linesize);
+   c += cacheline.Linesize;
+   for (n=0; n<Ntokens; n++)
+   {
+      strcpy(c,Tok[n]);
+      c += strlen(Tok[n]) + 1;
+   }
+   InpCacheSize += size;
+}                        /* End of addcacheline */
+
 /********************** END OF INPUT2.C ************************/
 
 
@@ -1473,6 +1473,7 @@ int  optionchoice(int n)
 **    VERIFY              filename                               
 **    UNBALANCED          STOP/CONTINUE {Niter}
 **    PATTERN             id
+**    CACHE               YES/NO
 **--------------------------------------------------------------
 */
 {
@@ -1574,6 +1575,13 @@ int  optionchoice(int n)
       if (n < 1) return(0);
       strncpy(DefPatID,Tok[1],MAXID);
    }
+   else if (match(Tok[0],w_CACHE))              /* Cache files option */
+   {
+      if (n < 1) return(0);
+      if (match(Tok[1],w_YES)) Cacheflag = TRUE;
+      else if (match(Tok[1],w_NO)) Cacheflag = FALSE;
+      else return(201);
+   }
    else return(-1);
    return(0);
 }                        /* end of optionchoice */
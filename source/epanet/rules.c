@@ -19,6 +19,7 @@ AUTHOR:     L. Rossman
      ruledata()   -- called from newline() in INPUT2.C
      freerules()  -- called from freedata() in EPANET.C
      checkrules() -- called from ruletimestep() in HYDRAUL.C
+     nextruleevent() -- called from ruletimestep() in HYDRAUL.C
 
 **********************************************************************
 */
@@ -117,6 +118,8 @@ int     checkpremise(struct Premise *);
 int     checktime(struct Premise *);
 int     checkstatus(struct Premise *);
 int     checkvalue(struct Premise *);
+long    timeevent(struct Premise *, long);
+long    tankevent(struct Premise *, long);
 int     takeactions(void);
 void    clearactlist(void);
 void    clearrules(void);
@@ -211,6 +214,127 @@ int checkrules(long dt)
 }
 
 
+long  nextruleevent(long tmax)
+/*
+**-----------------------------------------------------------
+**    Finds the time (sec) from the current time until the
+**    earliest moment at which any rule premise can change its
+**    truth value, assuming tank inflows stay at their current
+**    rates. Only time premises and premises on tank levels,
+**    heads, pressures and fill/drain times can change between
+**    hydraulic solutions. Returns tmax if no such event occurs
+**    within tmax seconds.
+**    Called by ruletimestep() in HYDRAUL.C.
+**-----------------------------------------------------------
+*/
+{
+   int   i;
+   long  t;
+   struct Premise *p;
+
+   for (i=1; i<=Nrules; i++)
+   {
+      p = Rule[i].Pchain;
+      while (p != NULL)
+      {
+         if (p->variable == r_TIME || p->variable == r_CLOCKTIME)
+            t = timeevent(p, tmax);
+         else t = tankevent(p, tmax);
+         if (t < tmax) tmax = t;
+         p = p->next;
+      }
+   }
+   return(tmax);
+}
+
+
+long  timeevent(struct Premise *p, long tmax)
+/*
+**-----------------------------------------------------------
+**    Finds time until a time premise can next change value.
+**    Both the premise's time and the second after it are
+**    treated as events so that strict and non-strict
+**    relational operators are both caught. For clock time
+**    premises the wrap-around at midnight is also an event.
+**-----------------------------------------------------------
+*/
+{
+   long  t, t1, x;
+
+   x = (long)(p->value);
+   if (p->variable == r_TIME)
+   {
+      t1 = x - Htime;
+      if (t1 > 0 && t1 < tmax) return(t1);
+      if (t1 + 1 > 0 && t1 + 1 < tmax) return(t1 + 1);
+      return(tmax);
+   }
+   t = (Htime + Tstart) % SECperDAY;
+   t1 = (x - t + SECperDAY) % SECperDAY;
+   if (t1 == 0) t1 = 1;
+   tmax = MIN(tmax, t1);
+   tmax = MIN(tmax, SECperDAY - t);
+   return(tmax);
+}
+
+
+long  tankevent(struct Premise *p, long tmax)
+/*
+**-----------------------------------------------------------
+**    Finds time until a premise on a tank's level, head,
+**    pressure, fill time or drain time can next change value.
+**    The tolerance band used by checkvalue() is respected by
+**    treating both of its edges as crossing points.
+**-----------------------------------------------------------
+*/
+{
+   int    i, j, k;
+   long   tmin = tmax;
+   double h, q, t, x,
+          tol = 1.e-3;
+
+   /* Only premises on tanks (not reservoirs) change between solutions */
+   i = p->index;
+   if (p->object != r_NODE || i <= Njuncs) return(tmax);
+   j = i - Njuncs;
+   if (Tank[j].A == 0.0) return(tmax);
+   q = D[i];
+   if (ABS(q) <= TINY) return(tmax);
+
+   for (k = -1; k <= 1; k += 2)
+   {
+      x = p->value + k*tol;
+      switch (p->variable)
+      {
+         case r_HEAD:
+         case r_GRADE:    h = x/Ucf[HEAD]; break;
+         case r_LEVEL:    h = Node[i].El + x/Ucf[HEAD]; break;
+         case r_PRESSURE: h = Node[i].El + x/Ucf[PRESSURE]; break;
+
+         /* Fill & drain times fall at one second per second */
+         case r_FILLTIME:
+         case r_DRAINTIME:
+            if (p->variable == r_FILLTIME) t = (Tank[j].Vmax - Tank[j].V)/q;
+            else                           t = (Tank[j].Vmin - Tank[j].V)/q;
+            t = t - x;
+            if (t > 0.0 && t < tmin) tmin = (long)t;
+            continue;
+
+         default: return(tmax);
+      }
+
+      /* Time for tank to reach grade h (tanktimestep() covers full/empty) */
+      if (h <= Tank[j].Hmin || h >= Tank[j].Hmax) continue;
+      if ((q > 0.0 && h > H[i]) || (q < 0.0 && h < H[i]))
+      {
+         t = (tankvolume(j,h) - Tank[j].V)/q;
+         if (t < tmin) tmin = (long)t;
+      }
+   }
+   return(MAX(tmin, 1));
+}
+
+
 int  ruledata()
 /*
 **--------------------------------------------------------------
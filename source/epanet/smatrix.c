@@ -24,6 +24,12 @@ Createsparse() does the following:
    3. converts the adjacency lists into a compact scheme         
       for storing the non-zero coeffs. in the lower diagonal     
       portion of the solution matrix (see storesparse())         
+The results of steps 1 - 3 are saved to a binary cache file      
+(the input file's name with ".smc" appended) and are read back   
+from it, instead of being re-computed, by later runs of networks 
+with the same size and link connectivity whose cache checksum    
+matches (see readsparse()). Neither is done when the CACHE       
+option is NO.                                                    
 Freesparse() frees the memory used for the sparse matrix.        
 Linsolve() solves the linearized system of hydraulic equations.  
 
@@ -59,6 +65,10 @@ int  createsparse()
    ERRCODE(allocsparse());
    if (errcode) return(errcode);
 
+   /* Use the matrix structure found for a network with the */
+   /* same connectivity if it was saved to a cache file.    */
+   if (Cacheflag && readsparse()) return(buildlists(FALSE));
+
    /* Build node-link adjacency lists with parallel links removed. */
    Degree = (int *) calloc(Nnodes+1, sizeof(int));
    ERRCODE(MEMCHECK(Degree));
@@ -84,6 +94,9 @@ int  createsparse()
    if (!errcode) freelists();
    ERRCODE(ordersparse(Njuncs));
 
+   /* Save the matrix structure to a cache file */
+   if (!errcode && Cacheflag) savesparse();
+
    /* Re-build adjacency lists without removing parallel */
    /* links for use in future connectivity checking.     */
    ERRCODE(buildlists(FALSE));
@@ -589,6 +602,226 @@ void  transpose(int n, int *il, int *jl, int *xl, int *ilt, int *jlt,
 }                        /* End of transpose */
 
 
+void  sparsekey(char *fname, SSparseKey *key)
+/*
+**--------------------------------------------------------------
+** Input:   none                                                
+** Output:  fname = name of sparse matrix cache file            
+**          key = identifies the network's sparse matrix        
+** Purpose: identifies the cache file that holds the structure  
+**          of the network's sparse matrix
+**
+** The key only holds the network's size. The end nodes of every
+** link are also saved to the cache file and must match exactly
+** (see linkends()).
+**--------------------------------------------------------------
+*/
+{
+   memset(key,0,sizeof(SSparseKey));
+   key->Nnodes = Nnodes;
+   key->Njuncs = Njuncs;
+   key->Nlinks = Nlinks;
+   if (snprintf(fname,MAXFNAME+1,"%s.smc",InpFname) > MAXFNAME)
+      strcpy(fname,"");
+}                        /* End of sparsekey */
+
+
+int  *linkends()
+/*
+**--------------------------------------------------------------
+** Input:   none                                                
+** Output:  returns array holding the start and end node of     
+**          each link (NULL if out of memory)                   
+** Purpose: lists the network's connectivity for comparison     
+**          with that saved in a sparse matrix cache file       
+**--------------------------------------------------------------
+*/
+{
+   int  k;
+   int  *ends = (int *) calloc(2*Nlinks+2, sizeof(int));
+
+   if (ends == NULL) return(NULL);
+   for (k=1; k<=Nlinks; k++)
+   {
+      ends[2*k]   = Link[k].N1;
+      ends[2*k+1] = Link[k].N2;
+   }
+   return(ends);
+}                        /* End of linkends */
+
+
+int  readsparse()
+/*
+**--------------------------------------------------------------
+** Input:   none                                                
+** Output:  returns TRUE if matrix structure was read from      
+**          cache file, FALSE if not                            
+** Purpose: reads the node re-ordering and sparse storage       
+**          scheme of the solution matrix from a cache file     
+**--------------------------------------------------------------
+*/
+{
+   FILE  *f;
+   char  fname[MAXFNAME+1];
+   char  stamp[] = "EPANET2-SMCACHE";
+   char  fstamp[] = "EPANET2-SMCACHE";
+   int   n = Njuncs;
+   int   m = 2*Nlinks+2;
+   int   ok;
+   int   *ends, *fileends;
+   unsigned long long checksum = 0, filechecksum = 0;
+   SSparseKey key, filekey;
+
+   /* Check that cache file holds data for the same network */
+   sparsekey(fname,&key);
+   if (strlen(fname) == 0) return(FALSE);
+   if ((f = fopen(fname,"rb")) == NULL) return(FALSE);
+   memset(&filekey,0,sizeof(SSparseKey));
+   fread(fstamp,sizeof(char),strlen(stamp),f);
+   fread(&filekey,sizeof(SSparseKey),1,f);
+   if (strcmp(fstamp,stamp) != 0
+   ||  memcmp(&filekey,&key,sizeof(SSparseKey)) != 0)
+   {
+      fclose(f);
+      return(FALSE);
+   }
+
+   /* Check that every link joins the same nodes */
+   ends = linkends();
+   fileends = (int *) calloc(m, sizeof(int));
+   ok = (ends != NULL && fileends != NULL &&
+         fread(fileends,sizeof(int),m,f) == (size_t)m &&
+         memcmp(fileends,ends,m*sizeof(int)) == 0);
+   if (ok) checksum = hashbytes(fileends,m*sizeof(int),0);
+   free(ends);
+   free(fileends);
+   Ncoeffs = 0;
+   if (ok) fread(&Ncoeffs,sizeof(int),1,f);
+   if (!ok || Ncoeffs < Nlinks)
+   {
+      fclose(f);
+      return(FALSE);
+   }
+
+   /* Read node ordering & sparse storage scheme */
+   XLNZ  = (int *) calloc(n+2, sizeof(int));
+   NZSUB = (int *) calloc(Ncoeffs+2, sizeof(int));
+   LNZ   = (int *) calloc(Ncoeffs+2, sizeof(int));
+   ok = (XLNZ != NULL && NZSUB != NULL && LNZ != NULL);
+   if (ok) ok =
+      fread(Order,sizeof(int),Nnodes+1,f) == (size_t)(Nnodes+1) &&
+      fread(Row,sizeof(int),Nnodes+1,f) == (size_t)(Nnodes+1) &&
+      fread(Ndx,sizeof(int),Nlinks+1,f) == (size_t)(Nlinks+1) &&
+      fread(XLNZ,sizeof(int),n+2,f) == (size_t)(n+2) &&
+      fread(NZSUB,sizeof(int),Ncoeffs+2,f) == (size_t)(Ncoeffs+2) &&
+      fread(LNZ,sizeof(int),Ncoeffs+2,f) == (size_t)(Ncoeffs+2) &&
+      fread(&filechecksum,sizeof(filechecksum),1,f) == 1;
+   fclose(f);
+
+   /* Check that the data read match the checksum saved after them */
+   if (ok) ok = (sparsechecksum(checksum) == filechecksum);
+   if (!ok)
+   {
+      free(XLNZ);
+      free(NZSUB);
+      free(LNZ);
+      XLNZ = NULL;
+      NZSUB = NULL;
+      LNZ = NULL;
+   }
+   return(ok);
+}                        /* End of readsparse */
+
+
+void  savesparse()
+/*
+**--------------------------------------------------------------
+** Input:   none                                                
+** Output:  none                                                
+** Purpose: saves the node re-ordering and sparse storage       
+**          scheme of the solution matrix to a cache file       
+**                                                              
+** Failure to save the cache file is not an error; the matrix   
+** structure will simply be re-computed next time. The file is  
+** written under a unique temporary name and then renamed, so   
+** that a partly written cache file is never read and concurrent
+** runs saving the same cache do not write into each other's    
+** file.                                                        
+**--------------------------------------------------------------
+*/
+{
+   FILE  *f;
+   char  fname[MAXFNAME+1];
+   char  tmpname[MAXFNAME+1];
+   char  stamp[] = "EPANET2-SMCACHE";
+   int   n = Njuncs;
+   int   m = 2*Nlinks+2;
+   int   ok;
+   int   *ends;
+   unsigned long long checksum;
+   SSparseKey key;
+
+   sparsekey(fname,&key);
+   if (strlen(fname) == 0) return;
+   if ((ends = linkends()) == NULL) return;
+   if ((f = opentmpfile(fname,tmpname)) == NULL)
+   {
+      free(ends);
+      return;
+   }
+   checksum = sparsechecksum(hashbytes(ends,m*sizeof(int),0));
+   fwrite(stamp,sizeof(char),strlen(stamp),f);
+   fwrite(&key,sizeof(SSparseKey),1,f);
+   fwrite(ends,sizeof(int),m,f);
+   free(ends);
+   fwrite(&Ncoeffs,sizeof(int),1,f);
+   fwrite(Order,sizeof(int),Nnodes+1,f);
+   fwrite(Row,sizeof(int),Nnodes+1,f);
+   fwrite(Ndx,sizeof(int),Nlinks+1,f);
+   fwrite(XLNZ,sizeof(int),n+2,f);
+   fwrite(NZSUB,sizeof(int),Ncoeffs+2,f);
+   fwrite(LNZ,sizeof(int),Ncoeffs+2,f);
+   ok = (fwrite(&checksum,sizeof(checksum),1,f) == 1);
+   if (ferror(f)) ok = FALSE;
+   if (fclose(f) != 0) ok = FALSE;
+   if (!ok)
+   {
+      remove(tmpname);
+      return;
+   }
+
+   /* Replace any existing cache file (rename() fails */
+   /* on Windows if the new name already exists)      */
+   if (rename(tmpname,fname) != 0)
+   {
+      remove(fname);
+      if (rename(tmpname,fname) != 0) remove(tmpname);
+   }
+}                        /* End of savesparse */
+
+
+unsigned long long  sparsechecksum(unsigned long long hash)
+/*
+**--------------------------------------------------------------
+** Input:   hash = checksum of the link end nodes saved to a    
+**                 sparse matrix cache file                     
+** Output:  returns checksum of the cache file's contents       
+** Purpose: computes the checksum that guards the node          
+**          re-ordering and sparse storage scheme saved to a    
+**          sparse matrix cache file                            
+**--------------------------------------------------------------
+*/
+{
+   hash = hashbytes(&Ncoeffs,sizeof(int),hash);
+   hash = hashbytes(Order,(Nnodes+1)*sizeof(int),hash);
+   hash = hashbytes(Row,(Nnodes+1)*sizeof(int),hash);
+   hash = hashbytes(Ndx,(Nlinks+1)*sizeof(int),hash);
+   hash = hashbytes(XLNZ,(Njuncs+2)*sizeof(int),hash);
+   hash = hashbytes(NZSUB,(Ncoeffs+2)*sizeof(int),hash);
+   return(hashbytes(LNZ,(Ncoeffs+2)*sizeof(int),hash));
+}                        /* End of sparsechecksum */
+
+
 int  linsolve(int n, double *Aii, double *Aij, double *B)
 /*
 **--------------------------------------------------------------
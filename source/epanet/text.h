@@ -175,6 +175,8 @@ AUTHOR:     L. Rossman
 #define   w_STOP        "STOP"
 #define   w_CONTINUE    "CONT"
 
+#define   w_CACHE       "CACH"
+
 #define   w_RULE        "RULE"
 #define   w_IF          "IF"
 #define   w_AND         "AND"
@@ -282,6 +282,13 @@ struct   Sadjlist         /* NODE ADJACENCY LIST ITEM */
 /* Pointer to adjacency list item */
 typedef struct Sadjlist *Padjlist; 
 
+typedef struct             /* SPARSE MATRIX CACHE KEY */
+{
+   int      Nnodes;        /* Number of nodes          */
+   int      Njuncs;        /* Number of junctions      */
+   int      Nlinks;        /* Number of links          */
+}  SSparseKey;
+
 struct  Sseg               /* PIPE SEGMENT record used */
 {                          /*   for WQ routing         */
    double  v;              /* Segment volume      */
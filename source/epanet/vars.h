@@ -53,6 +53,7 @@ EXTERN char     Msg[MAXMSG+1],         /* Text of output message       */
                 Linkflag,              /* Link report flag             */
                 Tstatflag,             /* Time statistics flag         */
                 Warnflag,              /* Warning flag                 */
+                Cacheflag,             /* Cache files flag             */
                 Openflag,              /* Input processed flag         */
                 OpenHflag,             /* Hydraul. system opened flag  */
                 SaveHflag,             /* Hydraul. results saved flag  */
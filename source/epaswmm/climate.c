@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <sys/stat.h>
 #include "headers.h"
 
 //-----------------------------------------------------------------------------
@@ -60,11 +61,22 @@ static int      FileFormat;            // file format (see ClimateFileFormats)
 static int      FileYear;              // current year of file data
 static int      FileMonth;             // current month of year of file data
 static int      FileDay;               // current day of month of file data
-static int      FileLastDay;           // last day of current month of file data
 static int      FileElapsedDays;       // number of days read from file
 static double   FileValue[4];          // current day's values of climate data
 static double   FileData[4][32];       // month's worth of daily climate data
 static char     FileLine[MAXLINE+1];   // line from climate data file
+static double*  FileDailyData;         // daily climate data for whole run
+static int      FileDayCount;          // number of days in FileDailyData
+static int      FileStartIndex;        // FileDailyData index of first day
+
+typedef struct                         // Identifies data in a climate cache
+{                                      // ----------------------------------
+   FilePos    fileSize;                // size of climate file (bytes)
+   FilePos    fileTime;                // time climate file was last modified
+   int        startYear;               // year of first month of data
+   int        startMonth;              // first month of data
+   int        unitSystem;              // US or SI units
+}  TClimateCacheKey;
 
 //-----------------------------------------------------------------------------
 //  External functions (defined in funcs.h)
@@ -73,6 +85,7 @@ static char     FileLine[MAXLINE+1];   // line from climate data file
 //  climate_readEvapParams             // called by input_parseLine
 //  climate_validate                   // called by project_validate
 //  climate_openFile                   // called by runoff_open
+//  climate_closeFile                  // called by runoff_close
 //  climate_initState                  // called by project_init
 //  climate_setState                   // called by runoff_execute
 //  climate_getNextEvap                // called by runoff_getTimeStep
@@ -86,7 +99,11 @@ static void readUserFileLine(int *year, int *month);
 static void readTD3200FileLine(int *year, int *month);
 static void readDLY0204FileLine(int *year, int *month);
 static void readFileValues(void);
-static void setFileValues(int param);
+static void readDailyData(int nDays);
+static void setFileValues(int day);
+static int  getCacheKey(TClimateCacheKey* key, char* cacheName);
+static int  readCacheFile(TClimateCacheKey* key, char* cacheName, int nDays);
+static void saveCacheFile(TClimateCacheKey* key, char* cacheName);
 static void setEvap(DateTime theDate);
 static void setTemp(DateTime theDate);
 static void setWind(DateTime theDate);
@@ -359,17 +376,24 @@ void climate_openFile()
 //
 //  Input:   none
 //  Output:  none
-//  Purpose: opens a climate file and reads in first set of values.
+//  Purpose: opens a climate file and reads in the daily values needed for
+//           the entire simulation period.
+//
+//  Note: the daily values, starting from the first day of the file's
+//        starting month, are cached in a binary file placed next to the
+//        climate file, named <climate file>.<hash>.cfc where <hash> is an
+//        8-digit hex (djb2) hash of the starting month and unit system
+//        used. The cache is re-used, instead of parsing the climate file
+//        again, for as long as the climate file's size and time of last
+//        modification stay the same, a checksum of its contents matches
+//        and it holds enough days for the simulation period.
 //
 {
-    int i, m, y;
-
-    // --- open the file
-    if ( (Fclimate.file = fopen(Fclimate.name, "rt")) == NULL )
-    {
-        report_writeErrorMsg(ERR_CLIMATE_FILE_OPEN, Fclimate.name);
-        return;
-    }
+    int  m, y;
+    int  hasCache;                     // true if a cache file can be used
+    int  nDays;                        // number of days of data needed
+    char cacheName[MAXFNAME+1];        // name of cache file
+    TClimateCacheKey key;              // identifies data in cache file
 
     // --- initialize values of file's climate variables
     //     (Temp.ta was previously initialized in project.c)
@@ -377,47 +401,81 @@ void climate_openFile()
     FileValue[TMAX] = Temp.ta;
     FileValue[EVAP] = 0.0;
     FileValue[WIND] = 0.0;
+    FileDailyData = NULL;
+    FileDayCount = 0;
 
-    // --- find climate file's format
-    FileFormat = getFileFormat();
-    if ( FileFormat == UNKNOWN_FORMAT )
-    {
-        report_writeErrorMsg(ERR_CLIMATE_FILE_READ, Fclimate.name);
-        return;
-    }
-
-    // --- position file to begin reading climate file at either user-specified
-    //     month/year or at start of simulation period.
-    rewind(Fclimate.file);
-    strcpy(FileLine, "");
+    // --- find month/year where reading of climate file begins, either
+    //     user-specified or at start of simulation period
     if ( Temp.fileStartDate == NO_DATE )
         datetime_decodeDate(StartDate, &FileYear, &FileMonth, &FileDay); 
     else
         datetime_decodeDate(Temp.fileStartDate, &FileYear, &FileMonth, &FileDay);
-    while ( !feof(Fclimate.file) )
+
+    // --- find number of days of data needed from start of that month
+    FileStartIndex = FileDay - 1;
+    nDays = FileStartIndex + 1 +
+            (int)(floor(EndDateTime) - floor(StartDateTime));
+
+    // --- use the cache file if it holds enough of the file's current data
+    hasCache = getCacheKey(&key, cacheName);
+    if ( !hasCache || !readCacheFile(&key, cacheName, nDays) )
     {
+        // --- open the file
+        if ( (Fclimate.file = fopen(Fclimate.name, "rt")) == NULL )
+        {
+            report_writeErrorMsg(ERR_CLIMATE_FILE_OPEN, Fclimate.name);
+            return;
+        }
+
+        // --- find climate file's format
+        FileFormat = getFileFormat();
+        if ( FileFormat == UNKNOWN_FORMAT )
+        {
+            report_writeErrorMsg(ERR_CLIMATE_FILE_READ, Fclimate.name);
+            return;
+        }
+
+        // --- position file to begin reading climate file at starting month
+        rewind(Fclimate.file);
         strcpy(FileLine, "");
-        readFileLine(&y, &m);
-        if ( y == FileYear && m == FileMonth ) break;
-    }
-    if ( feof(Fclimate.file) )
-    {
-        report_writeErrorMsg(ERR_CLIMATE_END_OF_FILE, Fclimate.name);
-        return;
-    }
-    
-    // --- initialize file dates and current climate variable values 
-    if ( !ErrorCode )
-    {
-        FileElapsedDays = 0;
-        FileLastDay = datetime_daysPerMonth(FileYear, FileMonth);
-        readFileValues();
-        for (i=TMIN; i<=WIND; i++)
+        while ( !feof(Fclimate.file) )
         {
-            if ( FileData[i][FileDay] == MISSING ) continue;
-            FileValue[i] = FileData[i][FileDay];
+            strcpy(FileLine, "");
+            readFileLine(&y, &m);
+            if ( y == FileYear && m == FileMonth ) break;
         }
+        if ( feof(Fclimate.file) )
+        {
+            report_writeErrorMsg(ERR_CLIMATE_END_OF_FILE, Fclimate.name);
+            return;
+        }
+
+        // --- read the daily values & save them to the cache file
+        readDailyData(nDays);
+        fclose(Fclimate.file);
+        Fclimate.file = NULL;
+        if ( ErrorCode ) return;
+        if ( hasCache ) saveCacheFile(&key, cacheName);
     }
+
+    // --- initialize current climate variable values
+    FileElapsedDays = 0;
+    setFileValues(FileStartIndex);
+}
+
+//=============================================================================
+
+void climate_closeFile()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: closes the climate file and frees its daily values.
+//
+{
+    if ( Fclimate.file ) fclose(Fclimate.file);
+    Fclimate.file = NULL;
+    FREE(FileDailyData);
+    FileDayCount = 0;
 }
 
 //=============================================================================
@@ -455,6 +513,7 @@ void climate_setState(DateTime theDate)
     if ( Temp.dataSource != NO_TEMP ) setTemp(theDate);
     setEvap(theDate);
     setWind(theDate);
+    if ( Nobjects[SNOWMELT] > 0 ) snow_setClimateCoeffs();
 }
 
 //=============================================================================
@@ -519,45 +578,44 @@ void updateFileValues(DateTime theDate)
 //
 //  Input:   theDate = current simulation date
 //  Output:  none
-//  Purpose: updates daily climate variables for new day or reads in
-//           another month worth of values if a new month begins.
+//  Purpose: updates daily climate variables for a new day.
 //
-//  NOTE:    counters FileElapsedDays, FileDay, FileMonth, FileYear and
-//           FileLastDay were initialized in climate_openFile().
+//  NOTE:    FileElapsedDays and FileStartIndex were initialized in
+//           climate_openFile().
 //
 {
-    int i;
     int deltaDays;
 
     // --- see if a new day has begun
     deltaDays = (int)(floor(theDate) - floor(StartDateTime));
     if ( deltaDays > FileElapsedDays )
     {
-        // --- advance day counters
-        FileElapsedDays++;
-        FileDay++;
+        // --- set climate variables for new day, indexing the daily data
+        //     directly by day (a time step may span more than one day)
+        FileElapsedDays = MIN(deltaDays, FileDayCount - 1 - FileStartIndex);
+        setFileValues(FileStartIndex + FileElapsedDays);
+    }
+}
 
-        // --- see if new month of data needs to be read from file
-        if ( FileDay > FileLastDay )
-        {
-            FileMonth++;
-            if ( FileMonth > 12 )
-            {
-                FileMonth = 1;
-                FileYear++;
-            }
-            readFileValues();
-            FileDay = 1;
-            FileLastDay = datetime_daysPerMonth(FileYear, FileMonth);
-        }
+//=============================================================================
 
-        // --- set climate variables for new day
-        for (i=TMIN; i<=WIND; i++)
-        {
-            // --- no change in current value if its missing
-            if ( FileData[i][FileDay] == MISSING ) continue;
-            FileValue[i] = FileData[i][FileDay];
-        }
+void setFileValues(int day)
+//
+//  Input:   day = index of day in the daily climate data
+//  Output:  none
+//  Purpose: sets current values of climate variables to those of a given day.
+//
+{
+    int i;
+    double* values;
+
+    if ( FileDailyData == NULL || day < 0 || day >= FileDayCount ) return;
+    values = FileDailyData + day * MAXCLIMATEVARS;
+    for (i=TMIN; i<=WIND; i++)
+    {
+        // --- no change in current value if its missing
+        if ( values[i] == MISSING ) continue;
+        FileValue[i] = values[i];
     }
 }
 
@@ -936,6 +994,183 @@ void readDLY0204FileLine(int* y, int* m)
 
 //=============================================================================
 
+void readDailyData(int nDays)
+//
+//  Input:   nDays = number of days of data to read
+//  Output:  none
+//  Purpose: reads daily values of climate variables from the climate file,
+//           a month at a time, starting at the file's starting month.
+//
+{
+    int i, day, lastDay;
+    int count = 0;
+
+    FileDailyData = (double *) calloc(nDays * MAXCLIMATEVARS, sizeof(double));
+    if ( FileDailyData == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+    while ( count < nDays && !ErrorCode )
+    {
+        // --- read the current month's data
+        readFileValues();
+        lastDay = datetime_daysPerMonth(FileYear, FileMonth);
+        for (day = 1; day <= lastDay && count < nDays; day++)
+        {
+            for (i = 0; i < MAXCLIMATEVARS; i++)
+                FileDailyData[count*MAXCLIMATEVARS + i] = FileData[i][day];
+            count++;
+        }
+
+        // --- move on to the next month
+        FileMonth++;
+        if ( FileMonth > 12 )
+        {
+            FileMonth = 1;
+            FileYear++;
+        }
+    }
+    FileDayCount = count;
+}
+
+//=============================================================================
+
+int getCacheKey(TClimateCacheKey* key, char* cacheName)
+//
+//  Input:   none
+//  Output:  key = identifies the data read from the climate file
+//           cacheName = name of the climate file's cache file
+//                       (MAXFNAME+1 chars);
+//           returns 1 if a cache file can be used, 0 if not
+//  Purpose: identifies the cache file that holds the daily climate data.
+//
+{
+    struct stat fileStats;
+    unsigned int hash = 5381;
+    size_t k;
+    unsigned char* bytes;
+
+    // --- the climate file's size & modification time must be known
+    if ( stat(Fclimate.name, &fileStats) != 0 ) return 0;
+
+    // --- the key also includes everything else that affects the data read
+    memset(key, 0, sizeof(TClimateCacheKey));
+    key->startYear  = FileYear;
+    key->startMonth = FileMonth;
+    key->unitSystem = UnitSystem;
+
+    // --- name the cache file after the climate file and a hash of the key
+    bytes = (unsigned char *)key;
+    for (k = 0; k < sizeof(TClimateCacheKey); k++) hash = hash * 33 + bytes[k];
+    if ( snprintf(cacheName, MAXFNAME+1, "%s.%08x.cfc", Fclimate.name,
+                  hash) > MAXFNAME ) return 0;
+    key->fileSize = (FilePos)fileStats.st_size;
+    key->fileTime = (FilePos)fileStats.st_mtime;
+    return 1;
+}
+
+//=============================================================================
+
+int readCacheFile(TClimateCacheKey* key, char* cacheName, int nDays)
+//
+//  Input:   key = identifies the data to be read
+//           cacheName = name of cache file
+//           nDays = number of days of data needed
+//  Output:  returns 1 if data were read from the cache file, 0 if not
+//  Purpose: reads daily climate data from the climate file's cache file.
+//
+{
+    FILE*  f;
+    char   fileStamp[] = "SWMM5-CLIMCACHE";
+    char   fStamp[] = "SWMM5-CLIMCACHE";
+    int    count = 0;
+    size_t size;
+    unsigned long long checksum = 0;
+    TClimateCacheKey fileKey;
+
+    // --- check that cache file holds enough data with the same key
+    if ( (f = fopen(cacheName, "rb")) == NULL ) return 0;
+    memset(&fileKey, 0, sizeof(TClimateCacheKey));
+    fread(fStamp, sizeof(char), strlen(fileStamp), f);
+    fread(&fileKey, sizeof(TClimateCacheKey), 1, f);
+    fread(&count, sizeof(int), 1, f);
+    if ( strcmp(fStamp, fileStamp) != 0 ||
+         memcmp(&fileKey, key, sizeof(TClimateCacheKey)) != 0 ||
+         count < nDays )
+    {
+        fclose(f);
+        return 0;
+    }
+
+    // --- read all days of data & check that they match the checksum
+    //     saved after them
+    size = (size_t)count * MAXCLIMATEVARS;
+    FileDailyData = (double *) malloc(size * sizeof(double));
+    if ( FileDailyData == NULL ||
+         fread(FileDailyData, sizeof(double), size, f) < size ||
+         fread(&checksum, sizeof(checksum), 1, f) < 1 ||
+         checksum != hashBytes(FileDailyData, size * sizeof(double),
+                               hashBytes(&count, sizeof(int), 0)) )
+    {
+        FREE(FileDailyData);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+    FileDayCount = count;
+    return 1;
+}
+
+//=============================================================================
+
+void saveCacheFile(TClimateCacheKey* key, char* cacheName)
+//
+//  Input:   key = identifies the data read
+//           cacheName = name of cache file
+//  Output:  none
+//  Purpose: saves daily climate data to the climate file's cache file.
+//
+//  Note: failure to save a cache file is not an error; the climate
+//        file will simply be read again next time. The file is written
+//        under a unique temporary name and then renamed, so that a partly
+//        written cache file is never read and concurrent runs saving the
+//        same cache do not write into each other's file.
+//
+{
+    FILE*  f;
+    char   fileStamp[] = "SWMM5-CLIMCACHE";
+    char   tmpName[MAXFNAME+1];
+    size_t size = (size_t)FileDayCount * MAXCLIMATEVARS;
+    unsigned long long checksum;
+    int    ok;
+
+    checksum = hashBytes(FileDailyData, size * sizeof(double),
+                         hashBytes(&FileDayCount, sizeof(int), 0));
+    if ( (f = openTmpFile(cacheName, tmpName)) == NULL ) return;
+    fwrite(fileStamp, sizeof(char), strlen(fileStamp), f);
+    fwrite(key, sizeof(TClimateCacheKey), 1, f);
+    fwrite(&FileDayCount, sizeof(int), 1, f);
+    ok = ( fwrite(FileDailyData, sizeof(double), size, f) == size );
+    if ( fwrite(&checksum, sizeof(checksum), 1, f) < 1 ) ok = FALSE;
+    if ( fclose(f) != 0 ) ok = FALSE;
+    if ( !ok )
+    {
+        remove(tmpName);
+        return;
+    }
+
+    // --- replace any existing cache file (rename() fails on Windows
+    //     if the new name already exists)
+    if ( rename(tmpName, cacheName) != 0 )
+    {
+        remove(cacheName);
+        if ( rename(tmpName, cacheName) != 0 ) remove(tmpName);
+    }
+}
+
+//=============================================================================
+
 void readFileValues()
 //
 //  Input:   none
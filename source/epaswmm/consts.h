@@ -18,6 +18,7 @@
 
 #define   VERSION            50021                                             //(5.0.021 - LR)
 #define   MAGICNUMBER        516114522
+#define   MAGICNUMBER64      516114523      // closes output with 64-bit offsets
 #define   EOFMARK            0x1A           // Use 0x04 for UNIX systems
 #define   MAXTITLE           3              // Max. # title lines
 #define   MAXMSG             1024           // Max. # characters in message text
@@ -35,7 +36,8 @@
 #define   PI                 3.141592654    // Value of pi
 #define   GRAVITY            32.2           // accel. of gravity in US units
 #define   SI_GRAVITY         9.81           // accel of gravity in SI units
-#define   MAXFILESIZE        2147483647L    // largest file size in bytes
+#define   MAXFILESIZE        2147483647L    // largest file size for 32-bit offsets
+#define   MAXSTEPCLASSES     6              // Max. # dyn. wave time step classes
 
 //-----------------------------
 // Units factor in Manning Eqn.
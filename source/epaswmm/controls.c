@@ -29,6 +29,9 @@ enum RuleAttrib  {r_DEPTH, r_HEAD, r_INFLOW, r_FLOW, r_STATUS, r_SETTING,
 enum RuleOperand {EQ, NE, LT, LE, GT, GE};
 enum RuleSetting {r_CURVE, r_TIMESERIES, r_PID, r_NUMERIC};                    //(5.0.012 - LR)
 
+static const double TIME_TOL = 1.0e-6;  // tolerance on time premise events (days)
+static const double NO_TIME_EVENT = -1.0; // premise doesn't involve time
+
 static char* ObjectWords[] =
     {"NODE", "LINK", "PUMP", "ORIFICE", "WEIR", "OUTLET", "SIMULATION", NULL};
 static char* AttribWords[] =
@@ -49,10 +52,20 @@ struct  TPremise
    int      link;
    int      attribute;
    int      operand;
+   int      variable;                  // index of monitored variable
    double   value;
    struct   TPremise *next;
 };
 
+// Node or Link Variable Monitored by Rule Premises
+struct  TRuleVariable
+{
+   int      node;
+   int      link;
+   int      attribute;
+   double   value;                     // value at latest rule evaluation
+};
+
 // Rule Action Clause
 struct  TAction              
 {
@@ -83,6 +96,16 @@ struct  TRule
    struct   TPremise* lastPremise;     // Pointer to last premise of rule
    struct   TAction*  thenActions;     // Linked list of actions if true
    struct   TAction*  elseActions;     // Linked list of actions if false
+   int      premiseStart;              // Position of first compiled premise
+   int      premiseCount;              // Number of compiled premises
+   int      changed;                   // TRUE if premises need re-evaluation
+   int      everyStep;                 // TRUE if rule is evaluated every step
+   int      result;                    // Result of latest premise evaluation
+   double   nextTime;                  // Elapsed days when a time premise
+                                       //   can next change its value (BIG
+                                       //   if it must be checked every step)
+   double   controlValue;              // Controller variable after evaluation
+   double   setPoint;                  // Controller setpoint after evaluation
 };
 
 //-----------------------------------------------------------------------------
@@ -95,12 +118,19 @@ int    RuleCount;                      // Total number of rules
 double ControlValue;                   // Value of controller variable
 double SetPoint;                       // Value of controller setpoint         //(5.0.012 - LR)
 
+struct TPremise*      PremiseList;     // Compiled array of all rule premises
+struct TRuleVariable* RuleVars;        // Array of monitored variables
+int    RuleVarCount;                   // Number of monitored variables
+int*   VarRuleStart;                   // Start of each variable's rules
+int*   VarRules;                       // Rules that depend on each variable
+
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
 //     controls_create
 //     controls_delete
 //     controls_addRuleClause
+//     controls_init
 //     controls_evaluate
 
 //-----------------------------------------------------------------------------
@@ -110,6 +140,15 @@ int    addPremise(int r, int type, char* Tok[], int nToks);
 int    addAction(int r, char* Tok[], int nToks);
 int    evaluatePremise(struct TPremise* p, DateTime theDate, DateTime theTime,
                        DateTime elapsedTime, double tStep);
+int    evaluatePremises(int r, DateTime theDate, DateTime theTime,
+                        DateTime elapsedTime, double tStep);
+int    findRuleVariable(struct TPremise* p);
+double getRuleVariableValue(struct TRuleVariable* v);
+void   updateRuleVariables(void);
+double getNextTimeEvent(struct TPremise* p, DateTime theTime,
+                        DateTime elapsedTime);
+int    hasVaryingAction(struct TAction* a);
+void   deleteCompiledRules(void);
 int    checkTimeValue(struct TPremise* p, double time1, double time2);
 int    checkValue(struct TPremise* p, double x);
 void   updateActionList(struct TAction* a);
@@ -135,6 +174,11 @@ int  controls_create(int n)
 {
    int r;
    ActionList = NULL;
+   PremiseList = NULL;
+   RuleVars = NULL;
+   RuleVarCount = 0;
+   VarRuleStart = NULL;
+   VarRules = NULL;
    InputState = r_PRIORITY;
    RuleCount = n;
    if ( n == 0 ) return 0;
@@ -163,6 +207,7 @@ void controls_delete(void)
 {
    if ( RuleCount == 0 ) return;
    deleteActionList();
+   deleteCompiledRules();
    deleteRules();
 }
 
@@ -224,6 +269,102 @@ int  controls_addRuleClause(int r, int keyword, char* tok[], int nToks)
 
 //=============================================================================
 
+int controls_init(void)
+//
+//  Input:   none
+//  Output:  returns error code
+//  Purpose: compiles the premises of all control rules into a contiguous
+//           array and indexes the node & link variables they monitor.
+//
+{
+    int    r, k, n, v;
+    int*   lastRule;
+    struct TPremise* p;
+
+    // --- count total number of premises
+    deleteCompiledRules();
+    if ( RuleCount == 0 ) return 0;
+    n = 0;
+    for (r=0; r<RuleCount; r++)
+    {
+        for (p = Rules[r].firstPremise; p; p = p->next) n++;
+    }
+    if ( n == 0 ) n = 1;
+
+    // --- allocate compiled premise & variable arrays
+    PremiseList = (struct TPremise *) calloc(n, sizeof(struct TPremise));
+    RuleVars = (struct TRuleVariable *) calloc(n, sizeof(struct TRuleVariable));
+    VarRuleStart = (int *) calloc(n+1, sizeof(int));
+    VarRules = (int *) calloc(n, sizeof(int));
+    lastRule = (int *) calloc(n, sizeof(int));
+    if ( !PremiseList || !RuleVars || !VarRuleStart || !VarRules || !lastRule )
+    {
+        FREE(lastRule);
+        return ERR_MEMORY;
+    }
+
+    // --- copy each rule's premises into the compiled array
+    k = 0;
+    for (r=0; r<RuleCount; r++)
+    {
+        Rules[r].premiseStart = k;
+        Rules[r].everyStep = hasVaryingAction(Rules[r].thenActions) ||
+                             hasVaryingAction(Rules[r].elseActions);
+        for (p = Rules[r].firstPremise; p; p = p->next)
+        {
+            PremiseList[k] = *p;
+            PremiseList[k].next = NULL;
+            PremiseList[k].variable = findRuleVariable(&PremiseList[k]);
+            if ( (p->attribute == r_TIME || p->attribute == r_CLOCKTIME)
+            &&   (p->operand == EQ || p->operand == NE) )
+                Rules[r].everyStep = TRUE;
+            k++;
+        }
+        Rules[r].premiseCount = k - Rules[r].premiseStart;
+        Rules[r].changed = TRUE;
+        Rules[r].result = FALSE;
+        Rules[r].nextTime = NO_TIME_EVENT;
+    }
+
+    // --- count the rules that depend on each variable
+    for (v=0; v<RuleVarCount; v++) lastRule[v] = -1;
+    for (r=0; r<RuleCount; r++)
+    {
+        for (k = Rules[r].premiseStart;
+             k < Rules[r].premiseStart + Rules[r].premiseCount; k++)
+        {
+            v = PremiseList[k].variable;
+            if ( v < 0 || lastRule[v] == r ) continue;
+            lastRule[v] = r;
+            VarRuleStart[v+1]++;
+        }
+    }
+    for (v=0; v<RuleVarCount; v++) VarRuleStart[v+1] += VarRuleStart[v];
+
+    // --- list the rules that depend on each variable
+    //     (lastRule[] now holds the next free position in VarRules[])
+    for (v=0; v<RuleVarCount; v++) lastRule[v] = VarRuleStart[v];
+    for (r=0; r<RuleCount; r++)
+    {
+        for (k = Rules[r].premiseStart;
+             k < Rules[r].premiseStart + Rules[r].premiseCount; k++)
+        {
+            v = PremiseList[k].variable;
+            if ( v < 0 ) continue;
+            n = lastRule[v];
+            if ( n > VarRuleStart[v] && VarRules[n-1] == r ) continue;
+            VarRules[n] = r;
+            lastRule[v]++;
+        }
+    }
+    for (v=0; v<RuleVarCount; v++)
+        RuleVars[v].value = getRuleVariableValue(&RuleVars[v]);
+    FREE(lastRule);
+    return 0;
+}
+
+//=============================================================================
+
 int controls_evaluate(DateTime currentTime, DateTime elapsedTime, double tStep)
 //
 //  Input:   currentTime = current simulation date/time
@@ -234,41 +375,43 @@ int controls_evaluate(DateTime currentTime, DateTime elapsedTime, double tStep)
 //
 {
     int    r;                          // control rule index
-    int    result;                     // TRUE if rule premises satisfied
-    struct TPremise* p;                // pointer to rule premise clause
     struct TAction*  a;                // pointer to rule action clause
     DateTime theDate = floor(currentTime);
     DateTime theTime = currentTime - floor(currentTime);
 
-    // --- evaluate each rule
+    // --- flag rules whose monitored node & link variables have changed
     if ( RuleCount == 0 ) return 0;
     clearActionList();
+    updateRuleVariables();
+
+    // --- evaluate each rule
     for (r=0; r<RuleCount; r++)
     {
-        // --- evaluate rule's premises
-        result = TRUE;
-        p = Rules[r].firstPremise;
-        while (p)
+        // --- re-evaluate rule's premises only if one of them can have
+        //     changed its value since the last evaluation
+        if ( Rules[r].changed || Rules[r].everyStep
+        ||   Rules[r].nextTime >= BIG
+        ||   (Rules[r].nextTime != NO_TIME_EVENT
+              && elapsedTime >= Rules[r].nextTime - TIME_TOL) )
         {
-            if ( p->type == r_OR )
-            {
-                if ( result == FALSE )
-                    result = evaluatePremise(p, theDate, theTime,
-                                 elapsedTime, tStep);
-            }
-            else
-            {
-                if ( result == FALSE ) break;
-                result = evaluatePremise(p, theDate, theTime, 
-                             elapsedTime, tStep);
-            }
-            p = p->next;
-        }    
+            Rules[r].result = evaluatePremises(r, theDate, theTime,
+                                               elapsedTime, tStep);
+            Rules[r].controlValue = ControlValue;
+            Rules[r].setPoint = SetPoint;
+            Rules[r].changed = FALSE;
+        }
+
+        // --- otherwise restore the controller values it produced
+        else
+        {
+            ControlValue = Rules[r].controlValue;
+            SetPoint = Rules[r].setPoint;
+        }
 
         // --- if premises true, add THEN clauses to action list
         //     else add ELSE clauses to action list
-        if ( result == TRUE ) a = Rules[r].thenActions;
-        else                  a = Rules[r].elseActions;
+        if ( Rules[r].result == TRUE ) a = Rules[r].thenActions;
+        else                           a = Rules[r].elseActions;
         while (a)
         {
             updateActionValue(a, currentTime, tStep);                          //(5.0.012 - LR)
@@ -284,6 +427,233 @@ int controls_evaluate(DateTime currentTime, DateTime elapsedTime, double tStep)
 
 //=============================================================================
 
+int evaluatePremises(int r, DateTime theDate, DateTime theTime,
+                     DateTime elapsedTime, double tStep)
+//
+//  Input:   r = control rule index
+//           theDate = the current simulation date
+//           theTime = the current simulation time of day
+//           elpasedTime = decimal days since the start of the simulation
+//           tStep = current time step (days)
+//  Output:  returns TRUE if the rule's premises are satisfied
+//  Purpose: evaluates a rule's compiled premises and finds the next time
+//           at which any of its time premises can change its value.
+//
+{
+    int    k;
+    int    k2 = Rules[r].premiseStart + Rules[r].premiseCount;
+    int    result = TRUE;
+    double t, tNext = NO_TIME_EVENT;
+    struct TPremise* p;
+
+    for (k = Rules[r].premiseStart; k < k2; k++)
+    {
+        p = &PremiseList[k];
+        if ( p->type == r_OR )
+        {
+            if ( result == FALSE )
+                result = evaluatePremise(p, theDate, theTime,
+                             elapsedTime, tStep);
+        }
+        else
+        {
+            if ( result == FALSE ) break;
+            result = evaluatePremise(p, theDate, theTime,
+                         elapsedTime, tStep);
+        }
+    }
+
+    // --- time premises can change independently of the monitored
+    //     variables (those skipped above must be included too)
+    for (k = Rules[r].premiseStart; k < k2; k++)
+    {
+        t = getNextTimeEvent(&PremiseList[k], theTime, elapsedTime);
+        if ( t == NO_TIME_EVENT ) continue;
+        if ( tNext == NO_TIME_EVENT || t < tNext ) tNext = t;
+    }
+    Rules[r].nextTime = tNext;
+    return result;
+}
+
+//=============================================================================
+
+double getNextTimeEvent(struct TPremise* p, DateTime theTime,
+                        DateTime elapsedTime)
+//
+//  Input:   p = a control rule premise condition
+//           theTime = the current simulation time of day
+//           elpasedTime = decimal days since the start of the simulation
+//  Output:  returns elapsed time (days) at which the premise can next change
+//           value, BIG if it must be checked at every step or NO_TIME_EVENT
+//           if it doesn't involve the simulation time
+//  Purpose: finds when a premise involving the simulation time can change.
+//
+{
+    switch ( p->attribute )
+    {
+      case r_TIME:
+        if ( elapsedTime <= p->value ) return p->value;
+        return BIG;
+
+      case r_CLOCKTIME:
+        if ( theTime <= p->value ) return elapsedTime + p->value - theTime;
+        return elapsedTime + 1.0 - theTime;
+
+      case r_DATE:
+      case r_DAY:
+      case r_MONTH:
+        return elapsedTime + 1.0 - theTime;
+
+      default: return NO_TIME_EVENT;
+    }
+}
+
+//=============================================================================
+
+int hasVaryingAction(struct TAction* a)
+//
+//  Input:   a = first of a list of rule actions
+//  Output:  returns TRUE if any action's value can change from step to step
+//  Purpose: checks if a list of actions contains a Curve, Time Series or
+//           PID setting (whose values depend on the controller variable,
+//           the simulation time or the controller's history).
+//
+{
+    for ( ; a; a = a->next )
+    {
+        if ( a->curve >= 0 || a->tseries >= 0 || a->attribute == r_PID )
+            return TRUE;
+    }
+    return FALSE;
+}
+
+//=============================================================================
+
+int findRuleVariable(struct TPremise* p)
+//
+//  Input:   p = a control rule premise condition
+//  Output:  returns index of the node or link variable the premise monitors
+//           or -1 if it monitors none
+//  Purpose: adds the variable a premise monitors to the list of variables
+//           monitored by all control rules.
+//
+{
+    int i = p->node;
+    int j = p->link;
+    int v;
+
+    // --- identify the object whose value the premise tests
+    switch ( p->attribute )
+    {
+      case r_STATUS:
+        if ( j < 0 || Link[j].type != PUMP ) return -1;
+        i = -1;
+        break;
+
+      case r_SETTING:
+        if ( j < 0 || (Link[j].type != ORIFICE && Link[j].type != WEIR) )
+            return -1;
+        i = -1;
+        break;
+
+      case r_FLOW:
+        if ( j < 0 ) return -1;
+        i = -1;
+        break;
+
+      case r_DEPTH:
+        if ( j >= 0 ) i = -1;
+        else if ( i < 0 ) return -1;
+        break;
+
+      case r_HEAD:
+      case r_INFLOW:
+        if ( i < 0 ) return -1;
+        j = -1;
+        break;
+
+      default: return -1;
+    }
+
+    // --- check if variable is already being monitored
+    for (v=0; v<RuleVarCount; v++)
+    {
+        if ( RuleVars[v].node == i && RuleVars[v].link == j
+        &&   RuleVars[v].attribute == p->attribute ) return v;
+    }
+
+    // --- add a new variable to the list
+    v = RuleVarCount;
+    RuleVars[v].node = i;
+    RuleVars[v].link = j;
+    RuleVars[v].attribute = p->attribute;
+    RuleVars[v].value = 0.0;
+    RuleVarCount++;
+    return v;
+}
+
+//=============================================================================
+
+double getRuleVariableValue(struct TRuleVariable* v)
+//
+//  Input:   v = a node or link variable monitored by control rules
+//  Output:  returns the variable's current value in user's units
+//  Purpose: finds the current value of a monitored variable.
+//
+{
+    int i = v->node;
+    int j = v->link;
+
+    switch ( v->attribute )
+    {
+      case r_STATUS:
+      case r_SETTING:
+        return Link[j].setting;
+
+      case r_FLOW:
+        return Link[j].direction*Link[j].newFlow*UCF(FLOW);
+
+      case r_DEPTH:
+        if ( j >= 0 ) return Link[j].newDepth*UCF(LENGTH);
+        return Node[i].newDepth*UCF(LENGTH);
+
+      case r_HEAD:
+        return (Node[i].newDepth + Node[i].invertElev) * UCF(LENGTH);
+
+      case r_INFLOW:
+        return Node[i].newLatFlow*UCF(FLOW);
+
+      default: return 0.0;
+    }
+}
+
+//=============================================================================
+
+void updateRuleVariables(void)
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: updates the values of all monitored variables and flags the
+//           rules that depend on those whose values have changed.
+//
+{
+    int    v, k;
+    double x;
+
+    for (v=0; v<RuleVarCount; v++)
+    {
+        x = getRuleVariableValue(&RuleVars[v]);
+        if ( x == RuleVars[v].value ) continue;
+        RuleVars[v].value = x;
+        for (k = VarRuleStart[v]; k < VarRuleStart[v+1]; k++)
+        {
+            Rules[VarRules[k]].changed = TRUE;
+        }
+    }
+}
+
+//=============================================================================
+
 int  addPremise(int r, int type, char* tok[], int nToks)
 //
 //  Input:   r = control rule index
@@ -793,10 +1163,6 @@ int evaluatePremise(struct TPremise* p, DateTime theDate, DateTime theTime,
 //  Purpose: evaluates the truth of a control rule premise condition.
 //
 {
-    int i = p->node;
-    int j = p->link;
-    double head;
-
     switch ( p->attribute )
     {
       case r_TIME:
@@ -814,33 +1180,15 @@ int evaluatePremise(struct TPremise* p, DateTime theDate, DateTime theTime,
       case r_MONTH:                                                            //(5.0.014 - LR)
         return checkValue(p, datetime_monthOfYear(theDate));                   //(5.0.014 - LR)
 
+      // --- node & link values were found by updateRuleVariables()
       case r_STATUS:
-        if ( j < 0 || Link[j].type != PUMP ) return FALSE;
-        else return checkValue(p, Link[j].setting);
-        
       case r_SETTING:
-        if ( j < 0 || (Link[j].type != ORIFICE && Link[j].type != WEIR) )
-            return FALSE;
-        else return checkValue(p, Link[j].setting);
-
       case r_FLOW:
-        if ( j < 0 ) return FALSE;
-        else return checkValue(p, Link[j].direction*Link[j].newFlow*UCF(FLOW));//(5.0.019 - LR)
-
       case r_DEPTH:
-        if ( j >= 0 ) return checkValue(p, Link[j].newDepth*UCF(LENGTH));
-        else if ( i >= 0 )
-            return checkValue(p, Node[i].newDepth*UCF(LENGTH));
-        else return FALSE;
-
       case r_HEAD:
-        if ( i < 0 ) return FALSE;
-        head = (Node[i].newDepth + Node[i].invertElev) * UCF(LENGTH);
-        return checkValue(p, head);
-
       case r_INFLOW:
-        if ( i < 0 ) return FALSE;
-        else return checkValue(p, Node[i].newLatFlow*UCF(FLOW));
+        if ( p->variable < 0 ) return FALSE;
+        else return checkValue(p, RuleVars[p->variable].value);
 
       default: return FALSE;
     }
@@ -935,6 +1283,22 @@ void  deleteActionList(void)
 
 //=============================================================================
 
+void  deleteCompiledRules(void)
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the memory used for the compiled form of the control rules.
+//
+{
+    FREE(PremiseList);
+    FREE(RuleVars);
+    FREE(VarRuleStart);
+    FREE(VarRules);
+    RuleVarCount = 0;
+}
+
+//=============================================================================
+
 void  deleteRules(void)
 //
 //  Input:   none
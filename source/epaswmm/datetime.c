@@ -38,6 +38,21 @@ static const double SecsPerDay = 86400.;    // seconds per day
 //-----------------------------------------------------------------------------
 static int DateFormat;
 
+// Calendar fields of the most recently decoded day. Simulation dates
+// advance slowly, so most decodings can be answered from these fields
+// (or by stepping them ahead one day) rather than from scratch.
+static int CalDate;                         // day number (0 if unset)
+static int CalYear;                         // year of day
+static int CalMonth;                        // month of year (1-12)
+static int CalDay;                          // day of month (1-31)
+static int CalDayOfYear;                    // day of year (1-366)
+#pragma omp threadprivate(CalDate, CalYear, CalMonth, CalDay, CalDayOfYear)
+
+//-----------------------------------------------------------------------------
+//  Local functions
+//-----------------------------------------------------------------------------
+static void setCalendar(int t);
+
 
 //=============================================================================
 
@@ -156,15 +171,7 @@ void datetime_decodeDate(DateTime date, int* year, int* month, int* day)
 //  Purpose: decodes DateTime value to year-month-day.
 
 {
-    int  D1, D4, D100, D400;
-    int  y, m, d, i, k, t;
-
-    D1 = 365;              //365
-    D4 = D1 * 4 + 1;       //1461
-    D100 = D4 * 25 - 1;    //36524
-    D400 = D100 * 4 + 1;   //146097
-
-    t = (int)(floor (date)) + DateDelta;
+    int t = (int)(floor (date)) + DateDelta;
     if (t <= 0)
     {
         *year = 0;
@@ -173,42 +180,89 @@ void datetime_decodeDate(DateTime date, int* year, int* month, int* day)
     }
     else
     {
-        t--;
-        y = 1;
-        while (t >= D400)
-        {
-            t -= D400;
-            y += 400;
-        }
-        divMod(t, D100, &i, &d);
-        if (i == 4)
-        {
-            i--;
-            d += D100;
-        }
-        y += i*100;
-        divMod(d, D4, &i, &d);
-        y += i*4;
-        divMod(d, D1, &i, &d);
-        if (i == 4)
-        {
-            i--;
-            d += D1;
-        }
-        y += i;
-        k = isLeapYear(y);
-        m = 1;
-        for (;;)
+        if (t != CalDate) setCalendar(t);
+        *year = CalYear;
+        *month = CalMonth;
+        *day = CalDay;
+    }
+}
+
+//=============================================================================
+
+void setCalendar(int t)
+
+//  Input:   t = days since 12/31/0000
+//  Output:  none
+//  Purpose: updates the cached calendar fields to a new day.
+
+{
+    int  D1, D4, D100, D400;
+    int  y, m, d, i, k;
+
+    // --- the next day is found by stepping the current one ahead
+    if (CalDate > 0 && t == CalDate + 1)
+    {
+        k = isLeapYear(CalYear);
+        CalDate = t;
+        CalDayOfYear++;
+        CalDay++;
+        if (CalDay > DaysPerMonth[k][CalMonth-1])
         {
-            i = DaysPerMonth[k][m-1];
-            if (d < i) break;
-            d -= i;
-            m++;
+            CalDay = 1;
+            CalMonth++;
+            if (CalMonth > 12)
+            {
+                CalMonth = 1;
+                CalYear++;
+                CalDayOfYear = 1;
+            }
         }
-        *year = y;
-        *month = m;
-        *day = d + 1;
+        return;
+    }
+
+    // --- otherwise decode the day from scratch
+    D1 = 365;              //365
+    D4 = D1 * 4 + 1;       //1461
+    D100 = D4 * 25 - 1;    //36524
+    D400 = D100 * 4 + 1;   //146097
+
+    CalDate = t;
+    t--;
+    y = 1;
+    while (t >= D400)
+    {
+        t -= D400;
+        y += 400;
+    }
+    divMod(t, D100, &i, &d);
+    if (i == 4)
+    {
+        i--;
+        d += D100;
+    }
+    y += i*100;
+    divMod(d, D4, &i, &d);
+    y += i*4;
+    divMod(d, D1, &i, &d);
+    if (i == 4)
+    {
+        i--;
+        d += D1;
+    }
+    y += i;
+    CalDayOfYear = d + 1;
+    k = isLeapYear(y);
+    m = 1;
+    for (;;)
+    {
+        i = DaysPerMonth[k][m-1];
+        if (d < i) break;
+        d -= i;
+        m++;
     }
+    CalYear = y;
+    CalMonth = m;
+    CalDay = d + 1;
 }
 
 //=============================================================================
@@ -441,6 +495,12 @@ int  datetime_dayOfYear(DateTime date)
 {
     int year, month, day;
     DateTime startOfYear;
+    int t = (int)(floor(date)) + DateDelta;
+    if (t > 0)
+    {
+        if (t != CalDate) setCalendar(t);
+        return CalDayOfYear;
+    }
     datetime_decodeDate(date, &year, &month, &day);
     startOfYear = datetime_encodeDate(year, 1, 1);
     return (int)(floor(date - startOfYear)) + 1;
@@ -40,6 +40,8 @@ static const double MINTIMESTEP =  0.5;     // min. time step (sec)
 static const double OMEGA       =  0.5;     // under-relaxation parameter
 static const double STOP_TOL    =  0.005;   // Picard iteration stop criterion
 static const int    MAXSTEPS    =  8;       // max. number of Picard iterations (5.0.019 - LR)
+static const double PCG_TOL     =  1.0e-6;  // rel. residual stop criterion for PCG
+static const int    PCG_MAXITER =  500;     // max. number of PCG iterations
 
 //-----------------------------------------------------------------------------
 //  Data Structures
@@ -51,6 +53,12 @@ typedef struct
     double  oldSurfArea;               // previous surface area (ft2)
     double  sumdqdh;                   // sum of dqdh from adjoining links
     double  dYdT;                      // change in depth w.r.t. time (ft/sec)
+    double  diag;                      // diagonal of Newton Jacobian (ft2/sec)
+    double  rhs;                       // continuity residual (cfs)
+    double  dy;                        // Newton depth correction (ft)
+    double  r;                         // PCG residual
+    double  p;                         // PCG search direction
+    double  ap;                        // Jacobian times search direction
 } TXnode;
 
 typedef struct
@@ -58,6 +66,9 @@ typedef struct
     char    bypassed;                  // TRUE if can bypass calcs. for a link
     double  surfArea1;                 // surf. area at upstrm end of link (ft2)
     double  surfArea2;                 // surf. area at dnstrm end of link (ft2)
+    double  offDiag;                   // off-diagonal Jacobian term (ft2/sec)
+    double  courantStep;               // Courant-limited time step (sec)
+    int     stepClass;                 // log2 of # sub-steps per routing step
 } TXlink;
 
 //-----------------------------------------------------------------------------
@@ -73,6 +84,10 @@ static int     Converged;              // TRUE if Picard iterations converged
 static int     Steps;                  // number of Picard iterations
 static TXnode* Xnode;
 static TXlink* Xlink;
+static int*    RoutedLinks;            // links routed over current time step
+static int     NumRoutedLinks;         // number of links routed
+static int*    RoutedNodes;            // nodes routed over current time step
+static int     NumRoutedNodes;         // number of nodes routed
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
@@ -84,14 +99,21 @@ static TXlink* Xlink;
 //-----------------------------------------------------------------------------
 //  Function declarations
 //-----------------------------------------------------------------------------
-static void   execRoutingStep(int links[], double dt);
+static void   execRoutingStep(double dt);
+static void   execNewtonStep(double dt);
+static void   assembleJacobian(double dt);
+static int    solveJacobian(void);
+static void   multiplyJacobian(void);
+static void   setNewtonDepth(int node, double dt);
 static void   initNodeState(int i);
 static void   findConduitFlow(int i, double dt);
 static void   findNonConduitFlow(int i, double dt);
 static double getModPumpFlow(int i, double q, double dt);
 static void   updateNodeFlows(int i, double q);
 
-static double getConduitFlow(int link, double qin, double dt);
+static double getConduitFlow(int link, double qin, double aOld,
+              double depth1, double depth2, double dt, int relax);
+static double getSubcycledFlow(int link, double qOld, double dt);
 static int    getFlowClass(int link, double q, double h1, double h2,
               double y1, double y2);
 static void   findSurfArea(int link, double length, double* h1, double* h2,
@@ -113,6 +135,7 @@ static double getFloodedDepth(int i, int canPond, double dV, double yNew,      /
 static double getVariableStep(double maxStep);
 static double getLinkStep(double tMin, int *minLink);
 static double getNodeStep(double tMin, int *minNode);
+static void   setStepClasses(double tStep, int classCount[]);
 
 static void   checkCapacity(int j);
 
@@ -144,6 +167,8 @@ void dynwave_init()
     {
         Link[i].flowClass = DRY;
         Link[i].dqdh = 0.0;
+        Xlink[i].courantStep = BIG;
+        Xlink[i].stepClass = 0;
     }
 }
 
@@ -191,49 +216,70 @@ double dynwave_getRoutingStep(double fixedStep)
 
 //=============================================================================
 
-int dynwave_execute(int links[], double tStep)
+int dynwave_execute(int links[], int nLinks, int nodes[], int nNodes,
+                    double tStep)
 //
 //  Input:   links = array of topo sorted links indexes
+//           nLinks = number of links to route
+//           nodes = array of indexes of nodes to route
+//           nNodes = number of nodes to route
 //           tStep = time step (sec)
 //  Output:  returns number of iterations used
 //  Purpose: routes flows through drainage network over current time step.
 //
+//  Note: the links and nodes routed must form complete sub-networks
+//        (i.e., no routed link may connect to a node that is not routed).
+//
 {
-    int i;
+    int i, k;
 
     // --- initialize
     if ( ErrorCode ) return 0;
+    RoutedLinks = links;
+    NumRoutedLinks = nLinks;
+    RoutedNodes = nodes;
+    NumRoutedNodes = nNodes;
     Steps = 0;
     Converged = FALSE;
     Omega = OMEGA;
-    for (i=0; i<Nobjects[NODE]; i++)
+    if ( DynWaveSolver == NEWTON ) Omega = 1.0;
+    for (k=0; k<NumRoutedNodes; k++)
     {
+        i = RoutedNodes[k];
         Xnode[i].converged = FALSE;
         Xnode[i].dYdT = 0.0;
     }
-    for (i=0; i<Nobjects[LINK]; i++)
+    for (k=0; k<NumRoutedLinks; k++)
     {
+        i = RoutedLinks[k];
         Xlink[i].bypassed = FALSE;
         Xlink[i].surfArea1 = 0.0;
         Xlink[i].surfArea2 = 0.0;
     }
 
     // --- a2 preserves conduit area from solution at last time step
-    for ( i=0; i<Nlinks[CONDUIT]; i++) Conduit[i].a2 = Conduit[i].a1;
+    for (k=0; k<NumRoutedLinks; k++)
+    {
+        i = RoutedLinks[k];
+        if ( Link[i].type != CONDUIT ) continue;
+        Conduit[Link[i].subIndex].a2 = Conduit[Link[i].subIndex].a1;
+    }
 
     // --- keep iterating until convergence 
     while ( Steps < MAXSTEPS )
     {
         // --- execute a routing step & check for nodal convergence
-        execRoutingStep(links, tStep);
+        if ( DynWaveSolver == NEWTON ) execNewtonStep(tStep);
+        else execRoutingStep(tStep);
         Steps++;
         if ( Steps > 1 )
         {
             if ( Converged ) break;
 
             // --- check if link calculations can be skipped in next step
-            for (i=0; i<Nobjects[LINK]; i++)
+            for (k=0; k<NumRoutedLinks; k++)
             {
+                i = RoutedLinks[k];
                 if ( Xnode[Link[i].node1].converged &&
                      Xnode[Link[i].node2].converged )
                      Xlink[i].bypassed = TRUE;
@@ -243,39 +289,39 @@ int dynwave_execute(int links[], double tStep)
     }
 
     //  --- identify any capacity-limited conduits
-    for (i=0; i<Nobjects[LINK]; i++) checkCapacity(i);
+    for (k=0; k<NumRoutedLinks; k++) checkCapacity(RoutedLinks[k]);
     return Steps;
 }
 
 //=============================================================================
 
-void execRoutingStep(int links[], double dt)
+void execRoutingStep(double dt)
 //
-//  Input:   links = array of link indexes
-//           dt    = time step (sec)
+//  Input:   dt = time step (sec)
 //  Output:  none
 //  Purpose: solves momentum eq. in links and continuity eq. at nodes
 //           over specified time step.
 //
 {
-    int    i;                          // node or link index
+    int    i, k;                       // node or link index
     double yOld;                       // old node depth (ft)
 
     // --- re-initialize state of each node
-    for ( i = 0; i < Nobjects[NODE]; i++ ) initNodeState(i);
+    for ( k = 0; k < NumRoutedNodes; k++ ) initNodeState(RoutedNodes[k]);
     Converged = TRUE;
 
     // --- find new flows in conduit links and non-conduit links
-    for ( i=0; i<Nobjects[LINK]; i++) findConduitFlow(links[i], dt);
-    for ( i=0; i<Nobjects[LINK]; i++) findNonConduitFlow(links[i], dt);
+    for ( k=0; k<NumRoutedLinks; k++) findConduitFlow(RoutedLinks[k], dt);
+    for ( k=0; k<NumRoutedLinks; k++) findNonConduitFlow(RoutedLinks[k], dt);
 
     // --- compute outfall depths based on flow in connecting link
-    for ( i = 0; i < Nobjects[LINK]; i++ ) link_setOutfallDepth(i);
+    for ( k = 0; k < NumRoutedLinks; k++ ) link_setOutfallDepth(RoutedLinks[k]);
 
     // --- compute new depth for all non-outfall nodes and determine if
     //     depth change from previous iteration is below tolerance
-    for ( i = 0; i < Nobjects[NODE]; i++ )
+    for ( k = 0; k < NumRoutedNodes; k++ )
     {
+        i = RoutedNodes[k];
         if ( Node[i].type == OUTFALL ) continue;
         yOld = Node[i].newDepth;
         setNodeDepth(i, dt);
@@ -290,6 +336,186 @@ void execRoutingStep(int links[], double dt)
 
 //=============================================================================
 
+void execNewtonStep(double dt)
+//
+//  Input:   dt = time step (sec)
+//  Output:  none
+//  Purpose: solves momentum eq. in links and then updates all nodal depths
+//           simultaneously with a Newton step on the nodal continuity eqs.
+//
+{
+    int    i, k;                       // node or link index
+    double yOld;                       // old node depth (ft)
+
+    // --- find link flows & their head derivatives as in a Picard step
+    for ( k = 0; k < NumRoutedNodes; k++ ) initNodeState(RoutedNodes[k]);
+    Converged = TRUE;
+    for ( k=0; k<NumRoutedLinks; k++) findConduitFlow(RoutedLinks[k], dt);
+    for ( k=0; k<NumRoutedLinks; k++) findNonConduitFlow(RoutedLinks[k], dt);
+    for ( k = 0; k < NumRoutedLinks; k++ ) link_setOutfallDepth(RoutedLinks[k]);
+
+    // --- solve the linearized continuity eqs. for nodal depth corrections
+    assembleJacobian(dt);
+    solveJacobian();
+
+    // --- apply depth corrections & check for convergence
+    for ( k = 0; k < NumRoutedNodes; k++ )
+    {
+        i = RoutedNodes[k];
+        if ( Node[i].type == OUTFALL ) continue;
+        yOld = Node[i].newDepth;
+        setNewtonDepth(i, dt);
+        Xnode[i].converged = TRUE;
+        if ( fabs(yOld - Node[i].newDepth) > STOP_TOL )
+        {
+            Converged = FALSE;
+            Xnode[i].converged = FALSE;
+        }
+    }
+}
+
+//=============================================================================
+
+void assembleJacobian(double dt)
+//
+//  Input:   dt = time step (sec)
+//  Output:  none
+//  Purpose: assembles the Jacobian of the nodal continuity eqs. w.r.t. node
+//           depth and the continuity residual at each non-outfall node.
+//
+//  The residual at node i is A*(y - yOld)/dt - (0.5*(Qold + Qnet) - losses),
+//  where each link flow varies with the head difference across it at rate
+//  dqdh. This yields a symmetric, diagonally dominant matrix with one
+//  off-diagonal term per link joining two non-outfall nodes.
+//
+{
+    int    i, k, n1, n2;
+    double dQ;                         // net inflow to node (cfs)
+    double dV;                         // net inflow volume over step (ft3)
+
+    // --- diagonal terms & residuals
+    for ( k = 0; k < NumRoutedNodes; k++ )
+    {
+        i = RoutedNodes[k];
+        Xnode[i].dy = 0.0;
+        if ( Node[i].type == OUTFALL )
+        {
+            Xnode[i].diag = 1.0;
+            Xnode[i].rhs = 0.0;
+            continue;
+        }
+        dQ = Node[i].inflow - Node[i].outflow;
+        dV = 0.5 * (Node[i].oldNetInflow + dQ) * dt - node_getLosses(i, dt);
+        Xnode[i].diag = Xnode[i].newSurfArea / dt + 0.5 * Xnode[i].sumdqdh;
+        Xnode[i].rhs = dV / dt - Xnode[i].newSurfArea *
+                       (Node[i].newDepth - Node[i].oldDepth) / dt;
+    }
+
+    // --- off-diagonal terms (pumps only affect their upstream node)
+    for ( k = 0; k < NumRoutedLinks; k++ )
+    {
+        i = RoutedLinks[k];
+        Xlink[i].offDiag = 0.0;
+        if ( Link[i].type == PUMP ) continue;
+        n1 = Link[i].node1;
+        n2 = Link[i].node2;
+        if ( Node[n1].type == OUTFALL || Node[n2].type == OUTFALL ) continue;
+        Xlink[i].offDiag = 0.5 * Link[i].dqdh;
+    }
+}
+
+//=============================================================================
+
+int solveJacobian()
+//
+//  Input:   none
+//  Output:  returns number of iterations used
+//  Purpose: solves the Newton system for nodal depth corrections using
+//           Jacobi-preconditioned conjugate gradients.
+//
+{
+    int    i, k, iter;
+    double rz, rzNew, pAp, alpha, beta, bNorm, rNorm;
+
+    // --- initial residual is the right hand side since dy = 0
+    bNorm = 0.0;
+    rz = 0.0;
+    for ( k = 0; k < NumRoutedNodes; k++ )
+    {
+        i = RoutedNodes[k];
+        Xnode[i].r = Xnode[i].rhs;
+        Xnode[i].p = Xnode[i].r / Xnode[i].diag;
+        bNorm += Xnode[i].r * Xnode[i].r;
+        rz += Xnode[i].r * Xnode[i].p;
+    }
+    if ( bNorm == 0.0 ) return 0;
+
+    for ( iter = 1; iter <= PCG_MAXITER; iter++ )
+    {
+        // --- step along current search direction
+        multiplyJacobian();
+        pAp = 0.0;
+        for ( k = 0; k < NumRoutedNodes; k++ )
+        {
+            i = RoutedNodes[k];
+            pAp += Xnode[i].p * Xnode[i].ap;
+        }
+        if ( pAp <= 0.0 ) break;
+        alpha = rz / pAp;
+        rNorm = 0.0;
+        rzNew = 0.0;
+        for ( k = 0; k < NumRoutedNodes; k++ )
+        {
+            i = RoutedNodes[k];
+            Xnode[i].dy += alpha * Xnode[i].p;
+            Xnode[i].r  -= alpha * Xnode[i].ap;
+            rNorm += Xnode[i].r * Xnode[i].r;
+            rzNew += Xnode[i].r * Xnode[i].r / Xnode[i].diag;
+        }
+        if ( rNorm <= PCG_TOL * PCG_TOL * bNorm ) break;
+
+        // --- update search direction
+        beta = rzNew / rz;
+        rz = rzNew;
+        for ( k = 0; k < NumRoutedNodes; k++ )
+        {
+            i = RoutedNodes[k];
+            Xnode[i].p = Xnode[i].r / Xnode[i].diag + beta * Xnode[i].p;
+        }
+    }
+    return iter;
+}
+
+//=============================================================================
+
+void multiplyJacobian()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: multiplies the Newton Jacobian by the current PCG search
+//           direction, visiting the matrix's off-diagonals link by link.
+//
+{
+    int    i, k;
+    double c;
+
+    for ( k = 0; k < NumRoutedNodes; k++ )
+    {
+        i = RoutedNodes[k];
+        Xnode[i].ap = Xnode[i].diag * Xnode[i].p;
+    }
+    for ( k = 0; k < NumRoutedLinks; k++ )
+    {
+        i = RoutedLinks[k];
+        c = Xlink[i].offDiag;
+        if ( c == 0.0 ) continue;
+        Xnode[Link[i].node1].ap -= c * Xnode[Link[i].node2].p;
+        Xnode[Link[i].node2].ap -= c * Xnode[Link[i].node1].p;
+    }
+}
+
+//=============================================================================
+
 void initNodeState(int i)
 //
 //  Input:   i = node index
@@ -340,7 +566,13 @@ void findConduitFlow(int i, double dt)
     if ( !Xlink[i].bypassed )
     {
         Link[i].dqdh = 0.0;
-        Link[i].newFlow = getConduitFlow(i, qOld, dt);
+        if ( Xlink[i].stepClass > 0 )
+            Link[i].newFlow = getSubcycledFlow(i, qOld, dt);
+        else
+            Link[i].newFlow = getConduitFlow(i, qOld,
+                              Conduit[Link[i].subIndex].a2,
+                              Node[Link[i].node1].newDepth,
+                              Node[Link[i].node2].newDepth, dt, Steps > 0);
     }
     // NOTE: if link was bypassed, then its flow and surface area values
     //       from the previous iteration will still be valid.
@@ -522,11 +754,17 @@ void updateNodeFlows(int i, double q)
 
 //=============================================================================
 
-double  getConduitFlow(int j, double qOld, double dt)
+double  getConduitFlow(int j, double qOld, double aOld, double depth1,
+                       double depth2, double dt, int relax)
 //
 //  Input:   j        = link index
-//           qOld     = flow from previous iteration (cfs)
+//           qOld     = flow from previous time step (cfs)
+//           aOld     = area from previous time step (ft2)
+//           depth1   = depth at upstream node (ft)
+//           depth2   = depth at downstream node (ft)
 //           dt       = time step (sec)
+//           relax    = TRUE if under-relaxation with the flow from the
+//                      previous iteration is applied
 //  Output:  returns new flow value (cfs)
 //  Purpose: updates flow in conduit link by solving finite difference
 //           form of continuity and momentum equations.
@@ -542,7 +780,6 @@ double  getConduitFlow(int j, double qOld, double dt)
     double yMid, rMid, aMid;           // mid-stream or avg. values of y, r, & a
     double aWtd, rWtd;                 // upstream weighted area & hyd. radius
     double qLast;                      // flow from previous iteration (cfs)
-    double aOld;                       // area from previous time step (ft2)
     double v;                          // velocity (ft/sec)
     double rho;                        // upstream weighting factor
     double sigma;                      // inertial damping factor
@@ -560,8 +797,8 @@ double  getConduitFlow(int j, double qOld, double dt)
     n2 = Link[j].node2;
     z1 = Node[n1].invertElev + Link[j].offset1;
     z2 = Node[n2].invertElev + Link[j].offset2;
-    h1 = Node[n1].newDepth + Node[n1].invertElev;
-    h2 = Node[n2].newDepth + Node[n2].invertElev;
+    h1 = depth1 + Node[n1].invertElev;
+    h2 = depth2 + Node[n2].invertElev;
     h1 = MAX(h1, z1);
     h2 = MAX(h2, z2);
 
@@ -582,7 +819,6 @@ double  getConduitFlow(int j, double qOld, double dt)
     qLast = Conduit[k].q1;
 
     // -- get area from solution at previous time step
-    aOld = Conduit[k].a2;
     aOld = MAX(aOld, FUDGE);
 
     // --- use Courant-modified length instead of conduit's actual length
@@ -712,7 +948,7 @@ double  getConduitFlow(int j, double qOld, double dt)
 
     // --- apply under-relaxation weighting between new & old flows;
     // --- do not allow change in flow direction without first being zero 
-    if ( Steps > 0 )
+    if ( relax )
     {
         q = (1.0 - Omega) * qLast + Omega * q;
         if ( q * qLast < 0.0 ) q = 0.001 * SGN(q);
@@ -729,8 +965,8 @@ double  getConduitFlow(int j, double qOld, double dt)
 
     // --- do not allow flow out of a dry node
     //     (as suggested by R. Dickinson)
-    if( q >  FUDGE && Node[n1].newDepth <= FUDGE ) q =  FUDGE;
-    if( q < -FUDGE && Node[n2].newDepth <= FUDGE ) q = -FUDGE;
+    if( q >  FUDGE && depth1 <= FUDGE ) q =  FUDGE;
+    if( q < -FUDGE && depth2 <= FUDGE ) q = -FUDGE;
 
     // --- save new values of area, flow, depth, & volume
     Conduit[k].a1 = aMid;
@@ -745,6 +981,78 @@ double  getConduitFlow(int j, double qOld, double dt)
 
 //=============================================================================
 
+double getSubcycledFlow(int j, double qOld, double dt)
+//
+//  Input:   j    = link index
+//           qOld = flow from previous time step (cfs)
+//           dt   = time step (sec)
+//  Output:  returns new flow value (cfs)
+//  Purpose: updates flow in a conduit whose Courant time step is shorter
+//           than the routing time step by sub-cycling its momentum eqn.
+//
+//  The heads at the conduit's end nodes are interpolated between their
+//  values at the start of the routing step and their current estimates.
+//  The flow at the end of the last sub-step becomes the conduit's new flow,
+//  subject to the same under-relaxation, flow limit, flap gate and dry node
+//  checks that getConduitFlow applies to a full routing step.
+//
+{
+    int    k = Link[j].subIndex;
+    int    n1 = Link[j].node1;
+    int    n2 = Link[j].node2;
+    int    m = 1 << Xlink[j].stepClass; // number of sub-steps
+    int    s;
+    double barrels = Conduit[k].barrels;
+    double h = dt / m;                  // sub-step (sec)
+    double d1, d2;                      // end node depths in a sub-step (ft)
+    double aOld = Conduit[k].a2;        // area at start of a sub-step (ft2)
+    double qLast = Link[j].newFlow / barrels; // flow from prev. iteration
+    double q2 = qOld;                   // flow at end of a sub-step (cfs)
+    double f;                           // fraction of routing step elapsed
+    double dqdh = 0.0;                  // summed dqdh over sub-steps
+    double q;                           // flow per barrel (cfs)
+
+    // --- sub-cycle the momentum eqn. w/o under-relaxation
+    for ( s = 1; s <= m; s++ )
+    {
+        f = (double)s / (double)m;
+        d1 = Node[n1].oldDepth + f * (Node[n1].newDepth - Node[n1].oldDepth);
+        d2 = Node[n2].oldDepth + f * (Node[n2].newDepth - Node[n2].oldDepth);
+        q2 = getConduitFlow(j, q2, aOld, d1, d2, h, FALSE);
+        aOld = Conduit[k].a1;
+        dqdh += Link[j].dqdh;
+    }
+    Link[j].dqdh = dqdh;
+
+    // --- flow per barrel at end of last sub-step is the new flow
+    q = q2 / barrels;
+
+    // --- apply under-relaxation with flow from previous iteration
+    if ( Steps > 0 )
+    {
+        q = (1.0 - Omega) * qLast + Omega * q;
+        if ( q * qLast < 0.0 ) q = 0.001 * SGN(q);
+    }
+
+    // --- check if user-supplied flow limit applies
+    if ( Link[j].qLimit > 0.0 && fabs(q) > Link[j].qLimit )
+        q = SGN(q) * Link[j].qLimit;
+
+    // --- check for reverse flow with closed flap gate
+    if ( q2 == 0.0 || link_setFlapGate(j, n1, n2, q) ) q = 0.0;
+
+    // --- do not allow flow out of a dry node
+    if( q >  FUDGE && Node[n1].newDepth <= FUDGE ) q =  FUDGE;
+    if( q < -FUDGE && Node[n2].newDepth <= FUDGE ) q = -FUDGE;
+
+    // --- save flow as the conduit's latest iterate
+    Conduit[k].q1 = q;
+    Conduit[k].q2 = q;
+    return q * barrels;
+}
+
+//=============================================================================
+
 int getFlowClass(int j, double q, double h1, double h2, double y1, double y2)
 //
 //  Input:   j  = conduit link index
@@ -1057,6 +1365,42 @@ double getHydRad(TXsect* xsect, double y)
 
 //=============================================================================
 
+void setNewtonDepth(int i, double dt)
+//
+//  Input:   i  = node index
+//           dt = time step (sec)
+//  Output:  none
+//  Purpose: sets depth at non-outfall node from its Newton depth correction.
+//
+{
+    int     canPond;                   // TRUE if node can pond overflows
+    double  dV;                        // change in node volume (ft3)
+    double  yMax;                      // max. depth at node (ft)
+    double  yNew;                      // new node depth (ft)
+
+    // --- apply Newton correction to depth from last iteration
+    canPond = (AllowPonding && Node[i].pondedArea > 0.0);
+    Node[i].overflow = 0.0;
+    dV = 0.5 * (Node[i].oldNetInflow + Node[i].inflow - Node[i].outflow) * dt
+         - node_getLosses(i, dt);
+    yNew = Node[i].newDepth + Xnode[i].dy;
+    if ( yNew < 0.0 ) yNew = 0.0;
+
+    // --- find flooded depth & volume
+    yMax = Node[i].fullDepth;
+    if ( canPond == FALSE ) yMax += Node[i].surDepth;
+    if ( yNew > yMax )
+    {
+        yNew = getFloodedDepth(i, canPond, dV, yNew, yMax, dt);
+    }
+    else Node[i].newVolume = node_getVolume(i, yNew);
+
+    Xnode[i].dYdT = fabs(yNew - Node[i].oldDepth) / dt;
+    Node[i].newDepth = yNew;
+}
+
+//=============================================================================
+
 //  =====  This function was completely re-written for release 5.0.019  =====  //(5.0.019 - LR)
 
 double checkNormalFlow(int j, double q, double y1, double y2, double a1,
@@ -1267,10 +1611,22 @@ double getVariableStep(double maxStep)
     double tMin;                        // allowable time step (sec)
     double tMinLink;                    // allowable time step for links (sec)
     double tMinNode;                    // allowable time step for nodes (sec)
+    int    classCount[MAXSTEPCLASSES];  // number of links in each step class
 
     // --- find stable time step for links & then nodes
+    //     (with step classes, links too slow for the routing step are
+    //     sub-cycled, so the routing step may be a multiple of their step)
     tMin = maxStep;
     tMinLink = getLinkStep(tMin, &minLink);
+    if ( StepClasses > 1 )
+    {
+        tMinLink *= (double)(1 << (StepClasses - 1));
+        if ( tMinLink >= maxStep )
+        {
+            tMinLink = maxStep;
+            minLink = -1;
+        }
+    }
     tMinNode = getNodeStep(tMinLink, &minNode);
 
     // --- use smaller of the link and node time step
@@ -1281,11 +1637,17 @@ double getVariableStep(double maxStep)
         minLink = -1;
     }
 
-    // --- update count of times the minimum node or link was critical
-    stats_updateCriticalTimeCount(minNode, minLink);
-
     // --- don't let time step go below an absolute minimum
     if ( tMin < MINTIMESTEP ) tMin = MINTIMESTEP;
+
+    // --- assign links to time step classes & update count of times
+    //     the minimum node or link was critical
+    if ( StepClasses > 1 )
+    {
+        setStepClasses(tMin, classCount);
+        stats_updateCriticalTimeCount(minNode, minLink, classCount);
+    }
+    else stats_updateCriticalTimeCount(minNode, minLink, NULL);
     return tMin;
 }
 
@@ -1308,6 +1670,7 @@ double getLinkStep(double tMin, int *minLink)
     // --- examine each conduit link
     for ( i = 0; i < Nobjects[LINK]; i++ )
     {
+        Xlink[i].courantStep = BIG;
         if ( Link[i].type == CONDUIT )
         {
            // --- skip conduits with negligible flow, area or Fr
@@ -1322,6 +1685,7 @@ double getLinkStep(double tMin, int *minLink)
             t = Link[i].newVolume / Conduit[k].barrels / q;
             t = t * Conduit[k].modLength / link_getLength(i);                  //(5.0.015 - LR)
             t = t * Link[i].froude / (1.0 + Link[i].froude) * CourantFactor;
+            Xlink[i].courantStep = t;
 
             // --- update critical link time step
             if ( t < tLink )
@@ -1380,6 +1744,34 @@ double getNodeStep(double tMin, int *minNode)
 
 //=============================================================================
 
+void setStepClasses(double tStep, int classCount[])
+//
+//  Input:   tStep = routing time step (sec)
+//  Output:  classCount = number of links in each time step class
+//  Purpose: assigns each link the fewest number of halvings of the routing
+//           time step needed to satisfy its own Courant time step.
+//
+{
+    int    i, c;
+    double t;
+
+    for ( c = 0; c < StepClasses; c++ ) classCount[c] = 0;
+    for ( i = 0; i < Nobjects[LINK]; i++ )
+    {
+        c = 0;
+        t = tStep;
+        while ( t > Xlink[i].courantStep && c < StepClasses - 1 )
+        {
+            t /= 2.0;
+            c++;
+        }
+        Xlink[i].stepClass = c;
+        classCount[c]++;
+    }
+}
+
+//=============================================================================
+
 void  checkCapacity(int j)
 //
 //  Input:   j = link index
@@ -298,6 +298,10 @@ enum  SubAreaType {
       H_W,                             // Hazen-Williams eqn.                  //(5.0.010 - LR)
       D_W};                            // Darcy-Weisbach eqn.                  //(5.0.010 - LR)
 
+ enum DynWaveSolverType {
+      PICARD,                          // under-relaxed successive approx.
+      NEWTON};                         // implicit Newton node-head solve
+
  enum OffsetType {                                                             //(5.0.012 - LR)
       DEPTH_OFFSET,                    // offset measured as depth             //(5.0.012 - LR)
       ELEV_OFFSET};                    // offset measured as elevation         //(5.0.012 - LR)
@@ -418,7 +422,8 @@ enum  CompatibilityType {
       SKIP_STEADY_STATE, TEMPDIR,           IGNORE_RAINFALL,                   //(5.0.010 - LR)
       FORCE_MAIN_EQN,    LINK_OFFSETS,      MIN_SLOPE,                         //(5.0.014 - LR)
       IGNORE_SNOWMELT,   IGNORE_GWATER,     IGNORE_ROUTING,                    //(5.0.014 - LR)
-      IGNORE_QUALITY};                                                         //(5.0.014 - LR)
+      IGNORE_QUALITY,    DYNWAVE_SOLVER,    STEP_CLASSES,
+      FAST_FORWARD_DRY,  IMPLICIT_PONDING,  INPUT_CACHE};
 
 enum  NoYesType {
       NO,
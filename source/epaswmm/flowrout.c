@@ -47,13 +47,17 @@ static void   initNodes(void);
 static void   initLinks(void);
 static void   validateTreeLayout(void);      
 static void   validateGeneralLayout(void);
-static void   updateStorageState(int i, int j, int links[], double dt);
-static double getStorageOutflow(int node, int j, int links[], double dt);
+static void   updateStorageState(int i, int j, int last, int links[],
+                                 double dt);
+static double getStorageOutflow(int node, int j, int last, int links[],
+                                double dt);
 static double getLinkInflow(int link, double dt);
 static void   setNewNodeState(int node, double dt);
 static void   setNewLinkState(int link);
 static void   updateNodeDepth(int node, double y);
 static int    steadyflow_execute(int link, double* qin, double* qout);
+static double routeLinks(int links[], int first, int last, int routingModel,
+                         double tStep);
 
 
 //=============================================================================
@@ -119,26 +123,33 @@ double flowrout_getRoutingStep(int routingModel, double fixedStep)
 
 //=============================================================================
 
-int flowrout_execute(int links[], int routingModel, double tStep)
+int flowrout_execute(int links[], int partStart[], int nParts, int nodes[],
+                     int nNodes, int routingModel, double tStep)
 //
 //  Input:   links = array of link indexes in topo-sorted order
+//           partStart = start of each independent sub-network in links
+//           nParts = number of independent sub-networks to route
+//           nodes = array of indexes of the nodes to route
+//           nNodes = number of nodes to route
 //           routingModel = type of routing method used
 //           tStep = routing time step (sec)
 //  Output:  returns number of computational steps taken
 //  Purpose: routes flow through conveyance network over current time step.
 //
+//  Note: links and nodes may cover only those sub-networks whose flows
+//        have changed; the rest of the network is left untouched.
+//
 {
-    int   i, j;
-    int   n1;                          // upstream node of link
-    double qin;                        // link inflow (cfs)
-    double qout;                       // link outflow (cfs)
+    int   i, j, p;
+    int   nLinks = partStart[nParts];  // number of links to route
     double steps;                      // computational step count
 
 ////  The code below was modified to initialize overflows.  ////               //(5.0.012 - LR)
     // --- set overflows to drain any ponded water
     if ( ErrorCode ) return 0;
-    for (j = 0; j < Nobjects[NODE]; j++)
+    for (i = 0; i < nNodes; i++)
     {
+        j = nodes[i];
         Node[j].updated = FALSE;
         Node[j].overflow = 0.0;
         if ( Node[j].type != STORAGE
@@ -152,18 +163,55 @@ int flowrout_execute(int links[], int routingModel, double tStep)
     // --- execute dynamic wave routing if called for
     if ( routingModel == DW )
     {
-        steps = dynwave_execute(links, tStep);
+        steps = dynwave_execute(links, nLinks, nodes, nNodes, tStep);
         return (int)steps;
     }
 
-    // --- otherwise examine each link, moving from upstream to downstream
+    // --- otherwise route flow through each independent sub-network
+    //     (these share no nodes so they can be routed concurrently)
     steps = 0.0;
-    for (i = 0; i < Nobjects[LINK]; i++)
+#pragma omp parallel for schedule(dynamic) reduction(+:steps) if(nParts > 1)
+    for (p = 0; p < nParts; p++)
+    {
+        steps += routeLinks(links, partStart[p], partStart[p+1],
+                            routingModel, tStep);
+    }
+    if ( nLinks > 0 ) steps /= nLinks;
+
+    // --- update state of each non-updated node and link
+    for ( i=0; i<nNodes; i++) setNewNodeState(nodes[i], tStep);
+    for ( i=0; i<nLinks; i++) setNewLinkState(links[i]);
+    return (int)(steps+0.5);
+}
+
+//=============================================================================
+
+double routeLinks(int links[], int first, int last, int routingModel,
+                  double tStep)
+//
+//  Input:   links = array of link indexes in topo-sorted order
+//           first = position in links of first link to route
+//           last = position in links after last link to route
+//           routingModel = type of routing method used
+//           tStep = routing time step (sec)
+//  Output:  returns number of computational steps taken
+//  Purpose: routes flow through a range of links, moving from upstream
+//           to downstream, under Steady or Kin. Wave routing.
+//
+{
+    int   i, j;
+    int   n1;                          // upstream node of link
+    double qin;                        // link inflow (cfs)
+    double qout;                       // link outflow (cfs)
+    double steps = 0.0;                // computational step count
+
+    for (i = first; i < last; i++)
     {
         // --- see if upstream node is a storage unit whose state needs updating
         j = links[i];
         n1 = Link[j].node1;
-        if ( Node[n1].type == STORAGE ) updateStorageState(n1, i, links, tStep);
+        if ( Node[n1].type == STORAGE )
+            updateStorageState(n1, i, last, links, tStep);
 
         // --- retrieve inflow at upstream end of link
         qin  = getLinkInflow(j, tStep);
@@ -177,12 +225,7 @@ int flowrout_execute(int links[], int routingModel, double tStep)
         Node[ Link[j].node1 ].outflow += qin;
         Node[ Link[j].node2 ].inflow += qout;
     }
-    if ( Nobjects[LINK] > 0 ) steps /= Nobjects[LINK];
-
-    // --- update state of each non-updated node and link
-    for ( j=0; j<Nobjects[NODE]; j++) setNewNodeState(j, tStep);
-    for ( j=0; j<Nobjects[LINK]; j++) setNewLinkState(j);
-    return (int)(steps+0.5);
+    return steps;
 }
 
 //=============================================================================
@@ -541,10 +584,11 @@ double getLinkInflow(int j, double dt)
 
 //=============================================================================
 
-void updateStorageState(int i, int j, int links[], double dt)
+void updateStorageState(int i, int j, int last, int links[], double dt)
 //
 //  Input:   i = index of storage node
 //           j = current position in links array
+//           last = position in links array after last link being routed
 //           links = array of topo-sorted link indexes
 //           dt = routing time step (sec)
 //  Output:  none
@@ -579,7 +623,7 @@ void updateStorageState(int i, int j, int links[], double dt)
     while ( iter < MAXITER && !stopped )
     {
         // --- find total flow in all outflow links
-        outflow = getStorageOutflow(i, j, links, dt);
+        outflow = getStorageOutflow(i, j, last, links, dt);
 
         // --- find new volume from flow balance eqn.
         v2 = vFixed - 0.5 * outflow * dt - node_getLosses(i, dt);              //(5.0.019 - LR)
@@ -623,10 +667,11 @@ void updateStorageState(int i, int j, int links[], double dt)
 
 //=============================================================================
 
-double getStorageOutflow(int i, int j, int links[], double dt)
+double getStorageOutflow(int i, int j, int last, int links[], double dt)
 //
 //  Input:   i = index of storage node
 //           j = current position in links array
+//           last = position in links array after last link being routed
 //           links = array of topo-sorted link indexes
 //           dt = routing time step (sec)
 //  Output:  returns total outflow from storage node (cfs)
@@ -636,7 +681,7 @@ double getStorageOutflow(int i, int j, int links[], double dt)
     int   k, m;
     double outflow = 0.0;
 
-    for (k = j; k < Nobjects[LINK]; k++)
+    for (k = j; k < last; k++)
     {
         m = links[k];
         if ( Link[m].node1 != i ) break;
@@ -74,6 +74,7 @@ int      climate_readParams(char* tok[], int ntoks);
 int      climate_readEvapParams(char* tok[], int ntoks);
 void     climate_validate(void);
 void     climate_openFile(void);
+void     climate_closeFile(void);
 void     climate_initState(void);
 void     climate_setState(DateTime aDate);
 DateTime climate_getNextEvap(DateTime aDate); 
@@ -93,6 +94,7 @@ void    snow_initSnowpack(int subcatch);
 void    snow_initSnowmelt(int snowIndex);
 void    snow_validateSnowmelt(int snowIndex);                                  //(5.0.012 - LR)
 void    snow_setMeltCoeffs(int snowIndex, double season);
+void    snow_setClimateCoeffs(void);
 void    snow_plowSnow(int subcatch, double tStep);
 double  snow_getSnowMelt(int subcatch, double rainfall, double snowfall,
         double tStep, double netPrecip[]);
@@ -103,6 +105,7 @@ double  snow_getSnowCover(int subcatch);
 //-----------------------------------------------------------------------------
 int     runoff_open(void);
 void    runoff_execute(void);
+int     runoff_isDry(void);
 void    runoff_close(void);
 
 //-----------------------------------------------------------------------------
@@ -111,6 +114,7 @@ void    runoff_close(void);
 int     routing_open(int routingModel);
 double  routing_getRoutingStep(int routingModel, double fixedStep);
 void    routing_execute(int routingModel, double routingStep);
+int     routing_isSteady(void);
 void    routing_close(int routingModel);
 
 //-----------------------------------------------------------------------------
@@ -162,7 +166,8 @@ int     landuse_readPollutParams(int pollut, char* tok[], int ntoks);
 int     landuse_readBuildupParams(char* tok[], int ntoks);
 int     landuse_readWashoffParams(char* tok[], int ntoks);
 double  landuse_getBuildup(int landuse, int pollut, double area, double curb,
-        double buildup, double tStep);
+        double buildup, double* days, double tStep);
+void    landuse_setExternalBuildup(DateTime aDate);
 void    landuse_getWashoff(int landuse, double area, TLandFactor landFactor[],
         double runoff, double tStep, double washoffLoad[]);
 
@@ -172,20 +177,24 @@ void    landuse_getWashoff(int landuse, double area, TLandFactor landFactor[],
 void    flowrout_init(int routingModel);
 void    flowrout_close(int routingModel);
 double  flowrout_getRoutingStep(int routingModel, double fixedStep);
-int     flowrout_execute(int links[], int routingModel, double tStep);
+int     flowrout_execute(int links[], int partStart[], int nParts,
+                         int nodes[], int nNodes, int routingModel,
+                         double tStep);
 
 void    qualrout_execute(double tStep);
 double  qualrout_getCstrQual(double c, double v, double wIn, double qIn,       //(5.0.014 - LR)
         double kDecay, double tStep);                                          //(5.0.014 - LR)
 
 void    toposort_sortLinks(int links[]);
+int     toposort_partitionLinks(int links[], int partStart[], int nodePart[]);
 
 int     kinwave_execute(int link, double* qin, double* qout, double tStep);
 
 void    dynwave_init(void);
 void    dynwave_close(void);
 double  dynwave_getRoutingStep(double fixedStep);
-int     dynwave_execute(int links[], double tStep);
+int     dynwave_execute(int links[], int nLinks, int nodes[], int nNodes,
+                        double tStep);
 
 //-----------------------------------------------------------------------------
 //   Treatment Methods
@@ -208,6 +217,7 @@ void    massbal_updateRunoffTotals(double vRainfall, double vEvap, double vInfil
 void    massbal_updateLoadingTotals(int type, int pollut, double w);
 void    massbal_updateGwaterTotals(double vInfil, double vUpperEvap,
         double vLowerEvap, double vLowerPerc, double vGwater);
+void    massbal_sumThreadTotals(void);
 void    massbal_updateRoutingTotals(double tStep);
 void    massbal_initTimeStepTotals(void);
 void    massbal_addInflowFlow(int type, double q);
@@ -224,7 +234,7 @@ double  massbal_getStepFlowError(void);                                        /
 int     stats_open(void);
 void    stats_close(void);
 void    stats_report(void);
-void    stats_updateCriticalTimeCount(int node, int link);
+void    stats_updateCriticalTimeCount(int node, int link, int classCount[]);
 void    stats_updateFlowStats(double tStep, DateTime aDate, int stepCount,
         int steadyState);
 void    stats_updateSubcatchStats(int subcatch, double rainVol, double runonVol,
@@ -237,6 +247,7 @@ void    stats_updateMaxRunoff(void);
 int      gage_readParams(int gage, char* tok[], int ntoks);
 void     gage_validate(int gage);                                              //(5.0.018 - LR)
 void     gage_initState(int gage);
+void     gage_delete(int gage);
 void     gage_setState(int gage, DateTime aDate);
 double   gage_getPrecip(int gage, double *rainfall, double *snowfall);
 void     gage_setReportRainfall(int gage, DateTime aDate);
@@ -383,6 +394,7 @@ int     shape_validate(TShape *shape, TTable *curve);                          /
 int     controls_create(int n);
 void    controls_delete(void);
 int     controls_addRuleClause(int rule, int keyword, char* Tok[], int nTokens);
+int     controls_init(void);
 int     controls_evaluate(DateTime currentTime, DateTime elapsedTime, 
         double tStep);
 
@@ -416,6 +428,10 @@ int      getInt(char *s, int *y);             // get integer from string
 int      getFloat(char *s, float *y);         // get float from string
 int      getDouble(char *s, double *y);       // get double from string
 char*    getTmpName(char *s);                 // get temporary file name
+FILE*    openTmpFile(char *fname,
+         char *tmpName);                      // open unique temporary file
+unsigned long long hashBytes(const void *buf,
+         size_t n, unsigned long long hash);  // checksum of bytes
 int      findmatch(char *s, char *keyword[]); // search for matching keyword
 int      match(char *str, char *substr);      // true if substr matches part of str
 int      strcomp(char *s1, char *s2);         // case insensitive string compare
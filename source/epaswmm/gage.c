@@ -14,7 +14,9 @@
 //   Rain gage functions.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
+#define _FILE_OFFSET_BITS 64
 
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include "headers.h"
@@ -30,6 +32,7 @@ const double OneSecond = 1.1574074e-5;                                         /
 //  gage_readParams        (called by input_readLine)
 //  gage_validate          (called by project_validate)                        //(5.0.018 - LR)
 //  gage_initState         (called by project_init)
+//  gage_delete            (called by deleteObjects in project.c)
 //  gage_setState          (called by runoff_execute & getRainfall in rdii.c)
 //  gage_getPrecip         (called by subcatch_getRunoff)
 //  gage_getNextRainDate   (called by runoff_getTimeStep)
@@ -39,8 +42,12 @@ const double OneSecond = 1.1574074e-5;                                         /
 //-----------------------------------------------------------------------------
 static int    readGageSeriesFormat(char* tok[], int ntoks, double x[]);
 static int    readGageFileFormat(char* tok[], int ntoks, double x[]);
+static int    isRainfallUpdated(int gage);
+static void   loadRainfall(int gage, int fullRecord);
 static int    getFirstRainfall(int gage);
 static int    getNextRainfall(int gage);
+static int    readFirstRainfall(int gage);
+static int    readNextRainfall(int gage);
 static double convertRainfall(int gage, double rain);
 
 
@@ -283,6 +290,10 @@ void  gage_initState(int j)
         if ( UnitSystem == SI ) Gage[j].unitsFactor = MMperINCH;
     }
 
+    // --- load the gage's rainfall over the simulation period into memory
+    //     (only its first intervals if its rainfall is never updated)
+    loadRainfall(j, isRainfallUpdated(j));
+
     // --- get first & next rainfall values
     if ( getFirstRainfall(j) )
     {
@@ -311,6 +322,21 @@ void  gage_initState(int j)
 
 //=============================================================================
 
+void gage_delete(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  none
+//  Purpose: frees memory used for a rain gage's rainfall vector.
+//
+{
+    FREE(Gage[j].rainDates);
+    FREE(Gage[j].rainRates);
+    Gage[j].rainCount = 0;
+    Gage[j].rainIndex = 0;
+}
+
+//=============================================================================
+
 void gage_setState(int j, DateTime t)
 //
 //  Input:   j = rain gage index
@@ -460,10 +486,151 @@ void gage_setReportRainfall(int j, DateTime reportDate)
 
 //=============================================================================
 
+int isRainfallUpdated(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  returns TRUE if gage_setState() will update the gage's rainfall
+//  Purpose: checks if a gage is used by a subcatchment or unit hydrograph
+//           (directly or as their gage's co-gage) and does not simply copy
+//           its rainfall from a co-gage.
+//
+//  Note: this is found from the input data since the gage's isUsed flag
+//        is only set after its state has been initialized.
+//
+{
+    int i, g;
+
+    if ( Gage[j].coGage >= 0 ) return FALSE;
+    for (i = 0; i < Nobjects[SUBCATCH]; i++)
+    {
+        g = Subcatch[i].gage;
+        if ( g == j || (g >= 0 && Gage[g].coGage == j) ) return TRUE;
+    }
+    for (i = 0; i < Nobjects[UNITHYD]; i++)
+    {
+        g = UnitHyd[i].rainGage;
+        if ( g == j || (g >= 0 && Gage[g].coGage == j) ) return TRUE;
+    }
+    return FALSE;
+}
+
+//=============================================================================
+
+void loadRainfall(int j, int fullRecord)
+//
+//  Input:   j = rain gage index
+//           fullRecord = TRUE if the whole simulation period is needed,
+//                        FALSE if only the intervals used by gage_initState
+//  Output:  none
+//  Purpose: reads a gage's rainfall record into a vector of rain intervals
+//           (start date & intensity) covering the simulation period.
+//
+//  Note: the vector begins with the first interval of the record (which
+//        may have zero rainfall) or, if that interval ends before the
+//        simulation starts, with the last non-zero interval that does.
+//        It ends with the first non-zero interval starting on or after
+//        the end of the simulation, so that the wet and dry periods seen
+//        by gage_setState() are the same as when reading the record
+//        directly.
+//
+{
+    int       n = 0;                   // number of intervals in vector
+    int       capacity = 0;            // allocated size of vector
+    DateTime  date;                    // start date of a rain interval
+    double    rain;                    // intensity of a rain interval
+    DateTime* dates;
+    double*   rates;
+
+    gage_delete(j);
+    if ( !readFirstRainfall(j) ) return;
+    date = Gage[j].startDate;
+    rain = Gage[j].rainfall;
+    for (;;)
+    {
+        // --- replace the first interval if it ends before the simulation
+        //     starts (it can never be the current interval)
+        if ( n == 1 && datetime_addSeconds(Gage[j].rainDates[0],
+                       Gage[j].rainInterval) <= StartDateTime ) n = 0;
+
+        // --- grow the vector if need be
+        if ( n == capacity )
+        {
+            capacity = (capacity == 0) ? 256 : 2 * capacity;
+            dates = (DateTime *) realloc(Gage[j].rainDates,
+                                         capacity * sizeof(DateTime));
+            if ( dates ) Gage[j].rainDates = dates;
+            rates = (double *) realloc(Gage[j].rainRates,
+                                       capacity * sizeof(double));
+            if ( rates ) Gage[j].rainRates = rates;
+            if ( dates == NULL || rates == NULL )
+            {
+                report_writeErrorMsg(ERR_MEMORY, "");
+                gage_delete(j);
+                return;
+            }
+        }
+
+        // --- add interval to vector
+        Gage[j].rainDates[n] = date;
+        Gage[j].rainRates[n] = rain;
+        n++;
+        Gage[j].rainCount = n;
+
+        // --- stop once past the end of the simulation
+        //     (or at the next interval if the rest is not needed)
+        if ( date >= EndDateTime ) break;
+        if ( !fullRecord && n == 2 ) break;
+        if ( !readNextRainfall(j) ) break;
+        date = Gage[j].nextDate;
+        rain = Gage[j].nextRainfall;
+    }
+}
+
+//=============================================================================
+
 int getFirstRainfall(int j)
 //
 //  Input:   j = rain gage index
 //  Output:  returns TRUE if successful
+//  Purpose: positions rainfall vector to date with first rainfall.
+//
+{
+    Gage[j].startDate = NO_DATE;
+    Gage[j].rainfall = 0.0;
+    Gage[j].rainIndex = 0;
+    if ( Gage[j].rainCount == 0 ) return 0;
+    Gage[j].startDate = Gage[j].rainDates[0];
+    Gage[j].rainfall = Gage[j].rainRates[0];
+    Gage[j].rainIndex = 1;
+    return 1;
+}
+
+//=============================================================================
+
+int getNextRainfall(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  returns 1 if successful; 0 if not
+//  Purpose: positions rainfall vector to date with next non-zero rainfall
+//           while updating the gage's next rain intensity value.
+//
+{
+    int i = Gage[j].rainIndex;
+
+    Gage[j].nextRainfall = 0.0;
+    if ( i >= Gage[j].rainCount ) return 0;
+    Gage[j].nextDate = Gage[j].rainDates[i];
+    Gage[j].nextRainfall = Gage[j].rainRates[i];
+    Gage[j].rainIndex = i + 1;
+    return 1;
+}
+
+//=============================================================================
+
+int readFirstRainfall(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  returns TRUE if successful
 //  Purpose: positions rainfall record to date with first rainfall.
 //
 {
@@ -484,10 +651,10 @@ int getFirstRainfall(int j)
         if ( Frain.file && Gage[j].endFilePos > Gage[j].startFilePos )
         {
             // --- retrieve 1st date & rainfall volume from file
-            fseek(Frain.file, Gage[j].startFilePos, SEEK_SET);
+            FSEEK64(Frain.file, Gage[j].startFilePos, SEEK_SET);
             fread(&Gage[j].startDate, sizeof(DateTime), 1, Frain.file);
             fread(&vFirst, sizeof(float), 1, Frain.file);
-            Gage[j].currentFilePos = ftell(Frain.file);
+            Gage[j].currentFilePos = FTELL64(Frain.file);
 
             // --- convert rainfall to intensity
             Gage[j].rainfall = convertRainfall(j, (double)vFirst);
@@ -519,7 +686,7 @@ int getFirstRainfall(int j)
 
 ////  This function was re-written for release 5.0.019.  ////                  //(5.0.019 - LR)
 
-int getNextRainfall(int j)
+int readNextRainfall(int j)
 //
 //  Input:   j = rain gage index
 //  Output:  returns 1 if successful; 0 if not
@@ -542,10 +709,10 @@ int getNextRainfall(int j)
         {
             if ( Frain.file && Gage[j].currentFilePos < Gage[j].endFilePos )
             {
-                fseek(Frain.file, Gage[j].currentFilePos, SEEK_SET);
+                FSEEK64(Frain.file, Gage[j].currentFilePos, SEEK_SET);
                 fread(&Gage[j].nextDate, sizeof(DateTime), 1, Frain.file);
                 fread(&vNext, sizeof(float), 1, Frain.file);
-                Gage[j].currentFilePos = ftell(Frain.file);
+                Gage[j].currentFilePos = FTELL64(Frain.file);
                 rNext = convertRainfall(j, (double)vNext);
             }
             else return 0;                                                     //(5.0.020 - LR)
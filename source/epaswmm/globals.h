@@ -49,10 +49,15 @@ EXTERN int
                   LinkOffsets,              // Link offset convention          //(5.0.012 - LR)
                   AllowPonding,             // Allow water to pond at nodes
                   InertDamping,             // Degree of inertial damping
+                  DynWaveSolver,            // Dynamic wave solution method
+                  StepClasses,              // Number of dyn. wave step classes
                   NormalFlowLtd,            // Normal flow limited
                   SlopeWeighting,           // Use slope weighting
                   Compatibility,            // SWMM 5/3/4 compatibility
                   SkipSteadyState,          // Skip over steady state periods
+                  FastForwardDry,           // Take long steps in dry periods
+                  ImplicitPonding,          // Implicit ponded depth update
+                  InputCache,               // Save input file's lines to a cache
                   IgnoreRainfall,           // Ignore rainfall/runoff
                   IgnoreSnowmelt,           // Ignore snowmelt                 //(5.0.014 - LR)
                   IgnoreGwater,             // Ignore groundwater              //(5.0.014 - LR)
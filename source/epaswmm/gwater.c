@@ -28,35 +28,32 @@ enum   GWstates {THETA,                // moisture content of upper GW zone
                  LOWERDEPTH};          // depth of lower sat. GW zone
 
 //-----------------------------------------------------------------------------
-//  Shared variables
+//  Data Structures
 //-----------------------------------------------------------------------------
+//  State of the groundwater computation for a single subcatchment
+//  (created by each call to gwater_getGroundwater and passed to the ODE
+//  solver as its context, so subcatchments can be analyzed concurrently)
 //  NOTE: all flux rates are in ft/sec, all depths are in ft.
-static double    Infil;           // infiltration rate from surface
-static double    MaxEvap;         // max. evaporation rate
-static double    AvailEvap;       // available evaporation rate
-static double    UpperEvap;       // evaporation rate from upper GW zone
-static double    LowerEvap;       // evaporation rate from lower GW zone
-static double    UpperPerc;       // percolation rate from upper to lower zone
-static double    LowerLoss;       // loss rate from lower GW zone
-static double    GWFlow;          // flow rate from lower zone to conveyance node
-static double    MaxUpperPerc;    // upper limit on UpperPerc
-static double    MaxGWFlowPos;    // upper limit on GWFlow when its positve
-static double    MaxGWFlowNeg;    // upper limit on GWFlow when its negative
-static double    FracPerv;        // fraction of surface that is pervious
-static double    TotalDepth;      // total depth of GW aquifer
-
-////  ---- these variables are deprecated ----                                 //(5.0.014 - LR)
-//static double    NodeInvert;      // elev. of conveyance node invert
-//static double    NodeDepth;       // current water depth at conveyance node
-
-////  ---- these variables replace those listed above ----                     //(5.0.014 - LR)
-static double    Hstar;           // ht. from aquifer bottom to node invert
-static double    Hsw;             // ht. from aquifer bottom to water surface
-
-static TAquifer A;                // aquifer being analyzed
-static TGroundwater* GW;          // groundwater object being analyzed
-
-static double Tstep;
+typedef struct
+{
+    TAquifer*     a;              // aquifer being analyzed
+    TGroundwater* gw;             // groundwater object being analyzed
+    double        infil;          // infiltration rate from surface
+    double        maxEvap;        // max. evaporation rate
+    double        availEvap;      // available evaporation rate
+    double        upperEvap;      // evaporation rate from upper GW zone
+    double        lowerEvap;      // evaporation rate from lower GW zone
+    double        upperPerc;      // percolation rate from upper to lower zone
+    double        lowerLoss;      // loss rate from lower GW zone
+    double        gwFlow;         // flow from lower zone to conveyance node
+    double        maxUpperPerc;   // upper limit on upperPerc
+    double        maxGWFlowPos;   // upper limit on gwFlow when its positve
+    double        maxGWFlowNeg;   // upper limit on gwFlow when its negative
+    double        fracPerv;       // fraction of surface that is pervious
+    double        totalDepth;     // total depth of GW aquifer
+    double        hstar;          // ht. from aquifer bottom to node invert
+    double        hsw;            // ht. from aquifer bottom to water surface
+}  TGwState;
 
 //-----------------------------------------------------------------------------
 //  External Functions (declared in funcs.h)
@@ -71,13 +68,13 @@ static double Tstep;
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
-static void   getDxDt(double t, double* x, double* dxdt);
+static void   getDxDt(double t, double* x, double* dxdt, void* ctx);
 //static double getExcessInfil(double* x, double tStep);                       //(5.0.019 - LR)
-static void   getFluxes(double upperVolume, double lowerDepth);
-static void   getEvapRates(double theta, double upperDepth);
-static double getUpperPerc(double theta, double upperDepth);
-static double getGWFlow(double lowerDepth);
-static void   updateMassBal(double area,  double tStep);
+static void   getFluxes(TGwState* s, double theta, double lowerDepth);
+static void   getEvapRates(TGwState* s, double theta, double upperDepth);
+static double getUpperPerc(TGwState* s, double theta, double upperDepth);
+static double getGWFlow(TGwState* s, double lowerDepth);
+static void   updateMassBal(TGwState* s, double area,  double tStep);
 
 
 //=============================================================================
@@ -289,99 +286,101 @@ void gwater_getGroundwater(int j, double evap, double infil, double tStep)
 {
     int    n;                          // node exchanging groundwater
     double x[2];                       // upper moisture content & lower depth 
+    double work[ODE_WORKSIZE(2)];      // ODE solver workspace
     double vUpper;                     // upper vol. available for percolation
     double nodeFlow;                   // max. possible GW flow from node
     double area;                       // total subcatchment area
+    TGwState  state;                   // state of GW computation
+    TGwState* s = &state;
 
     // --- save subcatchment's groundwater and aquifer objects to 
-    //     shared variables
-    GW = Subcatch[j].groundwater;
-    if ( GW == NULL ) return;
-    A = Aquifer[GW->aquifer];
+    //     the state of the computation
+    s->gw = Subcatch[j].groundwater;
+    if ( s->gw == NULL ) return;
+    s->a = &Aquifer[s->gw->aquifer];
 
     // --- get fraction of total area that is pervious
-    FracPerv = subcatch_getFracPerv(j);
-    if ( FracPerv <= 0.0 ) return;
+    s->fracPerv = subcatch_getFracPerv(j);
+    if ( s->fracPerv <= 0.0 ) return;
     area = Subcatch[j].area;
 
     // --- convert evap & infil volumes to rates
-    evap = evap / (FracPerv*area) / tStep;                                     //(5.0.021 - LR)
-    infil = infil / (FracPerv*area) / tStep;                                   //(5.0.021 - LR)
-    Infil = infil;
-    Tstep = tStep;
+    evap = evap / (s->fracPerv*area) / tStep;                                  //(5.0.021 - LR)
+    infil = infil / (s->fracPerv*area) / tStep;                                //(5.0.021 - LR)
+    s->infil = infil;
 
-    // --- save max. and available evap rates to shared variables
-    MaxEvap = Evap.rate;
-    AvailEvap = MAX((MaxEvap - evap), 0.0);
+    // --- save max. and available evap rates
+    s->maxEvap = Evap.rate;
+    s->availEvap = MAX((s->maxEvap - evap), 0.0);
 
-    // --- save total depth & outlet node properties to shared variables
-    TotalDepth = GW->surfElev - A.bottomElev;
-    if ( TotalDepth <= 0.0 ) return;
-    n = GW->node;
+    // --- save total depth & outlet node properties
+    s->totalDepth = s->gw->surfElev - s->a->bottomElev;
+    if ( s->totalDepth <= 0.0 ) return;
+    n = s->gw->node;
 
     // --- override node's invert if value was provided in the GW object
-    if ( GW->nodeElev != MISSING )
-        Hstar = GW->nodeElev - A.bottomElev;
-    else Hstar = Node[n].invertElev - A.bottomElev;
+    if ( s->gw->nodeElev != MISSING )
+        s->hstar = s->gw->nodeElev - s->a->bottomElev;
+    else s->hstar = Node[n].invertElev - s->a->bottomElev;
     
-    if ( GW->fixedDepth > 0.0 )
-        Hsw = GW->fixedDepth + Node[n].invertElev - A.bottomElev;
-    else Hsw = Node[n].newDepth + Node[n].invertElev - A.bottomElev;
+    if ( s->gw->fixedDepth > 0.0 )
+        s->hsw = s->gw->fixedDepth + Node[n].invertElev - s->a->bottomElev;
+    else s->hsw = Node[n].newDepth + Node[n].invertElev - s->a->bottomElev;
 
     // --- store state variables in work vector x
-    x[THETA] = GW->theta;
-    x[LOWERDEPTH] = GW->lowerDepth;
+    x[THETA] = s->gw->theta;
+    x[LOWERDEPTH] = s->gw->lowerDepth;
 
     // --- set limits on upper perc
-    vUpper = (TotalDepth - x[LOWERDEPTH]) * (x[THETA] - A.fieldCapacity);
+    vUpper = (s->totalDepth - x[LOWERDEPTH]) *
+             (x[THETA] - s->a->fieldCapacity);
     vUpper = MAX(0.0, vUpper); 
-    MaxUpperPerc = vUpper / tStep;
+    s->maxUpperPerc = vUpper / tStep;
 
     // --- set limit on GW flow out of aquifer based on volume of lower zone
-    MaxGWFlowPos = x[LOWERDEPTH]*A.porosity / tStep;
+    s->maxGWFlowPos = x[LOWERDEPTH]*s->a->porosity / tStep;
 
     // --- set limit on GW flow into aquifer from drainage system node
     //     based on min. of capacity of upper zone and drainage system
     //     inflow to the node
-    MaxGWFlowNeg = (TotalDepth - x[LOWERDEPTH]) * (A.porosity - x[THETA])
-                   / tStep;
+    s->maxGWFlowNeg = (s->totalDepth - x[LOWERDEPTH]) *
+                      (s->a->porosity - x[THETA]) / tStep;
     nodeFlow = (Node[n].inflow + Node[n].newVolume/tStep) / area;
-    MaxGWFlowNeg = -MIN(MaxGWFlowNeg, nodeFlow);
+    s->maxGWFlowNeg = -MIN(s->maxGWFlowNeg, nodeFlow);
     
     // --- integrate eqns. for d(Theta)/dt and d(LowerDepth)/dt
-    //     NOTE: ODE solver must have been initialized previously
-    odesolve_integrate(x, 2, 0, tStep, GWTOL, tStep, getDxDt);
+    odesolve_integrate(x, 2, 0, tStep, GWTOL, tStep, getDxDt, s, work);
     
     // --- keep state variables within allowable bounds
-    x[THETA] = MAX(x[THETA], A.wiltingPoint);
-    if ( x[THETA] >= A.porosity )
+    x[THETA] = MAX(x[THETA], s->a->wiltingPoint);
+    if ( x[THETA] >= s->a->porosity )
     {
-        x[THETA] = A.porosity - XTOL;
+        x[THETA] = s->a->porosity - XTOL;
     }
     x[LOWERDEPTH] = MAX(x[LOWERDEPTH],  0.0);
-    if ( x[LOWERDEPTH] >= TotalDepth )
+    if ( x[LOWERDEPTH] >= s->totalDepth )
     {
-        x[LOWERDEPTH] = TotalDepth - XTOL;
+        x[LOWERDEPTH] = s->totalDepth - XTOL;
     }
 
     // --- save new state values
-    GW->theta = x[THETA];
-    GW->lowerDepth  = x[LOWERDEPTH];
-    getFluxes(GW->theta, GW->lowerDepth);
-    GW->oldFlow = GW->newFlow;
-    GW->newFlow = GWFlow;
+    s->gw->theta = x[THETA];
+    s->gw->lowerDepth  = x[LOWERDEPTH];
+    getFluxes(s, s->gw->theta, s->gw->lowerDepth);
+    s->gw->oldFlow = s->gw->newFlow;
+    s->gw->newFlow = s->gwFlow;
 
     //--- get limit on infiltration into upper zone
-    GW->maxInfilVol = (TotalDepth - x[LOWERDEPTH])*
-                      (A.porosity - x[THETA])/ FracPerv;
+    s->gw->maxInfilVol = (s->totalDepth - x[LOWERDEPTH])*
+                         (s->a->porosity - x[THETA])/ s->fracPerv;
 
     // --- update mass balance
-    updateMassBal(area, tStep);
+    updateMassBal(s, area, tStep);
 }
 
 //=============================================================================
 
-void updateMassBal(double area, double tStep)
+void updateMassBal(TGwState* s, double area, double tStep)
 //
 //  Input:   area  = subcatchment area (ft2)
 //           tStep = time step (sec)
@@ -396,18 +395,18 @@ void updateMassBal(double area, double tStep)
     double vGwater;                    // volume of exchanged groundwater
     double ft2sec = area * tStep;
 
-    vInfil     = Infil * FracPerv * ft2sec;
-    vUpperEvap = UpperEvap * FracPerv * ft2sec;
-    vLowerEvap = LowerEvap * FracPerv * ft2sec;
-    vLowerPerc = LowerLoss * ft2sec;
-    vGwater    = 0.5 * (GW->oldFlow + GW->newFlow) * ft2sec;
+    vInfil     = s->infil * s->fracPerv * ft2sec;
+    vUpperEvap = s->upperEvap * s->fracPerv * ft2sec;
+    vLowerEvap = s->lowerEvap * s->fracPerv * ft2sec;
+    vLowerPerc = s->lowerLoss * ft2sec;
+    vGwater    = 0.5 * (s->gw->oldFlow + s->gw->newFlow) * ft2sec;
     massbal_updateGwaterTotals(vInfil, vUpperEvap, vLowerEvap, vLowerPerc,
                                vGwater);
 }
 
 //=============================================================================
 
-void  getFluxes(double theta, double lowerDepth)
+void  getFluxes(TGwState* s, double theta, double lowerDepth)
 //
 //  Input:   upperVolume = vol. depth of upper zone (ft)
 //           upperDepth  = depth of upper zone (ft)
@@ -419,52 +418,55 @@ void  getFluxes(double theta, double lowerDepth)
 
     // --- find upper zone depth
     lowerDepth = MAX(lowerDepth, 0.0);
-    lowerDepth = MIN(lowerDepth, TotalDepth);
-    upperDepth = TotalDepth - lowerDepth;
+    lowerDepth = MIN(lowerDepth, s->totalDepth);
+    upperDepth = s->totalDepth - lowerDepth;
 
     // --- find evaporation from both zones
-    getEvapRates(theta, upperDepth);
+    getEvapRates(s, theta, upperDepth);
 
     // --- find percolation rate at upper & lower zone boundaries
-    UpperPerc = getUpperPerc(theta, upperDepth);
-    UpperPerc = MIN(UpperPerc, MaxUpperPerc);
+    s->upperPerc = getUpperPerc(s, theta, upperDepth);
+    s->upperPerc = MIN(s->upperPerc, s->maxUpperPerc);
 
     // --- find losses to deep GW
-    LowerLoss = A.lowerLossCoeff * lowerDepth / TotalDepth;
+    s->lowerLoss = s->a->lowerLossCoeff * lowerDepth / s->totalDepth;
 
     // --- find GW flow from lower zone to conveyance system node
-    GWFlow = getGWFlow(lowerDepth);
-    if ( GWFlow >= 0.0 ) GWFlow = MIN(GWFlow, MaxGWFlowPos);
-    else GWFlow = MAX(GWFlow, MaxGWFlowNeg);
+    s->gwFlow = getGWFlow(s, lowerDepth);
+    if ( s->gwFlow >= 0.0 ) s->gwFlow = MIN(s->gwFlow, s->maxGWFlowPos);
+    else s->gwFlow = MAX(s->gwFlow, s->maxGWFlowNeg);
 }
 
 //=============================================================================
 
-void  getDxDt(double t, double* x, double* dxdt)
+void  getDxDt(double t, double* x, double* dxdt, void* ctx)
 //
 //  Input:   t    = current time (not used)
 //           x    = array of state variables
+//           ctx  = state of the GW computation
 //  Output:  dxdt = array of time derivatives of state variables
 //  Purpose: computes time derivatives of upper moisture content 
 //           and lower depth.
 //
 {
+    TGwState* s = (TGwState *)ctx;
     double qUpper, qLower;
     double denom;                                                              //(5.0.022 - LR)
 
-    getFluxes(x[THETA], x[LOWERDEPTH]);
-    qUpper = (Infil - UpperEvap)*FracPerv - UpperPerc;
-    qLower = UpperPerc - LowerLoss - (LowerEvap*FracPerv) - GWFlow;
+    getFluxes(s, x[THETA], x[LOWERDEPTH]);
+    qUpper = (s->infil - s->upperEvap)*s->fracPerv - s->upperPerc;
+    qLower = s->upperPerc - s->lowerLoss - (s->lowerEvap*s->fracPerv) -
+             s->gwFlow;
 
 ////  Deprecated (as of release 5.0.014)  ////
 ////  Restored (as of release 5.0.019)  ////
 ////  Modified to prevent illegal values (release 5.0.022)  ////               //(5.0.022 - LR)
-    denom = TotalDepth - x[LOWERDEPTH];
+    denom = s->totalDepth - x[LOWERDEPTH];
     if (denom > 0.0)
         dxdt[THETA] = qUpper / denom;
     else
         dxdt[THETA] = 0.0;
-    denom = A.porosity - x[THETA];
+    denom = s->a->porosity - x[THETA];
     if (denom > 0.0)
         dxdt[LOWERDEPTH] = qLower / denom;
     else
@@ -473,7 +475,7 @@ void  getDxDt(double t, double* x, double* dxdt)
 
 //=============================================================================
 
-void getEvapRates(double theta, double upperDepth)
+void getEvapRates(TGwState* s, double theta, double upperDepth)
 //
 //  Input:   theta      = moisture content of upper zone
 //           upperDepth = depth of upper zone (ft)
@@ -482,20 +484,20 @@ void getEvapRates(double theta, double upperDepth)
 //
 {
     double lowerFrac;
-    UpperEvap = A.upperEvapFrac * MaxEvap;
-    if ( theta <= A.wiltingPoint || Infil > 0.0 ) UpperEvap = 0.0;
+    s->upperEvap = s->a->upperEvapFrac * s->maxEvap;
+    if ( theta <= s->a->wiltingPoint || s->infil > 0.0 ) s->upperEvap = 0.0;
     else 
     {
-        UpperEvap = MIN(UpperEvap, AvailEvap);
+        s->upperEvap = MIN(s->upperEvap, s->availEvap);
     }
-    if ( A.lowerEvapDepth == 0.0 ) LowerEvap = 0.0;
+    if ( s->a->lowerEvapDepth == 0.0 ) s->lowerEvap = 0.0;
     else
     {
-        lowerFrac = (A.lowerEvapDepth - upperDepth) / A.lowerEvapDepth;
+        lowerFrac = (s->a->lowerEvapDepth - upperDepth) / s->a->lowerEvapDepth;
         lowerFrac = MAX(0.0, lowerFrac);
         
         lowerFrac = MIN(lowerFrac, 1.0);
-        LowerEvap = lowerFrac * (AvailEvap - UpperEvap);
+        s->lowerEvap = lowerFrac * (s->availEvap - s->upperEvap);
 
         //LowerEvap = (1.0 - A.upperEvapFrac) * MaxEvap * lowerFrac;
         //LowerEvap = MIN(LowerEvap, (AvailEvap - UpperEvap));
@@ -505,7 +507,7 @@ void getEvapRates(double theta, double upperDepth)
 
 //=============================================================================
 
-double getUpperPerc(double theta, double upperDepth)
+double getUpperPerc(TGwState* s, double theta, double upperDepth)
 //
 //  Input:   theta      = moisture content of upper zone
 //           upperDepth = depth of upper zone (ft)
@@ -518,15 +520,15 @@ double getUpperPerc(double theta, double upperDepth)
     double hydcon;                      // unsaturated hydraulic conductivity
 
     // --- no perc. from upper zone if no depth or moisture content too low    
-    if ( upperDepth <= 0.0 || theta <= A.fieldCapacity ) return 0.0;
+    if ( upperDepth <= 0.0 || theta <= s->a->fieldCapacity ) return 0.0;
 
     // --- compute hyd. conductivity as function of moisture content
-    delta = theta - A.porosity;
-    hydcon = A.conductivity * exp(delta * A.conductSlope);
+    delta = theta - s->a->porosity;
+    hydcon = s->a->conductivity * exp(delta * s->a->conductSlope);
 
     // --- compute integral of dh/dz term
-    delta = theta - A.fieldCapacity;
-    dhdz = 1.0 + A.tensionSlope * 2.0 * delta / upperDepth;
+    delta = theta - s->a->fieldCapacity;
+    dhdz = 1.0 + s->a->tensionSlope * 2.0 * delta / upperDepth;
 
     // --- compute upper zone percolation rate
     return hydcon * dhdz;
@@ -534,7 +536,7 @@ double getUpperPerc(double theta, double upperDepth)
 
 //=============================================================================
 
-double getGWFlow(double lowerDepth)
+double getGWFlow(TGwState* s, double lowerDepth)
 
 ////   ---- this function was entirely re-written ----                         //(5.0.014 - LR)
 
@@ -547,24 +549,24 @@ double getGWFlow(double lowerDepth)
     double q, t1, t2, t3;
 
     // --- water table must be above Hstar for flow to occur
-    if ( lowerDepth <= Hstar ) return 0.0;
+    if ( lowerDepth <= s->hstar ) return 0.0;
 
     // --- compute groundwater component of flow
-    if ( GW->b1 == 0.0 ) t1 = GW->a1;
-    else t1 = GW->a1 * pow( (lowerDepth - Hstar)*UCF(LENGTH), GW->b1);
+    if ( s->gw->b1 == 0.0 ) t1 = s->gw->a1;
+    else t1 = s->gw->a1 * pow( (lowerDepth - s->hstar)*UCF(LENGTH), s->gw->b1);
 
     // --- compute surface water component of flow
-    if ( GW->b2 == 0.0 ) t2 = GW->a2;
-    else if (Hsw > Hstar)                                                      //(5.0.022 - LR) 
-        t2 = GW->a2 * pow( (Hsw - Hstar)*UCF(LENGTH), GW->b2);                 //(5.0.022 - LR)
+    if ( s->gw->b2 == 0.0 ) t2 = s->gw->a2;
+    else if (s->hsw > s->hstar)                                                //(5.0.022 - LR) 
+        t2 = s->gw->a2 * pow( (s->hsw - s->hstar)*UCF(LENGTH), s->gw->b2);     //(5.0.022 - LR)
     else t2 = 0.0;                                                             //(5.0.022 - LR)
 
     // --- compute groundwater/surface water interaction term
-    t3 = GW->a3 * lowerDepth * Hsw * UCF(LENGTH) * UCF(LENGTH);
+    t3 = s->gw->a3 * lowerDepth * s->hsw * UCF(LENGTH) * UCF(LENGTH);
 
     // --- compute total groundwater flow
     q = (t1 - t2 + t3) / UCF(GWFLOW); 
-    if ( q < 0.0 && GW->a3 != 0.0 ) q = 0.0;
+    if ( q < 0.0 && s->gw->a3 != 0.0 ) q = 0.0;
     return q;
 }
 
@@ -38,6 +38,15 @@ THorton*   HortInfil = NULL;                                                   /
 TGrnAmpt*  GAInfil   = NULL;                                                   //(5.0.019 - LR)
 TCurveNum* CNInfil   = NULL;                                                   //(5.0.019 - LR)
 
+// --- infiltration rates of the pervious areas of all subcatchments are
+//     found together, one method-specific pass per time step, from inputs
+//     gathered into the following arrays
+static int*    BatchArea;         // subcatchment index of each batch entry
+static double* BatchIrate;        // rainfall rate on each entry (ft/sec)
+static double* BatchRunon;        // runon rate to each entry (ft/sec)
+static double* BatchDepth;        // ponded depth on each entry (ft)
+static double* InfilRate;         // infil. rate of each subcatchment (ft/sec)
+
 //-----------------------------------------------------------------------------
 //  External Functions (declared in infil.h)                                   //(5.0.019 - LR)
 //-----------------------------------------------------------------------------
@@ -45,7 +54,9 @@ TCurveNum* CNInfil   = NULL;                                                   /
 //  infil_delete     (called by deleteObjects in project.c)                    //(5.0.019 - LR)
 //  infil_readParams (called by input_readLine)
 //  infil_initState  (called by subcatch_initState)
-//  infil_getInfil   (called by getSubareaRunoff in subcatch.c)
+//  infil_getInfil   (called by findNativeInfil in lid.c)
+//  infil_setRates   (called by runoff_execute)
+//  infil_getRate    (called by getSubareaInfil in subcatch.c)
 
 //  Called locally and by storage node methods in node.c
 //  grnampt_setParams
@@ -98,6 +109,15 @@ void infil_create(int subcatchCount, int model)
         break;
     default: ErrorCode = ERR_MEMORY;
     }
+
+    // --- create arrays used to find infil. rates of all subcatchments
+    BatchArea  = (int *) calloc(subcatchCount, sizeof(int));
+    BatchIrate = (double *) calloc(subcatchCount, sizeof(double));
+    BatchRunon = (double *) calloc(subcatchCount, sizeof(double));
+    BatchDepth = (double *) calloc(subcatchCount, sizeof(double));
+    InfilRate  = (double *) calloc(subcatchCount, sizeof(double));
+    if ( BatchArea == NULL || BatchIrate == NULL || BatchRunon == NULL ||
+         BatchDepth == NULL || InfilRate == NULL ) ErrorCode = ERR_MEMORY;
 }
 
 //=============================================================================
@@ -114,6 +134,11 @@ void infil_delete()
     FREE(HortInfil);
     FREE(GAInfil);
     FREE(CNInfil);
+    FREE(BatchArea);
+    FREE(BatchIrate);
+    FREE(BatchRunon);
+    FREE(BatchDepth);
+    FREE(InfilRate);
 }
 
 //=============================================================================
@@ -226,6 +251,88 @@ double infil_getInfil(int j, int m, double tstep, double rainfall,
 
 //=============================================================================
 
+void infil_setRates(int m, double tstep)
+//
+//  Input:   m = infiltration method code
+//           tstep = runoff time step (sec)
+//  Output:  none
+//  Purpose: computes the infiltration rate of the pervious area of every
+//           subcatchment at the current time step.
+//
+//  Note:    must be called after subcatch_getRunon has been applied to all
+//           subcatchments and before any subcatch_getRunoff call. Inputs are
+//           the same ones getSubareaInfil would use so results are identical
+//           to calling infil_getInfil one subcatchment at a time.
+{
+    int    j, k, n;
+    double r, s;
+
+    // --- gather inputs for all subcatchments with a non-LID pervious area
+    n = 0;
+    for (j = 0; j < Nobjects[SUBCATCH]; j++)
+    {
+        InfilRate[j] = 0.0;
+        if ( Subcatch[j].subArea[PERV].fArea == 0.0 ) continue;
+        if ( (Subcatch[j].area - Subcatch[j].lidArea) *
+              Subcatch[j].subArea[PERV].fArea <= 0.0 ) continue;
+        r = 0.0;
+        s = 0.0;
+        if ( Subcatch[j].gage >= 0 ) gage_getPrecip(Subcatch[j].gage, &r, &s);
+        BatchArea[n]  = j;
+        BatchIrate[n] = r + s;
+        BatchRunon[n] = Subcatch[j].subArea[PERV].inflow;
+        BatchDepth[n] = Subcatch[j].subArea[PERV].depth;
+        n++;
+    }
+
+    // --- make a single pass through the batch for the method being used
+    //     (each entry updates only its own subcatchment's infil. object)
+    switch (m)
+    {
+      case HORTON:
+        #pragma omp parallel for schedule(static) if(n > 1)
+        for (k = 0; k < n; k++)
+        {
+            InfilRate[BatchArea[k]] = horton_getInfil(&HortInfil[BatchArea[k]],
+                tstep, BatchIrate[k] + BatchRunon[k], BatchDepth[k]);
+        }
+        break;
+
+      case GREEN_AMPT:
+        #pragma omp parallel for schedule(static) if(n > 1)
+        for (k = 0; k < n; k++)
+        {
+            InfilRate[BatchArea[k]] = grnampt_getInfil(&GAInfil[BatchArea[k]],
+                tstep, BatchIrate[k] + BatchRunon[k], BatchDepth[k]);
+        }
+        break;
+
+      case CURVE_NUMBER:
+        #pragma omp parallel for schedule(static) if(n > 1)
+        for (k = 0; k < n; k++)
+        {
+            InfilRate[BatchArea[k]] = curvenum_getInfil(&CNInfil[BatchArea[k]],
+                tstep, BatchIrate[k], BatchDepth[k] + BatchRunon[k] / tstep);
+        }
+        break;
+    }
+}
+
+//=============================================================================
+
+double infil_getRate(int j)
+//
+//  Input:   j = subcatchment index
+//  Output:  returns infiltration rate (ft/sec)
+//  Purpose: retrieves the infiltration rate found for a subcatchment's
+//           pervious area by infil_setRates.
+//
+{
+    return InfilRate[j];
+}
+
+//=============================================================================
+
 int horton_setParams(THorton *infil, double p[])
 //
 //  Input:   infil = ptr. to Horton infiltration object
@@ -89,6 +89,8 @@ int     infil_readParams(int model, char* tok[], int ntoks);
 void    infil_initState(int area, int model);
 double  infil_getInfil(int area, int model, double tstep, double rainfall,
         double runon, double depth);                                           //(5.0.022 - LR)
+void    infil_setRates(int model, double tstep);
+double  infil_getRate(int area);
 
 int     grnampt_setParams(TGrnAmpt *infil, double p[]);
 void    grnampt_initState(TGrnAmpt *infil);
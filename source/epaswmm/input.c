@@ -32,6 +32,35 @@ static int  Mobjects[MAX_OBJ_TYPES];   // Working number of objects of each type
 static int  Mnodes[MAX_NODE_TYPES];    // Working number of node objects
 static int  Mlinks[MAX_LINK_TYPES];    // Working number of link objects
 
+//-----------------------------------------------------------------------------
+//  Input cache
+//-----------------------------------------------------------------------------
+typedef struct                         // Identifies data in an input cache
+{                                      // ---------------------------------
+   FilePos    fileSize;                // size of input file (bytes)
+   unsigned long long fileHash;        // hash of input file's contents
+   int        maxLine;                 // max. characters per input line
+   int        maxToks;                 // max. tokens per input line
+}  TInpCacheKey;
+
+typedef struct                         // Heading of a cached input line
+{                                      // ------------------------------
+   long       lineCount;               // line number in input file
+   int        lineSize;                // bytes in text of line
+   int        tokSize;                 // bytes in line's tokens
+   int        nTokens;                 // number of tokens on line
+}  TInpCacheLine;
+
+static int    UseCache;                // true if reading from input cache
+static int    SaveCache;               // true if saving to input cache
+static char*  CacheData;               // cached lines of input
+static size_t CacheSize;               // bytes of cached lines
+static size_t CacheCapacity;           // bytes allocated for cached lines
+static size_t CachePos;                // position of next cached line
+static TInpCacheLine CacheLine;        // heading of current cached line
+static char   CacheName[MAXFNAME+1];   // name of input cache file
+static TInpCacheKey CacheKey;          // identifies data in input cache
+
 //-----------------------------------------------------------------------------
 //  External Functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
@@ -50,6 +79,12 @@ static int  readTitle(char* line);
 static int  readControl(char* tok[], int ntoks);
 static int  readNode(int type);
 static int  readLink(int type);
+static int  readNextLine(char* line, long* lineCount);
+static int  getCachedTokens(char* s);
+static void addCachedLine(char* line, long lineCount);
+static int  getCacheKey(void);
+static int  readCacheFile(void);
+static void saveCacheFile(void);
 
 
 //=============================================================================
@@ -60,6 +95,16 @@ int input_countObjects()
 //  Output:  returns error code
 //  Purpose: reads input file to determine number of system objects.
 //
+//  Note: the input file's lines of data, along with the tokens parsed
+//        from them, are cached in a binary file placed next to the input
+//        file (named after it with a ".icc" extension) once the file has
+//        been read without error, unless the INPUT_CACHE option is NO.
+//        While the input file's contents stay the same (judged by its size
+//        and a 64-bit hash of its bytes) and the cache's checksum matches,
+//        its lines are read from the cache instead, skipping blank and
+//        comment lines and the parsing of tokens. (A file that sets
+//        INPUT_CACHE to NO never has a cache saved for it.)
+//
 {
     char  line[MAXLINE+1];             // line from input data file     
     char  wLine[MAXLINE+1];            // working copy of input line   
@@ -77,11 +122,19 @@ int input_countObjects()
     for (i = 0; i < MAX_NODE_TYPES; i++) Nnodes[i] = 0;
     for (i = 0; i < MAX_LINK_TYPES; i++) Nlinks[i] = 0;
 
+    // --- see if the input file's lines can be read from a cache file
+    CacheData = NULL;
+    CacheSize = 0;
+    CacheCapacity = 0;
+    SaveCache = getCacheKey();
+    UseCache = SaveCache && readCacheFile();
+    if ( UseCache ) SaveCache = FALSE;
+
     // --- make pass through data file counting number of each object
-    while ( fgets(line, MAXLINE, Finp.file) != NULL )
+    CachePos = 0;
+    while ( readNextLine(line, &lineCount) )
     {
         // --- skip blank lines & those beginning with a comment
-        lineCount++;
         strcpy(wLine, line);           // make working copy of line
         tok = strtok(wLine, SEPSTR);   // get first text token on line
         if ( tok == NULL ) continue;
@@ -144,7 +197,11 @@ int input_readData()
     // --- initialize working item count arrays
     //     (final counts in Mobjects, Mnodes & Mlinks should
     //      match those in Nobjects, Nnodes and Nlinks).
-    if ( ErrorCode ) return ErrorCode;
+    if ( ErrorCode )
+    {
+        FREE(CacheData);
+        return ErrorCode;
+    }
     error_setInpError(0, "");
     for (i = 0; i < MAX_OBJ_TYPES; i++)  Mobjects[i] = 0;
     for (i = 0; i < MAX_NODE_TYPES; i++) Mnodes[i] = 0;
@@ -160,16 +217,22 @@ int input_readData()
     sect = 0;
     errsum = 0;
     rewind(Finp.file);
-    while ( fgets(line, MAXLINE, Finp.file) != NULL )
+    CachePos = 0;
+    while ( readNextLine(line, &lineCount) )
     {
         // --- make copy of line and scan for tokens
-        lineCount++;
-        strcpy(wLine, line);
-        Ntokens = getTokens(wLine);
+        //     (or retrieve them from the input cache)
+        if ( UseCache ) Ntokens = getCachedTokens(wLine);
+        else
+        {
+            strcpy(wLine, line);
+            Ntokens = getTokens(wLine);
+        }
 
         // --- skip blank lines and comments
         if ( Ntokens == 0 ) continue;
         if ( *Tok[0] == ';' ) continue;
+        if ( SaveCache ) addCachedLine(line, lineCount);
 
         // --- check if max. line length exceeded
         lineLength = strlen(line);
@@ -227,6 +290,10 @@ int input_readData()
         if (errsum > MAXERRS) break;
     }   /* End of while */
 
+    // --- save the lines read to the input cache
+    if ( errsum == 0 && SaveCache && InputCache ) saveCacheFile();
+    FREE(CacheData);
+
     // --- check for errors
     if (errsum > 0)  ErrorCode = ERR_INPUT;
     return ErrorCode;
@@ -841,3 +908,240 @@ int  getTokens(char *s)
 }
 
 //=============================================================================
+
+int  readNextLine(char* line, long* lineCount)
+//
+//  Input:   line = buffer of MAXLINE+1 characters
+//           lineCount = number of lines read so far
+//  Output:  line = next line of input;
+//           lineCount = updated line count;
+//           returns 1 if a line was read, 0 if at end of input
+//  Purpose: reads the next line of input, either from the input file or,
+//           skipping over blank & comment lines, from the input cache.
+//
+{
+    if ( UseCache )
+    {
+        if ( CachePos >= CacheSize ) return 0;
+        memcpy(&CacheLine, CacheData + CachePos, sizeof(TInpCacheLine));
+        CachePos += sizeof(TInpCacheLine);
+        memcpy(line, CacheData + CachePos, CacheLine.lineSize);
+        CachePos += CacheLine.lineSize + CacheLine.tokSize;
+        *lineCount = CacheLine.lineCount;
+        return 1;
+    }
+    if ( fgets(line, MAXLINE, Finp.file) == NULL ) return 0;
+    (*lineCount)++;
+    return 1;
+}
+
+//=============================================================================
+
+int  getCachedTokens(char* s)
+//
+//  Input:   s = buffer of MAXLINE+1 characters
+//  Output:  returns number of tokens retrieved
+//  Purpose: copies the tokens of the line last read from the input cache
+//           into s, saving pointers to them in shared variable Tok[].
+//
+{
+    int  n;
+
+    // --- copy the line's tokens into s
+    memcpy(s, CacheData + CachePos - CacheLine.tokSize, CacheLine.tokSize);
+
+    // --- point to each token
+    for (n = 0; n < MAXTOKS; n++) Tok[n] = NULL;
+    for (n = 0; n < CacheLine.nTokens; n++)
+    {
+        Tok[n] = s;
+        s += strlen(s) + 1;
+    }
+    return CacheLine.nTokens;
+}
+
+//=============================================================================
+
+void addCachedLine(char* line, long lineCount)
+//
+//  Input:   line = line of input
+//           lineCount = line number in input file
+//  Output:  none
+//  Purpose: adds a line of input and its tokens to the input cache.
+//
+{
+    int    n;
+    size_t size;
+    char*  newData;
+    char*  c;
+    TInpCacheLine cacheLine;
+
+    // --- find size of the line and its tokens
+    cacheLine.lineCount = lineCount;
+    cacheLine.lineSize = strlen(line) + 1;
+    cacheLine.tokSize = 0;
+    cacheLine.nTokens = Ntokens;
+    for (n = 0; n < Ntokens; n++) cacheLine.tokSize += strlen(Tok[n]) + 1;
+    size = sizeof(TInpCacheLine) + cacheLine.lineSize + cacheLine.tokSize;
+
+    // --- enlarge the cache if need be
+    //     (the input cache is simply not used if memory runs short)
+    if ( CacheSize + size > CacheCapacity )
+    {
+        CacheCapacity = 2 * CacheCapacity + size + 65536;
+        newData = (char *) realloc(CacheData, CacheCapacity);
+        if ( newData == NULL )
+        {
+            FREE(CacheData);
+            CacheSize = 0;
+            CacheCapacity = 0;
+            SaveCache = FALSE;
+            return;
+        }
+        CacheData = newData;
+    }
+
+    // --- append the line and its tokens
+    c = CacheData + CacheSize;
+    memcpy(c, &cacheLine, sizeof(TInpCacheLine));
+    c += sizeof(TInpCacheLine);
+    memcpy(c, line, cacheLine.lineSize);
+    c += cacheLine.lineSize;
+    for (n = 0; n < Ntokens; n++)
+    {
+        strcpy(c, Tok[n]);
+        c += strlen(Tok[n]) + 1;
+    }
+    CacheSize += size;
+}
+
+//=============================================================================
+
+int getCacheKey()
+//
+//  Input:   none
+//  Output:  returns 1 if an input cache file can be used, 0 if not
+//  Purpose: identifies the cache file that holds the input file's lines.
+//
+//  Note: the key holds a 64-bit FNV-1a hash of the input file's bytes, so
+//        that an edit which keeps the file's size and time stamp cannot
+//        reuse a stale cache.
+//
+{
+    char   buf[4096];
+    size_t n;
+    unsigned long long hash = 0;
+    FilePos size = 0;
+
+    if ( snprintf(CacheName, sizeof(CacheName), "%s.icc", Finp.name) >=
+         (int)sizeof(CacheName) ) return 0;
+
+    // --- hash the contents of the input file
+    rewind(Finp.file);
+    while ( (n = fread(buf, 1, sizeof(buf), Finp.file)) > 0 )
+    {
+        hash = hashBytes(buf, n, hash);
+        size += n;
+    }
+    if ( ferror(Finp.file) ) return 0;
+    rewind(Finp.file);
+
+    memset(&CacheKey, 0, sizeof(TInpCacheKey));
+    CacheKey.fileSize = size;
+    CacheKey.fileHash = hash;
+    CacheKey.maxLine  = MAXLINE;
+    CacheKey.maxToks  = MAXTOKS;
+    return 1;
+}
+
+//=============================================================================
+
+int readCacheFile()
+//
+//  Input:   none
+//  Output:  returns 1 if input lines were read from the cache file, 0 if not
+//  Purpose: reads the input file's lines from its cache file.
+//
+{
+    FILE*   f;
+    char    fileStamp[] = "SWMM5-INPCACHE";
+    char    fStamp[] = "SWMM5-INPCACHE";
+    FilePos size = -1;
+    unsigned long long checksum = 0;
+    TInpCacheKey fileKey;
+
+    // --- check that cache file holds data with the same key
+    if ( (f = fopen(CacheName, "rb")) == NULL ) return 0;
+    memset(&fileKey, 0, sizeof(TInpCacheKey));
+    fread(fStamp, sizeof(char), strlen(fileStamp), f);
+    fread(&fileKey, sizeof(TInpCacheKey), 1, f);
+    fread(&size, sizeof(FilePos), 1, f);
+    if ( strcmp(fStamp, fileStamp) != 0 ||
+         memcmp(&fileKey, &CacheKey, sizeof(TInpCacheKey)) != 0 ||
+         size <= 0 )
+    {
+        fclose(f);
+        return 0;
+    }
+
+    // --- read the cached lines & check that they match the checksum
+    //     saved after them
+    CacheData = (char *) malloc((size_t)size);
+    if ( CacheData == NULL ||
+         fread(CacheData, 1, (size_t)size, f) < (size_t)size ||
+         fread(&checksum, sizeof(checksum), 1, f) < 1 ||
+         checksum != hashBytes(CacheData, (size_t)size, 0) )
+    {
+        FREE(CacheData);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+    CacheSize = (size_t)size;
+    CacheCapacity = CacheSize;
+    return 1;
+}
+
+//=============================================================================
+
+void saveCacheFile()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves the input file's lines to its cache file.
+//
+//  Note: failure to save a cache file is not an error; the input
+//        file will simply be read again next time. The file is written
+//        under a unique temporary name and then renamed, so that a partly
+//        written cache file is never read and concurrent runs saving the
+//        same cache do not write into each other's file.
+//
+{
+    FILE*   f;
+    char    fileStamp[] = "SWMM5-INPCACHE";
+    char    tmpName[MAXFNAME+1];
+    FilePos size = (FilePos)CacheSize;
+    unsigned long long checksum = hashBytes(CacheData, CacheSize, 0);
+    int     ok;
+
+    if ( (f = openTmpFile(CacheName, tmpName)) == NULL ) return;
+    fwrite(fileStamp, sizeof(char), strlen(fileStamp), f);
+    fwrite(&CacheKey, sizeof(TInpCacheKey), 1, f);
+    fwrite(&size, sizeof(FilePos), 1, f);
+    ok = ( fwrite(CacheData, 1, CacheSize, f) == CacheSize );
+    if ( fwrite(&checksum, sizeof(checksum), 1, f) < 1 ) ok = FALSE;
+    if ( fclose(f) != 0 ) ok = FALSE;
+    if ( !ok )
+    {
+        remove(tmpName);
+        return;
+    }
+
+    // --- replace any existing cache file (rename() fails on Windows
+    //     if the new name already exists)
+    if ( rename(tmpName, CacheName) != 0 )
+    {
+        remove(CacheName);
+        if ( rename(tmpName, CacheName) != 0 ) remove(tmpName);
+    }
+}
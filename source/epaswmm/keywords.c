@@ -78,9 +78,12 @@ char* OptionWords[]        = { w_FLOW_UNITS,        w_INFIL_MODEL,
                                w_LINK_OFFSETS,      w_MIN_SLOPE,               //(5.0.014 - LR)
                                w_IGNORE_SNOWMELT,   w_IGNORE_GWATER,           //(5.0.014 - LR)
                                w_IGNORE_ROUTING,    w_IGNORE_QUALITY,          //(5.0.014 - LR)
-                               NULL};                                          //(5.0.014 - LR)
+                               w_DYNWAVE_SOLVER,    w_STEP_CLASSES,
+                               w_FAST_FORWARD_DRY,  w_IMPLICIT_PONDING,
+                               w_INPUT_CACHE,       NULL};
 char* FlowUnitWords[]      = { w_CFS, w_GPM, w_MGD, w_CMS, w_LPS, w_MLD, NULL};
 char* ForceMainEqnWords[]  = { w_H_W, w_D_W, NULL};                            //(5.0.010 - LR)
+char* DynWaveSolverWords[] = { w_PICARD, w_NEWTON, NULL};
 char* LinkOffsetWords[]    = { w_DEPTH, w_ELEVATION, NULL};                    //(5.0.012 - LR)
 char* OldRouteModelWords[] = { w_NONE, w_NF, w_KW, w_EKW, w_DW, NULL};         //(5.0.010 - LR)
 char* RouteModelWords[]    = { w_NONE, w_STEADY, w_KINWAVE, w_XKINWAVE,        //(5.0.010 - LR)
@@ -48,6 +48,7 @@ extern char* OldRouteModelWords[];
 extern char* DynWaveMethodWords[];
 extern char* InfilModelWords[];
 extern char* InertDampingWords[];
+extern char* DynWaveSolverWords[];
 extern char* TransectKeyWords[];
 extern char* XsectTypeWords[];
 extern char* SectWords[];
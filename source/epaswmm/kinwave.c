@@ -31,6 +31,7 @@ static double   C2;
 static double   Afull;
 static double   Qfull;
 static TXsect*  pXsect;
+#pragma omp threadprivate(Beta1, C1, C2, Afull, Qfull, pXsect)
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
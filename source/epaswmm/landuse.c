@@ -26,6 +26,7 @@
 //  landuse_readBuildupParams (called by parseLine in input.c)
 //  landuse_readWashoffParams (called by parseLine in input.c)
 //  landuse_getBuildup        (called by subcatch_getBuildup)
+//  landuse_setExternalBuildup (called by runoff_execute)
 //  landuse_getWashoff        (called by getWashoffLoads in subcatch.c)
 
 //-----------------------------------------------------------------------------
@@ -330,20 +331,26 @@ int  landuse_readWashoffParams(char* tok[], int ntoks)
 //=============================================================================
 
 double  landuse_getBuildup(int i, int p, double area, double curb, double buildup,
-                           double tStep)
+                           double* days, double tStep)
 //
 //  Input:   i = land use index
 //           p = pollutant index
 //           area = land use area (ac or ha)
 //           curb = land use curb length (users units)
 //           buildup = current pollutant buildup (lbs or kg)
+//           days = equivalent days of current buildup (< 0 if unknown)
 //           tStep = time increment for buildup (sec)
-//  Output:  returns new buildup mass (lbs or kg)
+//  Output:  days = equivalent days of new buildup
+//           returns new buildup mass (lbs or kg)
 //  Purpose: computes new pollutant buildup on a landuse after a time increment.
 //
+//  Note: the buildup curve only has to be inverted to find the equivalent
+//        days of the current buildup after something other than buildup
+//        (i.e., washoff or sweeping) has changed it; otherwise the days
+//        found on the previous call are simply advanced.
+//
 {
     int     n;                         // normalizer code
-    double  days;                      // accumulated days of buildup
     double  perUnit;                   // normalizer value (area or curb length)
 
     // --- return current buildup if no buildup function or time increment     //(5.0.014 - LR)
@@ -364,12 +371,12 @@ double  landuse_getBuildup(int i, int p, double area, double curb, double buildu
         return landuse_getExternalBuildup(i, p, buildup/perUnit, tStep) *      //(5.0.019 - LR)
                perUnit;                                                        //(5.0.019 - LR)
 
-    // --- determine equivalent days of current buildup
-    days = landuse_getBuildupDays(i, p, buildup/perUnit);
+    // --- determine equivalent days of current buildup if not known
+    if ( *days < 0.0 ) *days = landuse_getBuildupDays(i, p, buildup/perUnit);
 
     // --- compute buildup after adding on time increment
-    days += tStep / SECperDAY;
-    return landuse_getBuildupMass(i, p, days) * perUnit;
+    *days += tStep / SECperDAY;
+    return landuse_getBuildupMass(i, p, *days) * perUnit;
 }
 
 //=============================================================================
@@ -520,6 +527,7 @@ double landuse_getRunoffLoad(int i, int p, double area, TLandFactor landFactor[]
         washoff = MIN(washoff, buildup);
         buildup -= washoff;
         landFactor[i].buildup[p] = buildup;
+        if ( washoff > 0.0 ) landFactor[i].buildupDays[p] = -1.0;
     }
 
     // --- otherwise add washoff to buildup mass balance totals
@@ -528,6 +536,7 @@ double landuse_getRunoffLoad(int i, int p, double area, TLandFactor landFactor[]
     {                                                                          //(5.0.014 - LR)
         massbal_updateLoadingTotals(BUILDUP_LOAD, p, washoff-buildup);         //(5.0.014 - LR)
         landFactor[i].buildup[p] = 0.0;                                        //(5.0.014 - LR)
+        landFactor[i].buildupDays[p] = -1.0;
     }
 
     // --- apply any BMP removal to washoff                                    //(5.0.014 - LR)
@@ -631,6 +640,41 @@ double landuse_getCoPollutLoad(int p, double washoff[], double tStep)
 
 //=============================================================================
 
+void landuse_setExternalBuildup(DateTime aDate)
+//
+//  Input:   aDate = current date/time
+//  Output:  none
+//  Purpose: finds the current rate of each land use's external pollutant
+//           buildup from its time series.
+//
+//  NOTE: time series lookups move the series' current position, so these
+//        rates are found once per time step before subcatchments are
+//        processed concurrently.
+//
+{
+    int    i, p, ts;
+    double sf;
+
+    for (i = 0; i < Nobjects[LANDUSE]; i++)
+    {
+        for (p = 0; p < Nobjects[POLLUT]; p++)
+        {
+            if ( Landuse[i].buildupFunc[p].funcType != EXTERNAL_BUILDUP )
+                continue;
+            sf = Landuse[i].buildupFunc[p].coeff[1];             // scaling factor
+            ts = (int)floor(Landuse[i].buildupFunc[p].coeff[2]); // time series index
+            Landuse[i].buildupFunc[p].extRate = 0.0;
+            if ( ts >= 0 )
+            {
+                Landuse[i].buildupFunc[p].extRate =
+                    sf * table_tseriesLookup(&Tseries[ts], aDate, FALSE);
+            }
+        }
+    }
+}
+
+//=============================================================================
+
 ////  New function added to release 5.0.019  ////                              //(5.0.019 - LR)
 
 double landuse_getExternalBuildup(int i, int p, double buildup, double tStep)
@@ -645,19 +689,14 @@ double landuse_getExternalBuildup(int i, int p, double buildup, double tStep)
 //
 {
     double maxBuildup = Landuse[i].buildupFunc[p].coeff[0];
-    double sf = Landuse[i].buildupFunc[p].coeff[1];              // scaling factor
-    int    ts = (int)floor(Landuse[i].buildupFunc[p].coeff[2]);  // time series index
-    double rate = 0.0;
+    double rate;
 
     // --- no buildup increment at start of simulation
     if (NewRunoffTime == 0.0) return 0.0;
 
     // --- get buildup rate (mass/unit/day) over the interval
-    if ( ts >= 0 )
-    {        
-        rate = sf * table_tseriesLookup(&Tseries[ts],
-               getDateTime(NewRunoffTime), FALSE);
-    }
+    //     (as set by landuse_setExternalBuildup)
+    rate = Landuse[i].buildupFunc[p].extRate;
 
     // --- compute buildup at end of time interval
     buildup = buildup + rate * tStep / SECperDAY;
@@ -196,6 +196,9 @@ typedef struct
                                      // time step for surface/soil(pavement)/
                                      // storage layers (ft/sec)
     TWaterBalance  waterBalance;     // water balance quantites
+    double         outflow;          // outflow over current time step (cfs)
+    double         evapLoss;         // evap. loss over current time step (ft3)
+    double         infilLoss;        // infil. loss over current time step (ft3)
 }  TLidUnit;
 
 // LID List - list of LID units contained in an LID group
@@ -217,6 +220,38 @@ struct LidGroup
 };
 typedef struct LidGroup* TLidGroup;
 
+// LID State - conditions used to evaluate a LID unit over a time step
+// (one is created by each call to lid_getRunoff so that the LID units
+// of different subcatchments can be evaluated at the same time)
+typedef struct
+{
+    TSubcatch*     subcatch;      // subcatchment containing the unit
+    TLidGroup      group;         // LID group containing the unit
+    TLidUnit*      unit;          // LID unit being analyzed
+    TLidProc*      proc;          // LID process of the unit
+    double         tStep;         // current time step (sec)
+    double         evapRate;      // evaporation rate (ft/s)
+    double         nativeInfil;   // native soil infil. rate (ft/s)
+    double         maxNativeInfil;// native soil infil. rate limit (ft/s)
+    double         unitArea;      // area of LID unit (ft2)
+
+    double         surfaceInflow; // precip. + runon to LID unit (ft/s)
+    double         surfaceInfil;  // infil. rate from surface layer (ft/s)
+    double         surfaceEvap;   // evap. rate from surface layer (ft/s)
+    double         surfaceOutflow;// outflow from surface layer (ft/s)
+    double         surfaceVolume; // volume in surface storage (ft)
+
+    double         soilEvap;      // evap. from soil layer (ft/s)
+    double         soilPerc;      // percolation from soil layer (ft/s)
+    double         soilVolume;    // volume in soil/pavement storage (ft)
+
+    double         storageInflow; // inflow rate to storage layer (ft/s)
+    double         storageInfil;  // infil. rate from storage layer (ft/s)
+    double         storageEvap;   // evap.rate from storage layer (ft/s)
+    double         storageOutflow;// outflow rate from storage layer (ft/s)
+    double         storageVolume; // volume in storage layer (ft)
+}  TLidState;
+
 
 //-----------------------------------------------------------------------------
 //  Local Variables
@@ -226,46 +261,7 @@ static int        LidCount;            // number of LID processes
 static TLidGroup* LidGroups;           // array of LID process groups
 static int        GroupCount;          // number of LID groups (subcatchments)
 
-static double     LidUnitArea;         // area of current LID unit (ft2)
-static double     LidEvapVol;          // LID unit's evaporation loss (ft3)
-static double     LidInfilVol;         // LID unit's infiltration loss (ft3)
-static double     EvapRate;            // evaporation rate (ft/s)
-
-static double     SurfaceInflow;       // precip. + runon to LID unit (ft/s)
-static double     SurfaceInfil;        // infil. rate from surface layer (ft/s)
-static double     SurfaceEvap;         // evap. rate from surface layer (ft/s)
-static double     SurfaceOutflow;      // outflow from surface layer (ft/s)
-static double     SurfaceVolume;       // volume in surface storage (ft)
-
-static double     SoilEvap;            // evap. from soil layer (ft/s)
-static double     SoilPerc;            // percolation from soil layer (ft/s)
-static double     SoilVolume;          // volume in soil/pavement storage (ft)
-
-static double     StorageInflow;       // inflow rate to storage layer (ft/s)
-static double     StorageInfil;        // infil. rate from storage layer (ft/s)
-static double     StorageEvap;         // evap.rate from storage layer (ft/s)
-static double     StorageOutflow;      // outflow rate from storage layer (ft/s)
-static double     StorageVolume;       // volume in storage layer (ft)
-
-//static TGrnAmpt TmpSoilInfil;        // data structure for soil layer G-A infil. //(5.0.022-LR)
-//static TGrnAmpt TmpNativeInfil;      // data structure for native soil G-A infil.//(5.0.022-LR)
-static double     NativeInfil;         // native soil infil. rate (ft/s)           //(5.0.022-LR)
-static double     MaxNativeInfil;      // native soil infil. rate limit (ft/s)
-
-static int        IsSaturated;         // TRUE if LID unit is saturated
-static double     Tstep;               // current time step (sec)
-static TSubcatch* theSubcatch;         // ptr. to current subcatchment
-static TLidGroup  theLidGroup;         // ptr. to current LID group
-static TLidUnit*  theLidUnit;          // ptr. to a subcatchment's LID unit
-static TLidProc*  theLidProc;          // ptr. to a LID process
-
-static double     TotalEvapVol;        // subcatch. evap loss (ft3)
-static double     TotalPervEvapVol;    // evap loss over pervious area (ft3)
-static double     TotalInfilVol;       // subcatch infiltration loss (ft3)
-
 static DateTime   OldDate;                  // previous reporting date
-static char       theDate[DATE_STR_SIZE];   // string for calendar date
-static char       theTime[TIME_STR_SIZE];   // string for time of day
 
 
 //-----------------------------------------------------------------------------
@@ -305,42 +301,45 @@ static int    createLidRptFile(TLidUnit* lidUnit, char* fname);
 static void   validateLidProc(int j);
 static void   validateLidGroup(int j);
 static int    isLidPervious(int k);
-static int    isLidSaturated(void);
-
-static double getImpervAreaInflow(void);
-static void   evalLidUnit(double qImperv, double *lidOutflow,
-                          double *nonLidOutflow, double *flowToPerv);
-static double getLidOutflow(void);
-
-static void   findNativeInfil(int j, double infilVol, double tStep);
-static double getSoilInfilRate(double theta);                                  //(5.0.022 - LR)
-static double getStorageInfilRate(double storageDepth);
-static double getSurfaceOutflow(double depth);
-static double getSurfaceOverflow(double* surfaceDepth);
-static double getPavementPermRate(void);
-static double getSoilPercRate(double theta, double storageDepth);
-static double getStorageOutflow(double depth);
-static void   getEvapRates(double surfaceVol, double soilVol,
+static int    isLidSaturated(TLidState* s);
+
+static double getImpervAreaInflow(TLidState* s);
+static void   evalLidUnit(TLidState* s, double qImperv);
+static double getLidOutflow(TLidState* s);
+
+static void   findNativeInfil(TLidState* s, int j, double infilVol,
+              double tStep);
+static double getSoilInfilRate(TLidState* s, double theta);                   //(5.0.022 - LR)
+static double getStorageInfilRate(TLidState* s, double storageDepth);
+static double getSurfaceOutflow(TLidState* s, double depth);
+static double getSurfaceOverflow(TLidState* s, double* surfaceDepth);
+static double getPavementPermRate(TLidState* s);
+static double getSoilPercRate(TLidState* s, double theta,
+              double storageDepth);
+static double getStorageOutflow(TLidState* s, double depth);
+static void   getEvapRates(TLidState* s, double surfaceVol, double soilVol,
                            double storageVol);
 
-static void   barrelFluxRates(double x[], double f[]);
-static void   biocellFluxRates(double x[], double f[]);
-static void   pavementFluxRates(double x[], double f[]);
-static void   trenchFluxRates(double x[], double f[]);
-static void   swaleFluxRates(double x[], double f[]);
+static void   barrelFluxRates(TLidState* s, double x[], double f[]);
+static void   biocellFluxRates(TLidState* s, double x[], double f[]);
+static void   pavementFluxRates(TLidState* s, double x[], double f[]);
+static void   trenchFluxRates(TLidState* s, double x[], double f[]);
+static void   swaleFluxRates(TLidState* s, double x[], double f[]);
 
 static void   initWaterBalance(TLidUnit *lidUnit, double initVol);
 static void   updateWaterBalance(TLidUnit *lidUnit, double inflow,
                                  double evap, double infil, double surfFlow,
-                                 double drainFlow, double storage);
+                                 double drainFlow, double storage,
+                                 double tStep);
 
 static void   initLidRptFile(char* id, TLidUnit*  lidUnit);
-static void   saveResults(void);
+static void   saveResults(TLidState* s);
 
 static int    modpuls_solve(int n, double* x, double* xOld, double* xPrev,
                             double* xMin, double* xMax, double* xTol,
                             double* qOld, double* q, double dt,
-                            void (*derivs)(double*, double*));
+                            void (*derivs)(TLidState*, double*, double*),
+                            TLidState* s);
 
 //=============================================================================
 
@@ -1170,19 +1169,19 @@ int isLidPervious(int k)
 
 //=============================================================================
 
-int isLidSaturated()
+int isLidSaturated(TLidState* s)
 //
 //  Purpose: determines if the current LID unit is saturated or not.
-//  Input:   none
+//  Input:   s = conditions for evaluating LID unit s->unit
 //  Output:  returns TRUE if saturated, FALSE if not.
 //
 {
-    if ( theLidProc->surface.thickness > 0.0 &&
-         theLidUnit->surfaceDepth < theLidProc->surface.thickness ) return FALSE;
-    if ( theLidProc->soil.thickness > 0.0 && 
-         theLidUnit->soilMoisture < theLidProc->soil.porosity )     return FALSE;
-    if ( theLidProc->storage.thickness > 0.0 &&
-         theLidUnit->storageDepth < theLidProc->storage.thickness ) return FALSE;
+    if ( s->proc->surface.thickness > 0.0 &&
+         s->unit->surfaceDepth < s->proc->surface.thickness ) return FALSE;
+    if ( s->proc->soil.thickness > 0.0 && 
+         s->unit->soilMoisture < s->proc->soil.porosity )     return FALSE;
+    if ( s->proc->storage.thickness > 0.0 &&
+         s->unit->storageDepth < s->proc->storage.thickness ) return FALSE;
     return TRUE;
 }
 
@@ -1333,69 +1332,88 @@ double lid_getRunoff(int j, double *outflow, double *evapVol,
 //           tStep    = time step (sec)
 //  Output:  returns total runoff rate (cfs)
 //
-//
+//  Note:    the LID units are evaluated one at a time, ordered by process
+//           type rather than by list position, so that consecutive calls
+//           use the same flux rate function. Their outflows and losses
+//           are then combined in the order the units were listed in.
 {
+    int        lidType;                // type of LID process
     TLidList*  lidList;
+    TLidGroup  lidGroup;
+    TLidUnit*  lidUnit;
+    TLidState  state;                  // conditions for evaluating LID units
     double qImperv;                    // LID inflow from impervious areas (cfs)
     double nonLidOutflow;              // total outflow from non-LID area (cfs)
     double lidOutflow;                 // total outflow from LID area (cfs)
     double flowToPerv;                 // return flow to pervious area (cfs)
-    DateTime theDateTime;
 
     //... return current subcatchment outflow if there are no LID's
-    theSubcatch = &Subcatch[j];
-    theLidGroup = LidGroups[j];
-    if ( !theLidGroup ) return *outflow;
-    lidList = theLidGroup->lidList;
+    lidGroup = LidGroups[j];
+    if ( !lidGroup ) return *outflow;
+    lidList = lidGroup->lidList;
     if ( !lidList ) return *outflow;
 
-    //... initialize outflows
-    flowToPerv = 0.0;
-    lidOutflow = 0.0;
-    nonLidOutflow = *outflow;
-
-    //... save subcatchment evap and infil. volumes
-    TotalEvapVol = *evapVol;
-    TotalPervEvapVol = *pervEvapVol;
-    TotalInfilVol = *infilVol;
-    Tstep = tStep;
+    //... initialize conditions shared by all LID units in the group
+    state.subcatch = &Subcatch[j];
+    state.group = lidGroup;
+    state.tStep = tStep;
 
     //... compute evaporation rate
-    EvapRate = Evap.rate;
-    if ( Evap.dryOnly && Subcatch[j].rainfall > 0.0 ) EvapRate = 0.0;
+    state.evapRate = Evap.rate;
+    if ( Evap.dryOnly && Subcatch[j].rainfall > 0.0 ) state.evapRate = 0.0;
 
     //... find subcatchment's infiltration rate into native soil               //(5.0.022-LR)
-    findNativeInfil(j, *infilVol, tStep);
+    findNativeInfil(&state, j, *infilVol, tStep);
 
     //... update time since last rainfall
-    if ( theSubcatch->rainfall > MIN_RUNOFF) theLidGroup->dryTime = 0.0;
-    else theLidGroup->dryTime += tStep;
-
-    //... get date and time for reporting purposes
-    theDateTime = getDateTime(NewRunoffTime);
-    datetime_dateToStr(theDateTime, theDate);
-    datetime_timeToStr(theDateTime, theTime);
+    if ( Subcatch[j].rainfall > MIN_RUNOFF) lidGroup->dryTime = 0.0;
+    else lidGroup->dryTime += tStep;
 
     //... get inflows from non-LID subareas of subcatchment (cfs)
-    qImperv = getImpervAreaInflow() * (Subcatch[j].area - Subcatch[j].lidArea);
-    theLidGroup->impervRunoff += qImperv * tStep;
+    qImperv = getImpervAreaInflow(&state) *
+              (Subcatch[j].area - Subcatch[j].lidArea);
+    lidGroup->impervRunoff += qImperv * tStep;
 
-    //... evaluate effect of each LID unit placed in the subcatchment
-    while ( lidList )
+    //... evaluate each LID unit, taking units of the same process type
+    //    one after another
+    for ( lidType = BIO_CELL; lidType <= VEG_SWALE; lidType++ )
     {
-        theLidUnit = lidList->lidUnit;
-        evalLidUnit(qImperv, &lidOutflow, &nonLidOutflow, &flowToPerv);
-        lidList = lidList->nextLidUnit;
+        for ( lidList = lidGroup->lidList; lidList;
+              lidList = lidList->nextLidUnit )
+        {
+            lidUnit = lidList->lidUnit;
+            if ( LidProcs[lidUnit->lidIndex].lidType != lidType ) continue;
+            state.unit = lidUnit;
+            evalLidUnit(&state, qImperv);
+        }
     }
 
-    //... update runoff flow that leaves the subcatchment (in cfs)
-    theLidGroup->flowToPerv = flowToPerv;
-    *outflow = nonLidOutflow + lidOutflow - theLidGroup->flowToPerv;
+    //... combine outflows and moisture losses from each LID unit
+    flowToPerv = 0.0;
+    lidOutflow = 0.0;
+    nonLidOutflow = *outflow;
+    for ( lidList = lidGroup->lidList; lidList; lidList = lidList->nextLidUnit )
+    {
+        lidUnit = lidList->lidUnit;
+        if ( lidUnit->area * lidUnit->number <= 0.0 ) continue;
+
+        //... reduce non-LID outflow by amount treated by the LID unit
+        nonLidOutflow -= qImperv * lidUnit->fromImperv;
+
+        //... update flow returned to pervious area & moisture losses (ft3)
+        lidOutflow += lidUnit->outflow;
+        flowToPerv += lidUnit->toPerv * lidUnit->outflow;
+        *evapVol += lidUnit->evapLoss;
+        *infilVol += lidUnit->infilLoss;
+        if ( isLidPervious(lidUnit->lidIndex) )
+        {
+            *pervEvapVol += lidUnit->evapLoss;
+        }
+    }
 
-    //... update moisture losses
-    *evapVol = TotalEvapVol;
-    *pervEvapVol = TotalPervEvapVol;
-    *infilVol = TotalInfilVol;
+    //... update runoff flow that leaves the subcatchment (in cfs)
+    lidGroup->flowToPerv = flowToPerv;
+    *outflow = nonLidOutflow + lidOutflow - lidGroup->flowToPerv;
 
     //... return just the runoff from the LID area
     return lidOutflow;
@@ -1405,14 +1423,15 @@ double lid_getRunoff(int j, double *outflow, double *evapVol,
 
 ////  This function was re-written for release 5.0.022  ////                   //(5.0.022-LR)
 
-void findNativeInfil(int j, double infilVol, double tStep)
+void findNativeInfil(TLidState* s, int j, double infilVol, double tStep)
 //
 //  Purpose: determines a subcatchment's current infiltration rate into
 //           its native soil.
-//  Input:   j = subcatchment index
+//  Input:   s = conditions for evaluating the subcatchment's LID units
+//           j = subcatchment index
 //           infilVol = infil. volume for non-LID pervious sub-area (ft3)
 //           tStep    = time step (sec)
-//  Output:  sets values for module-level variables NativeInfil & MaxNativeInfil
+//  Output:  sets values for s->nativeInfil & s->maxNativeInfil
 //
 {
     double nonLidArea;
@@ -1421,30 +1440,31 @@ void findNativeInfil(int j, double infilVol, double tStep)
     nonLidArea = Subcatch[j].area - Subcatch[j].lidArea;
     if ( nonLidArea > 0.0 && Subcatch[j].fracImperv < 1.0 )
     {
-        NativeInfil = infilVol / nonLidArea / tStep;
+        s->nativeInfil = infilVol / nonLidArea / tStep;
     }
 
     //... otherwise find infil. rate for the subcatchment's rainfall + runon
     else
     {
-        NativeInfil = infil_getInfil(j, InfilModel, tStep, Subcatch[j].rainfall,
-                                     Subcatch[j].runon, lid_getSurfaceDepth(j));
+        s->nativeInfil = infil_getInfil(j, InfilModel, tStep,
+                             Subcatch[j].rainfall, Subcatch[j].runon,
+                             lid_getSurfaceDepth(j));
     }
 
     //... see if there is any groundwater-imposed limit on infil.
     if ( !IgnoreGwater && Subcatch[j].groundwater )
     {
-        MaxNativeInfil = Subcatch[j].groundwater->maxInfilVol / tStep;
+        s->maxNativeInfil = Subcatch[j].groundwater->maxInfilVol / tStep;
     }
-    else MaxNativeInfil = BIG;
+    else s->maxNativeInfil = BIG;
 }
 
 //=============================================================================
 
-double getImpervAreaInflow()
+double getImpervAreaInflow(TLidState* s)
 //
 //  Purpose: computes runoff sent by impervious sub-areas into LID unit.
-//  Input:   none
+//  Input:   s = conditions for the LID group's subcatchment
 //  Output:  returns runoff flow (ft/sec)
 //
 {
@@ -1454,74 +1474,61 @@ double getImpervAreaInflow()
     // --- runoff from impervious area w/ & w/o depression storage
     for (i = IMPERV0; i <= IMPERV1; i++)
     {
-        q += theSubcatch->subArea[i].runoff * theSubcatch->subArea[i].fArea;
+        q += s->subcatch->subArea[i].runoff * s->subcatch->subArea[i].fArea;
     }
 
     // --- adjust for any fraction of runoff sent to pervious area
-    if ( theSubcatch->subArea[IMPERV0].routeTo == TO_PERV &&
-         theSubcatch->fracImperv < 1.0 )
-            q *= theSubcatch->subArea[IMPERV0].fOutlet;
+    if ( s->subcatch->subArea[IMPERV0].routeTo == TO_PERV &&
+         s->subcatch->fracImperv < 1.0 )
+            q *= s->subcatch->subArea[IMPERV0].fOutlet;
     return q;
 }
 
 //=============================================================================
 
-void evalLidUnit(double qImperv, double *lidOutflow, double *nonLidOutflow,
-                 double *flowToPerv)
+void evalLidUnit(TLidState* s, double qImperv)
 //
-//  Purpose: evaluates performance of current LID unit over current time step.
-//  Input:   qImperv = inflow from non-LID impervious area (cfs)
-//  Output:  updates:
-//           lidOutflow = total outflow from all LID areas (cfs)
-//           nonLidOutflow = total outflow from all non-LID area (cfs)
-//           flowToPerv = flow returned to non-LID pervious area (cfs)
+//  Purpose: evaluates performance of a LID unit over current time step.
+//  Input:   s = conditions for evaluating LID unit s->unit
+//           qImperv = inflow from non-LID impervious area (cfs)
+//  Output:  updates the LID unit's outflow (cfs) and evap. and infil.
+//           losses (ft3)
 //
 {
-    double inflow, outflow;
+    double inflow;
+
+    //... initialize outflow and losses
+    s->unit->outflow = 0.0;
+    s->unit->evapLoss = 0.0;
+    s->unit->infilLoss = 0.0;
 
     //... return if the LID has no area
-    LidUnitArea = theLidUnit->area * theLidUnit->number;
-    if ( LidUnitArea <= 0.0 ) return;
+    s->unitArea = s->unit->area * s->unit->number;
+    if ( s->unitArea <= 0.0 ) return;
 
     //... identify the LID process of the LID unit being analyzed
-    theLidProc = &LidProcs[theLidUnit->lidIndex];
-
-    //... initialize evap and infil losses
-    LidEvapVol = 0.0;
-    LidInfilVol = 0.0;
+    s->proc = &LidProcs[s->unit->lidIndex];
 
     //... get inflow to LID unit from non-LID area runoff (cfs)
-    //    (reduce non-Lid outflow by this amount)
-    inflow = qImperv * theLidUnit->fromImperv;
-    *nonLidOutflow -= inflow;
+    inflow = qImperv * s->unit->fromImperv;
 
     //... find total inflow to LID unit from all sources (ft/s)
-    SurfaceInflow = (inflow / LidUnitArea) + theSubcatch->runon +
-                    theSubcatch->rainfall;
+    s->surfaceInflow = (inflow / s->unitArea) + s->subcatch->runon +
+                       s->subcatch->rainfall;
 
     //... outflow from the LID unit (in cfs)
-    outflow = getLidOutflow() * LidUnitArea;
-    *lidOutflow += outflow;
-
-    //... update flow returned to pervious area & moisture losses (ft3)
-    *flowToPerv += theLidUnit->toPerv * outflow;
-    TotalEvapVol  += LidEvapVol;
-    TotalInfilVol += LidInfilVol;
-    if ( isLidPervious(theLidUnit->lidIndex) )
-    {
-        TotalPervEvapVol += LidEvapVol;
-    }
+    s->unit->outflow = getLidOutflow(s) * s->unitArea;
 
     //... update water balance and save results
-    saveResults();
+    saveResults(s);
 }
 
 //=============================================================================
 
-double getLidOutflow()
+double getLidOutflow(TLidState* s)
 //
 //  Purpose: computes runoff outflow from a single LID unit.
-//  Input:   none
+//  Input:   s = conditions for evaluating LID unit s->unit
 //  Output:  returns runoff outflow (ft/s)
 //
 {
@@ -1537,59 +1544,59 @@ double getLidOutflow()
         {STOPTOL, STOPTOL, STOPTOL};  //(ft, moisture fraction , ft)
 
     //... pointer to function that computes flux rates through the LID
-    void (*fluxRates) (double *, double *) = NULL;
+    void (*fluxRates) (TLidState *, double *, double *) = NULL;
 
     //... store current moisture levels in vector x
-    x[SURF] = theLidUnit->surfaceDepth;
-    x[SOIL] = theLidUnit->soilMoisture;
-    x[STOR] = theLidUnit->storageDepth;
+    x[SURF] = s->unit->surfaceDepth;
+    x[SOIL] = s->unit->soilMoisture;
+    x[STOR] = s->unit->storageDepth;
 
     //... initialize layer flux rates and moisture limits
-    SurfaceInfil   = 0.0;
-    SurfaceEvap    = 0.0;
-    SurfaceOutflow = 0.0;
-    SoilEvap       = 0.0;
-    SoilPerc       = 0.0;
-    StorageInflow  = 0.0;
-    StorageInfil   = 0.0;
-    StorageEvap    = 0.0;
-    StorageOutflow = 0.0;
+    s->surfaceInfil   = 0.0;
+    s->surfaceEvap    = 0.0;
+    s->surfaceOutflow = 0.0;
+    s->soilEvap       = 0.0;
+    s->soilPerc       = 0.0;
+    s->storageInflow  = 0.0;
+    s->storageInfil   = 0.0;
+    s->storageEvap    = 0.0;
+    s->storageOutflow = 0.0;
     for (i = 0; i < 3; i++)
     {
         f[i] = 0.0;
-        fOld[i] = theLidUnit->oldFluxRates[i];
+        fOld[i] = s->unit->oldFluxRates[i];
         xMin[i] = 0.0;
         xMax[i] = BIG;
     }
 
 ////  The following code segment was added for release 5.0.022  ////           //(5.0.022-LR)
     //... find Green-Ampt infiltration from surface layer
-    if ( theLidUnit->soilInfil.Ks > 0.0 )
+    if ( s->unit->soilInfil.Ks > 0.0 )
     {
 
-        SurfaceInfil =
-            grnampt_getInfil(&theLidUnit->soilInfil, Tstep,
-                             SurfaceInflow, theLidUnit->surfaceDepth);
+        s->surfaceInfil =
+            grnampt_getInfil(&s->unit->soilInfil, s->tStep,
+                             s->surfaceInflow, s->unit->surfaceDepth);
     }
-    else SurfaceInfil = NativeInfil;
+    else s->surfaceInfil = s->nativeInfil;
 
     //... set moisture limits for soil & storage layers
-    if ( theLidProc->soil.thickness > 0.0 )
+    if ( s->proc->soil.thickness > 0.0 )
     {
-        xMin[SOIL] = theLidProc->soil.wiltPoint;
-        xMax[SOIL] = theLidProc->soil.porosity;
+        xMin[SOIL] = s->proc->soil.wiltPoint;
+        xMax[SOIL] = s->proc->soil.porosity;
     }
-    if ( theLidProc->pavement.thickness > 0.0 )
+    if ( s->proc->pavement.thickness > 0.0 )
     {
-        xMax[SOIL] = theLidProc->pavement.voidFrac;
+        xMax[SOIL] = s->proc->pavement.voidFrac;
     }
-    if ( theLidProc->storage.thickness > 0.0 )
+    if ( s->proc->storage.thickness > 0.0 )
     {
-        xMax[STOR] = theLidProc->storage.thickness;
+        xMax[STOR] = s->proc->storage.thickness;
     }
 
     //... determine which flux rate function to use
-    switch (theLidProc->lidType)
+    switch (s->proc->lidType)
     {
     case BIO_CELL:        fluxRates = &biocellFluxRates;  break;
     case INFIL_TRENCH:    fluxRates = &trenchFluxRates;   break;
@@ -1601,7 +1608,7 @@ double getLidOutflow()
 
     //... update moisture levels and flux rates over the time step
     i = modpuls_solve(3, x, xOld, xPrev, xMin, xMax, xTol, fOld, f,
-                      Tstep, fluxRates);
+                      s->tStep, fluxRates, s);
 
     if  (i == 0) 
     {
@@ -1611,37 +1618,38 @@ double getLidOutflow()
             theDate, theTime);
         fprintf(Frpt.file,
         "\n              for LID %s placed in subcatchment %s.",
-            theLidProc->ID, theSubcatch->ID);
+            s->proc->ID, s->subcatch->ID);
 *******************************************************************/
     }
 
     //... add any surface overflow to surface outflow
-    if ( theLidProc->surface.canOverflow || theLidUnit->width == 0.0 )         //(5.0.022-LR)
+    if ( s->proc->surface.canOverflow || s->unit->width == 0.0 )               //(5.0.022-LR)
     {
-        SurfaceOutflow += getSurfaceOverflow(&x[SURF]);
+        s->surfaceOutflow += getSurfaceOverflow(s, &x[SURF]);
     }
 
     //... save updated results
-    theLidUnit->surfaceDepth = x[SURF];
-    theLidUnit->soilMoisture = x[SOIL];
-    theLidUnit->storageDepth = x[STOR];
-    for (i = 0; i < 3; i++) theLidUnit->oldFluxRates[i] = f[i];
+    s->unit->surfaceDepth = x[SURF];
+    s->unit->soilMoisture = x[SOIL];
+    s->unit->storageDepth = x[STOR];
+    for (i = 0; i < 3; i++) s->unit->oldFluxRates[i] = f[i];
 //    theLidUnit->soilInfil = TmpSoilInfil;                                    //(5.0.022-LR)
 //    theLidUnit->nativeInfil = TmpNativeInfil;                                //(5.0.022-LR)
 
     //... update losses
-    LidEvapVol = (SurfaceEvap + SoilEvap + StorageEvap) * Tstep * LidUnitArea;
-    LidInfilVol = StorageInfil * Tstep * LidUnitArea;
+    s->unit->evapLoss = (s->surfaceEvap + s->soilEvap + s->storageEvap) *
+                        s->tStep * s->unitArea;
+    s->unit->infilLoss = s->storageInfil * s->tStep * s->unitArea;
 
     //... return total outflow (per unit area) from unit
-    return SurfaceOutflow + StorageOutflow;
+    return s->surfaceOutflow + s->storageOutflow;
 }    
 
 //=============================================================================
 
 ////  This function was modified for release 5.0.022  ////                     //(5.0.022-LR)
 
-double getSoilInfilRate(double theta)
+double getSoilInfilRate(TLidState* s, double theta)
 //
 //  Purpose: limits the infiltration rate between surface and soil layers of
 //           a bio-retention cell LID to available pore volume.
@@ -1650,15 +1658,15 @@ double getSoilInfilRate(double theta)
 //
 {
     double maxValue;
-    maxValue = (theLidProc->soil.porosity - theta) *
-               theLidProc->soil.thickness / Tstep;
+    maxValue = (s->proc->soil.porosity - theta) *
+               s->proc->soil.thickness / s->tStep;
     maxValue = MAX(0.0, maxValue);
-    return MIN(SurfaceInfil, maxValue);
+    return MIN(s->surfaceInfil, maxValue);
 }
 
 //=============================================================================
 
-double getSurfaceOutflow(double depth)
+double getSurfaceOutflow(TLidState* s, double depth)
 //
 //  Purpose: computes outflow rate from a LID's surface layer.
 //  Input:   depth = depth of ponded water on surface layer (ft)
@@ -1671,19 +1679,19 @@ double getSurfaceOutflow(double depth)
     double outflow;
 
     //... no outflow if ponded depth below storage depth
-    delta = depth - theLidProc->surface.thickness;
+    delta = depth - s->proc->surface.thickness;
     if ( delta < 0.0 ) return 0.0;
 
     //... compute outflow from overland flow Manning equation
-    outflow = theLidProc->surface.alpha * pow(delta, 5.0/3.0) *
-              theLidUnit->width / theLidUnit->area;
-    outflow = MIN(outflow, delta / Tstep);
+    outflow = s->proc->surface.alpha * pow(delta, 5.0/3.0) *
+              s->unit->width / s->unit->area;
+    outflow = MIN(outflow, delta / s->tStep);
     return outflow;
 }
 
 //=============================================================================
 
-double getPavementPermRate()
+double getPavementPermRate(TLidState* s)
 //
 //  Purpose: computes reduced permeability of a pavement layer due to
 //           clogging.
@@ -1694,19 +1702,19 @@ double getPavementPermRate()
     double permRate;
     double permReduction;
 
-    permReduction = theLidProc->pavement.clogFactor;
+    permReduction = s->proc->pavement.clogFactor;
     if ( permReduction > 0.0 )
     {
-        permReduction = theLidUnit->waterBalance.inflow / permReduction;
+        permReduction = s->unit->waterBalance.inflow / permReduction;
         permReduction = MIN(permReduction, 1.0);
     }
-    permRate = theLidProc->pavement.kSat * (1.0 - permReduction);
+    permRate = s->proc->pavement.kSat * (1.0 - permReduction);
     return permRate;
 }
 
 //=============================================================================
     
-double getSoilPercRate(double theta, double storageDepth)
+double getSoilPercRate(TLidState* s, double theta, double storageDepth)
 //
 //  Purpose: computes percolation rate of water through a LID's soil layer.
 //  Input:   theta = moisture content (fraction)
@@ -1719,22 +1727,22 @@ double getSoilPercRate(double theta, double storageDepth)
     double maxValue;         // max. allowable perc. rate (ft/s)
 
     // ... max. drainable soil moisture 
-    maxValue = (theta - theLidProc->soil.fieldCap) * 
-               theLidProc->soil.thickness / Tstep;
+    maxValue = (theta - s->proc->soil.fieldCap) * 
+               s->proc->soil.thickness / s->tStep;
     if ( maxValue <= 0.0 ) return 0.0;
 
     // ... perc rate = unsaturated hydraulic conductivity
-    delta = theLidProc->soil.porosity - theta;
-    percRate = theLidProc->soil.kSat * exp(-delta * theLidProc->soil.kSlope);
+    delta = s->proc->soil.porosity - theta;
+    percRate = s->proc->soil.kSat * exp(-delta * s->proc->soil.kSlope);
 
     //... rate limited by drainable moisture content
     percRate = MIN(percRate, maxValue);
 
     // ... perc rate limited by available storage zone capacity
-    if ( theLidProc->storage.thickness > 0.0 )                                 //(5.0.022-LR)
+    if ( s->proc->storage.thickness > 0.0 )                                    //(5.0.022-LR)
     {
-        maxValue = (theLidProc->storage.thickness - storageDepth) * 
-                    theLidProc->storage.voidFrac / Tstep;
+        maxValue = (s->proc->storage.thickness - storageDepth) * 
+                    s->proc->storage.voidFrac / s->tStep;
         maxValue = MAX(0.0, maxValue);
         percRate = MIN(percRate, maxValue);
     }
@@ -1745,7 +1753,7 @@ double getSoilPercRate(double theta, double storageDepth)
 
 ////  This function was modified for release 5.0.022.  ////                    //(5.0.022-LR)
 
-double getStorageInfilRate(double depth)
+double getStorageInfilRate(TLidState* s, double depth)
 //
 //  Purpose: computes infiltration rate between storage zone and
 //           native soil beneath a LID.
@@ -1757,34 +1765,34 @@ double getStorageInfilRate(double depth)
     double clogFactor = 0.0;
     double maxRate;
 
-    if ( theLidProc->storage.kSat == 0.0 ) return 0.0;
-    if ( MaxNativeInfil == 0.0 ) return 0.0;
+    if ( s->proc->storage.kSat == 0.0 ) return 0.0;
+    if ( s->maxNativeInfil == 0.0 ) return 0.0;
 
     //... reduction 
-    clogFactor = theLidProc->storage.clogFactor;
+    clogFactor = s->proc->storage.clogFactor;
     if ( clogFactor > 0.0 )
     {
-        clogFactor = theLidUnit->waterBalance.inflow / clogFactor;
+        clogFactor = s->unit->waterBalance.inflow / clogFactor;
         clogFactor = MIN(clogFactor, 1.0);
     }
 
     //... infiltration rate = storage Ksat reduced by any clogging
-    infil = theLidProc->storage.kSat * (1.0 - clogFactor);
+    infil = s->proc->storage.kSat * (1.0 - clogFactor);
 
     //... limit infiltration rate by stored volume
-    if ( theLidProc->storage.thickness > 0.0 )
+    if ( s->proc->storage.thickness > 0.0 )
     {
-        maxRate = depth * theLidProc->storage.voidFrac / Tstep;
+        maxRate = depth * s->proc->storage.voidFrac / s->tStep;
         infil = MIN(infil, maxRate);
     }
 
     //... limit infiltration rate by any groundwater-imposed limit
-    return MIN(infil, MaxNativeInfil);
+    return MIN(infil, s->maxNativeInfil);
 }
 
 //=============================================================================
 
-double  getStorageOutflow(double depth)
+double  getStorageOutflow(TLidState* s, double depth)
 //
 //  Purpose: computes outflow rate from underdrain in a LID's storage layer.
 //  Input:   depth = depth of water in storage layer (ft)
@@ -1794,15 +1802,15 @@ double  getStorageOutflow(double depth)
 {
     double maxValue;
     double outflow;
-    double delta = depth - theLidProc->drain.offset;
+    double delta = depth - s->proc->drain.offset;
 
     if ( delta <= ZERO ) outflow = 0.0;
     else
     {
-        maxValue = delta * theLidProc->storage.voidFrac / Tstep;
+        maxValue = delta * s->proc->storage.voidFrac / s->tStep;
         delta *= UCF(RAINDEPTH);
-        outflow = theLidProc->drain.coeff *
-                  pow(delta, theLidProc->drain.expon);
+        outflow = s->proc->drain.coeff *
+                  pow(delta, s->proc->drain.expon);
         outflow /= UCF(RAINFALL);
         outflow = MIN(outflow, maxValue);
     }
@@ -1811,7 +1819,8 @@ double  getStorageOutflow(double depth)
 
 //=============================================================================
 
-void getEvapRates(double surfaceVol, double soilVol, double storageVol)
+void getEvapRates(TLidState* s, double surfaceVol, double soilVol,
+                  double storageVol)
 //
 //  Purpose: computes surface, soil, and storage evaporation rates.
 //  Input:   surfaceVol = volume of ponded water on surface layer (ft)
@@ -1823,24 +1832,24 @@ void getEvapRates(double surfaceVol, double soilVol, double storageVol)
     double availEvap;
 
     //... surface evaporation flux
-    availEvap = EvapRate;
-    SurfaceEvap = MIN(availEvap, surfaceVol/Tstep);
-    SurfaceEvap = MAX(0.0, SurfaceEvap);
-    availEvap = MAX(0.0, (availEvap - SurfaceEvap));
+    availEvap = s->evapRate;
+    s->surfaceEvap = MIN(availEvap, surfaceVol/s->tStep);
+    s->surfaceEvap = MAX(0.0, s->surfaceEvap);
+    availEvap = MAX(0.0, (availEvap - s->surfaceEvap));
     
     //... soil evaporation flux
-    SoilEvap = MIN(availEvap, soilVol / Tstep);
-    availEvap = MAX(0.0, (availEvap - SoilEvap));
+    s->soilEvap = MIN(availEvap, soilVol / s->tStep);
+    availEvap = MAX(0.0, (availEvap - s->soilEvap));
     
     //... storage evaporation flux
-    StorageEvap = MIN(availEvap, storageVol / Tstep);
+    s->storageEvap = MIN(availEvap, storageVol / s->tStep);
 }
 
 //=============================================================================
 
 ////  This function was modified for release 5.0.022.  ////                    //(5.0.022-LR)
 
-void biocellFluxRates(double x[], double f[])
+void biocellFluxRates(TLidState* s, double x[], double f[])
 //
 //  Purpose: computes flux rates from the layers of a bio-retention cell LID.
 //  Input:   x = vector of storage levels
@@ -1857,44 +1866,46 @@ void biocellFluxRates(double x[], double f[])
     storageDepth = x[STOR];
 
     //... convert state variables to volumes
-    SurfaceVolume = surfaceDepth * theLidProc->surface.voidFrac;
-    SoilVolume = (soilTheta - theLidProc->soil.wiltPoint) *
-                 theLidProc->soil.thickness;
-    StorageVolume = storageDepth * theLidProc->storage.voidFrac;
+    s->surfaceVolume = surfaceDepth * s->proc->surface.voidFrac;
+    s->soilVolume = (soilTheta - s->proc->soil.wiltPoint) *
+                 s->proc->soil.thickness;
+    s->storageVolume = storageDepth * s->proc->storage.voidFrac;
 
     //... get ET rates
-    getEvapRates(SurfaceVolume, SoilVolume, StorageVolume);
+    getEvapRates(s, s->surfaceVolume, s->soilVolume, s->storageVolume);
 
     //... find surface layer flux rate
-    SurfaceInfil = getSoilInfilRate(soilTheta);
-    SurfaceOutflow = getSurfaceOutflow(surfaceDepth);
-    f[SURF] = (SurfaceInflow - SurfaceEvap - SurfaceInfil - SurfaceOutflow) /
-              theLidProc->surface.voidFrac;
+    s->surfaceInfil = getSoilInfilRate(s, soilTheta);
+    s->surfaceOutflow = getSurfaceOutflow(s, surfaceDepth);
+    f[SURF] = (s->surfaceInflow - s->surfaceEvap - s->surfaceInfil -
+               s->surfaceOutflow) /
+              s->proc->surface.voidFrac;
 
     //... find soil layer perc rate
-    SoilPerc = getSoilPercRate(soilTheta, storageDepth);
+    s->soilPerc = getSoilPercRate(s, soilTheta, storageDepth);
 
     //... find storage layer flux rates
-    StorageInfil = getStorageInfilRate(storageDepth);
-    StorageOutflow = getStorageOutflow(storageDepth);
+    s->storageInfil = getStorageInfilRate(s, storageDepth);
+    s->storageOutflow = getStorageOutflow(s, storageDepth);
 
     //... make adjustments if no storage layer present
-    if ( theLidProc->storage.thickness == 0.0 )
+    if ( s->proc->storage.thickness == 0.0 )
     {
-        SoilPerc = MIN(SoilPerc, StorageInfil);
-        StorageInfil = SoilPerc;
+        s->soilPerc = MIN(s->soilPerc, s->storageInfil);
+        s->storageInfil = s->soilPerc;
     }
 
     //... compute overall soil and storage layer flux rates
-    f[SOIL] = (SurfaceInfil - SoilEvap - SoilPerc) /
-              theLidProc->soil.thickness;
-    f[STOR] = (SoilPerc - StorageEvap - StorageInfil - StorageOutflow) /
-              theLidProc->storage.voidFrac;
+    f[SOIL] = (s->surfaceInfil - s->soilEvap - s->soilPerc) /
+              s->proc->soil.thickness;
+    f[STOR] = (s->soilPerc - s->storageEvap - s->storageInfil -
+               s->storageOutflow) /
+              s->proc->storage.voidFrac;
 }
 
 //=============================================================================
 
-void trenchFluxRates(double x[], double f[])
+void trenchFluxRates(TLidState* s, double x[], double f[])
 //
 //  Purpose: computes flux rates from the layers of an infiltration trench LID.
 //  Input:   x = vector of storage levels
@@ -1910,28 +1921,30 @@ void trenchFluxRates(double x[], double f[])
     storageDepth = x[STOR];
 
     //... convert depths to volumes
-    SurfaceVolume = surfaceDepth * theLidProc->surface.voidFrac;
-    SoilVolume = 0.0;
-    StorageVolume = storageDepth * theLidProc->storage.voidFrac;
+    s->surfaceVolume = surfaceDepth * s->proc->surface.voidFrac;
+    s->soilVolume = 0.0;
+    s->storageVolume = storageDepth * s->proc->storage.voidFrac;
 
     //... get ET rate loss for each zone 
-    getEvapRates(SurfaceVolume, 0.0, StorageVolume);
+    getEvapRates(s, s->surfaceVolume, 0.0, s->storageVolume);
 
     //... surface layer flux rate
-    StorageInflow = SurfaceInflow + SurfaceVolume / Tstep;
-    maxValue = (theLidProc->storage.thickness - storageDepth) *
-               theLidProc->storage.voidFrac / Tstep;
+    s->storageInflow = s->surfaceInflow + s->surfaceVolume / s->tStep;
+    maxValue = (s->proc->storage.thickness - storageDepth) *
+               s->proc->storage.voidFrac / s->tStep;
     maxValue = MAX(0.0, maxValue);
-    StorageInflow = MIN(StorageInflow, maxValue);
-    SurfaceInfil = StorageInflow;
-    SurfaceOutflow = getSurfaceOutflow(surfaceDepth);
-    f[SURF] = SurfaceInflow - SurfaceEvap - StorageInflow - SurfaceOutflow;
+    s->storageInflow = MIN(s->storageInflow, maxValue);
+    s->surfaceInfil = s->storageInflow;
+    s->surfaceOutflow = getSurfaceOutflow(s, surfaceDepth);
+    f[SURF] = s->surfaceInflow - s->surfaceEvap - s->storageInflow -
+              s->surfaceOutflow;
 
     //... storage layer flux rate
-    StorageInfil = getStorageInfilRate(storageDepth);
-    StorageOutflow = getStorageOutflow(storageDepth);
-    f[STOR] = (StorageInflow - StorageEvap - StorageInfil - StorageOutflow) /
-              theLidProc->storage.voidFrac;
+    s->storageInfil = getStorageInfilRate(s, storageDepth);
+    s->storageOutflow = getStorageOutflow(s, storageDepth);
+    f[STOR] = (s->storageInflow - s->storageEvap - s->storageInfil -
+               s->storageOutflow) /
+              s->proc->storage.voidFrac;
     f[SOIL] = 0.0;
 }
 
@@ -1939,7 +1952,7 @@ void trenchFluxRates(double x[], double f[])
 
 ////  This function was modified for release 5.0.022.  ////                    //(5.0.022-LR)
 
-void pavementFluxRates(double x[], double f[])
+void pavementFluxRates(TLidState* s, double x[], double f[])
 //
 //  Purpose: computes flux rates from the layers of a porous pavement LID.
 //  Input:   x = vector of storage levels
@@ -1960,70 +1973,72 @@ void pavementFluxRates(double x[], double f[])
 
     //... convert state variables to volumes
     //    (SoilVolume refers to pavement layer)
-    SurfaceVolume = surfaceDepth * theLidProc->surface.voidFrac;
-    pervVolume = theLidProc->pavement.thickness *
-                 (1.0 - theLidProc->pavement.impervFrac);
-    SoilVolume = pavementTheta * pervVolume;
-    StorageVolume = storageDepth * theLidProc->storage.voidFrac;
+    s->surfaceVolume = surfaceDepth * s->proc->surface.voidFrac;
+    pervVolume = s->proc->pavement.thickness *
+                 (1.0 - s->proc->pavement.impervFrac);
+    s->soilVolume = pavementTheta * pervVolume;
+    s->storageVolume = storageDepth * s->proc->storage.voidFrac;
 
     //... get ET rates (arguments are stored volumes in ft)
-    getEvapRates(SurfaceVolume, SoilVolume, StorageVolume);
+    getEvapRates(s, s->surfaceVolume, s->soilVolume, s->storageVolume);
 
     //... surface layer infiltration is smaller of pavement
     //    permeability, surface inflow + ponded depth, & 
     //    available pavement void space
-    pavementPerm = getPavementPermRate();
-    SurfaceInfil = pavementPerm;
-    maxValue = (SurfaceInflow + SurfaceVolume / Tstep);
-    SurfaceInfil = MIN(SurfaceInfil, maxValue);
-    maxValue = (theLidProc->pavement.voidFrac - pavementTheta) *
-               pervVolume / Tstep;
-    SurfaceInfil = MIN(SurfaceInfil, maxValue);
+    pavementPerm = getPavementPermRate(s);
+    s->surfaceInfil = pavementPerm;
+    maxValue = (s->surfaceInflow + s->surfaceVolume / s->tStep);
+    s->surfaceInfil = MIN(s->surfaceInfil, maxValue);
+    maxValue = (s->proc->pavement.voidFrac - pavementTheta) *
+               pervVolume / s->tStep;
+    s->surfaceInfil = MIN(s->surfaceInfil, maxValue);
 
     //... surface outflow
-    SurfaceOutflow = getSurfaceOutflow(surfaceDepth);
+    s->surfaceOutflow = getSurfaceOutflow(s, surfaceDepth);
 
     //... surface layer flux rate
-    f[SURF] = SurfaceInflow - SurfaceEvap - SurfaceInfil - SurfaceOutflow;
+    f[SURF] = s->surfaceInflow - s->surfaceEvap - s->surfaceInfil -
+              s->surfaceOutflow;
 
     //... pavement (i.e., soil) layer percolation rate is smaller of
     //    permeability, current pavement layer volume and available
     //    storage layer volume
-    maxValue = SoilVolume / Tstep;
-    SoilPerc = MIN(pavementPerm, maxValue); 
-    if ( theLidProc->storage.thickness > 0.0 )
+    maxValue = s->soilVolume / s->tStep;
+    s->soilPerc = MIN(pavementPerm, maxValue); 
+    if ( s->proc->storage.thickness > 0.0 )
     {
-        maxValue = (theLidProc->storage.thickness - storageDepth) *
-                    theLidProc->storage.voidFrac / Tstep;
-        SoilPerc = MIN(SoilPerc, maxValue);
+        maxValue = (s->proc->storage.thickness - storageDepth) *
+                    s->proc->storage.voidFrac / s->tStep;
+        s->soilPerc = MIN(s->soilPerc, maxValue);
     }
 
     //... infiltration from storage layer to native soil
-    StorageInfil = getStorageInfilRate(storageDepth);
+    s->storageInfil = getStorageInfilRate(s, storageDepth);
 
     //... underdrain outflow from storage layer
-    StorageOutflow = getStorageOutflow(storageDepth);
+    s->storageOutflow = getStorageOutflow(s, storageDepth);
 
     //... adjustments for no storage layer
-    if ( theLidProc->storage.thickness == 0.0 )
+    if ( s->proc->storage.thickness == 0.0 )
     {
-        SoilPerc = MIN(SoilPerc, StorageInfil);
-        StorageInfil = SoilPerc;
+        s->soilPerc = MIN(s->soilPerc, s->storageInfil);
+        s->storageInfil = s->soilPerc;
     }
 
     //... pavement (i.e., soil) layer flux rate
-    f[SOIL] = (SurfaceInfil - SoilEvap - SoilPerc) / pervVolume;
+    f[SOIL] = (s->surfaceInfil - s->soilEvap - s->soilPerc) / pervVolume;
 
     //... storage layer flux rate
-    f[STOR] = (SoilPerc - StorageEvap - StorageInfil - StorageOutflow) /
-              theLidProc->storage.voidFrac;
+    f[STOR] = (s->soilPerc - s->storageEvap - s->storageInfil -
+               s->storageOutflow) /
+              s->proc->storage.voidFrac;
 }
 
 //=============================================================================
 
 ////  This function was modified for release 5.0.022.  ////                    //(5.0.022-LR)
 
-void swaleFluxRates(double x[], double f[])
+void swaleFluxRates(TLidState* s, double x[], double f[])
 //
 //  Purpose: computes flux rates from a vegetative swale LID.
 //  Input:   x = vector of storage levels
@@ -2049,98 +2064,98 @@ void swaleFluxRates(double x[], double f[])
 
     //... retrieve state variable from work vector
     depth = x[SURF];
-    depth = MIN(depth, theLidProc->surface.thickness);
+    depth = MIN(depth, s->proc->surface.thickness);
 
     //... depression storage depth
-    dStore = theSubcatch->subArea[PERV].dStore;
+    dStore = s->subcatch->subArea[PERV].dStore;
 
     //... get swale's bottom width
     //    (0.5 ft minimum to avoid numerical problems)
-    slope = theLidProc->surface.sideSlope;
-    topWidth = theLidUnit->width;
+    slope = s->proc->surface.sideSlope;
+    topWidth = s->unit->width;
     topWidth = MAX(topWidth, 0.5);
-    botWidth = topWidth - 2.0 * slope * theLidProc->surface.thickness;
+    botWidth = topWidth - 2.0 * slope * s->proc->surface.thickness;
     if ( botWidth < 0.5 )
     {
         botWidth = 0.5;
-        slope = 0.5 * (topWidth - 0.5) / theLidProc->surface.thickness;
+        slope = 0.5 * (topWidth - 0.5) / s->proc->surface.thickness;
     }
 
     //... swale's length
-    lidArea = theLidUnit->area;
+    lidArea = s->unit->area;
     length = lidArea / topWidth;
 
     //... top width, surface area and flow area of current ponded depth
     surfWidth = botWidth + 2.0 * slope * depth;
-    surfArea = length * surfWidth * theLidProc->surface.voidFrac;
+    surfArea = length * surfWidth * s->proc->surface.voidFrac;
     flowArea = (depth * (botWidth + slope * depth)) *
-               theLidProc->surface.voidFrac;
+               s->proc->surface.voidFrac;
 
     //... wet volume and effective depth
     volume = length * flowArea;
 
     //... surface inflow into swale (cfs)
-    surfInflow = SurfaceInflow * lidArea;
+    surfInflow = s->surfaceInflow * lidArea;
 
     //... ET rate in cfs
-    SurfaceEvap = EvapRate * surfArea;
-    SurfaceEvap = MIN(SurfaceEvap, volume/Tstep);
+    s->surfaceEvap = s->evapRate * surfArea;
+    s->surfaceEvap = MIN(s->surfaceEvap, volume/s->tStep);
 
     //... infiltration rate to native soil in cfs
-    StorageInfil = SurfaceInfil * surfArea;
+    s->storageInfil = s->surfaceInfil * surfArea;
 
 
     //... no surface outflow if depth below depression storage
     xDepth = depth - dStore;
-    if ( xDepth <= ZERO ) SurfaceOutflow = 0.0;
+    if ( xDepth <= ZERO ) s->surfaceOutflow = 0.0;
 
     //... otherwise compute a surface outflow
     else
     {
         //... modify flow area to remove depression storage,
         flowArea -= (dStore * (botWidth + slope * dStore)) *
-                     theLidProc->surface.voidFrac;
-        if ( flowArea < ZERO ) SurfaceOutflow = 0.0;
+                     s->proc->surface.voidFrac;
+        if ( flowArea < ZERO ) s->surfaceOutflow = 0.0;
         else
         {
             //... compute hydraulic radius
             botWidth = botWidth + 2.0 * dStore * slope;
             hydRadius = botWidth + 2.0 * xDepth * sqrt(1.0 + slope*slope);
-            hydRadius = flowArea / hydRadius * theLidProc->surface.voidFrac;
+            hydRadius = flowArea / hydRadius * s->proc->surface.voidFrac;
 
             //... use Manning Eqn. to find outflow rate in cfs
-            SurfaceOutflow = theLidProc->surface.alpha * flowArea *
+            s->surfaceOutflow = s->proc->surface.alpha * flowArea *
                              pow(hydRadius, 2./3.);
         }
     }
 
     //... net flux rate (dV/dt) in cfs 
-    dVdT = surfInflow - SurfaceEvap - StorageInfil - SurfaceOutflow;
+    dVdT = surfInflow - s->surfaceEvap - s->storageInfil - s->surfaceOutflow;
 
     //... when full, any net positive inflow becomes spillage
-    if ( depth == theLidProc->surface.thickness && dVdT > 0.0 )
+    if ( depth == s->proc->surface.thickness && dVdT > 0.0 )
     {
-        SurfaceOutflow += dVdT;
+        s->surfaceOutflow += dVdT;
         dVdT = 0.0;
     }
 
     //... convert flux rates to ft/s
-    SurfaceEvap /= lidArea;
-    StorageInfil /= lidArea;
-    SurfaceOutflow /= lidArea;
+    s->surfaceEvap /= lidArea;
+    s->storageInfil /= lidArea;
+    s->surfaceOutflow /= lidArea;
     f[SURF] = dVdT / surfArea;
     f[SOIL] = 0.0;
     f[STOR] = 0.0;
 
     //... assign values to layer volumes
-    SurfaceVolume = volume / lidArea;
-    SoilVolume = 0.0;
-    StorageVolume = 0.0;
+    s->surfaceVolume = volume / lidArea;
+    s->soilVolume = 0.0;
+    s->storageVolume = 0.0;
 }
 
 //=============================================================================
 
-void barrelFluxRates(double x[], double f[])
+void barrelFluxRates(TLidState* s, double x[], double f[])
 //
 //  Purpose: computes flux rates for a rain barrel LID.
 //  Input:   x = vector of storage levels
@@ -2148,55 +2163,55 @@ void barrelFluxRates(double x[], double f[])
 //
 {
     double storageDepth = x[STOR];
-    double dryTime = theLidGroup->dryTime;
+    double dryTime = s->group->dryTime;
     double maxValue;
 
     //... initialize outflows
-    SurfaceOutflow = 0.0;
-    StorageOutflow = 0.0;
+    s->surfaceOutflow = 0.0;
+    s->storageOutflow = 0.0;
     
     //... compute outflow if time in dry state exceeds drain delay time
-    if ( SurfaceInflow > MIN_RUNOFF ) dryTime = 0.0;
+    if ( s->surfaceInflow > MIN_RUNOFF ) dryTime = 0.0;
     else
     {
-        if ( dryTime > theLidProc->drain.delay )
+        if ( dryTime > s->proc->drain.delay )
         {
-            StorageOutflow = getStorageOutflow(storageDepth); 
+            s->storageOutflow = getStorageOutflow(s, storageDepth); 
         }
-        dryTime += Tstep;
+        dryTime += s->tStep;
     }
-    theLidGroup->dryTime = dryTime;
+    s->group->dryTime = dryTime;
 
     //... storage inflow rate limited by reamining empty depth
-    StorageInflow = SurfaceInflow;
-    maxValue = (theLidProc->storage.thickness - storageDepth) / Tstep;
+    s->storageInflow = s->surfaceInflow;
+    maxValue = (s->proc->storage.thickness - storageDepth) / s->tStep;
     maxValue = MAX(0.0, maxValue);
-    StorageInflow = MIN(StorageInflow, maxValue);
+    s->storageInflow = MIN(s->storageInflow, maxValue);
 
     //... assign values to layer flux rates
-    f[SURF] = SurfaceInflow - StorageInflow;
-    f[STOR] = StorageInflow - StorageOutflow;
+    f[SURF] = s->surfaceInflow - s->storageInflow;
+    f[STOR] = s->storageInflow - s->storageOutflow;
     f[SOIL] = 0.0;
 
     //... assign values to layer volumes
-    SurfaceVolume = 0.0;
-    SoilVolume = 0.0;
-    StorageVolume = storageDepth;
+    s->surfaceVolume = 0.0;
+    s->soilVolume = 0.0;
+    s->storageVolume = storageDepth;
 }   
 
 //=============================================================================
 
-double getSurfaceOverflow(double* surfaceDepth)
+double getSurfaceOverflow(TLidState* s, double* surfaceDepth)
 //
 //  Purpose: finds surface overflow rate from a LID unit.
 //  Input:   surfaceDepth = depth of water stored in surface layer (ft)
 //  Output:  returns the overflow rate (ft/s)
 //
 {
-    double delta = *surfaceDepth - theLidProc->surface.thickness;
+    double delta = *surfaceDepth - s->proc->surface.thickness;
     if (  delta <= 0.0 ) return 0.0;
-    *surfaceDepth = theLidProc->surface.thickness;
-    return delta * theLidProc->surface.voidFrac / Tstep;
+    *surfaceDepth = s->proc->surface.thickness;
+    return delta * s->proc->surface.voidFrac / s->tStep;
 }
 
 //=============================================================================
@@ -2221,7 +2236,8 @@ void initWaterBalance(TLidUnit *lidUnit, double initVol)
 //=============================================================================
 
 void updateWaterBalance(TLidUnit *lidUnit, double inflow, double evap,
-    double infil, double surfFlow, double drainFlow, double storage)
+    double infil, double surfFlow, double drainFlow, double storage,
+    double tStep)
 //
 //  Purpose: updates components of the water mass balance for a LID unit
 //           over the current time step.
@@ -2232,14 +2248,15 @@ void updateWaterBalance(TLidUnit *lidUnit, double inflow, double evap,
 //           surfFlow  = surface runoff from the unit (ft/s)
 //           drainFlow = underdrain flow from the unit
 //           storage   = volume of water stored in the unit (ft)
+//           tStep     = time step (sec)
 //  Output:  none
 //
 {
-    lidUnit->waterBalance.inflow += inflow * Tstep;
-    lidUnit->waterBalance.evap += evap * Tstep;
-    lidUnit->waterBalance.infil += infil * Tstep;
-    lidUnit->waterBalance.surfFlow += surfFlow * Tstep;
-    lidUnit->waterBalance.drainFlow += drainFlow * Tstep;
+    lidUnit->waterBalance.inflow += inflow * tStep;
+    lidUnit->waterBalance.evap += evap * tStep;
+    lidUnit->waterBalance.infil += infil * tStep;
+    lidUnit->waterBalance.surfFlow += surfFlow * tStep;
+    lidUnit->waterBalance.drainFlow += drainFlow * tStep;
     lidUnit->waterBalance.finalVol = storage;
 }
 
@@ -2366,7 +2383,7 @@ fprintf(f,
 
 //=============================================================================
 
-void saveResults()
+void saveResults(TLidState* s)
 //
 //  Purpose: updates the mass balance for the current LID unit and saves
 //           current flux rates to the LID report file.
@@ -2382,58 +2399,59 @@ void saveResults()
     double rptVars[MAX_RPT_VARS];      // array of reporting variables
 
     //... find total evap. rate and stored volume
-    totalEvap = SurfaceEvap + SoilEvap + StorageEvap;
-    totalVolume = SurfaceVolume + SoilVolume + StorageVolume;
+    totalEvap = s->surfaceEvap + s->soilEvap + s->storageEvap;
+    totalVolume = s->surfaceVolume + s->soilVolume + s->storageVolume;
 
     //... update mass balance totals
-    updateWaterBalance(theLidUnit, SurfaceInflow, totalEvap, StorageInfil,
-                       SurfaceOutflow, StorageOutflow, totalVolume); 
+    updateWaterBalance(s->unit, s->surfaceInflow, totalEvap, s->storageInfil,
+                       s->surfaceOutflow, s->storageOutflow, totalVolume,
+                       s->tStep);
 
     //... write results to LID report file
-    if ( theLidUnit->rptFile )
+    if ( s->unit->rptFile )
     {
         //... check if next reporting time not reached yet
-        if ( NewRunoffTime < theLidUnit->rptFile->nextReportTime ) return;
+        if ( NewRunoffTime < s->unit->rptFile->nextReportTime ) return;
 
         //... convert project's reporting time step from sec to msec
         rptStep = 1000 * ReportStep;
 
         //... advance next reporting time beyond current runoff time
-        while (NewRunoffTime >= theLidUnit->rptFile->nextReportTime)
+        while (NewRunoffTime >= s->unit->rptFile->nextReportTime)
         {
-            theLidUnit->rptFile->nextReportTime += rptStep;
+            s->unit->rptFile->nextReportTime += rptStep;
         }
 
         //... check if dry-weather conditions hold
-        if ( SurfaceInflow  < MINFLOW &&
-             SurfaceOutflow < MINFLOW &&
-             StorageOutflow < MINFLOW &&
-             StorageInfil   < MINFLOW &&
+        if ( s->surfaceInflow  < MINFLOW &&
+             s->surfaceOutflow < MINFLOW &&
+             s->storageOutflow < MINFLOW &&
+             s->storageInfil   < MINFLOW &&
              totalEvap      < MINFLOW ) return;
 
         //... convert rate results to original units (in/hr or mm/hr)
         ucf = UCF(RAINFALL);
-        rptVars[SURF_INFLOW]  = SurfaceInflow*ucf;
+        rptVars[SURF_INFLOW]  = s->surfaceInflow*ucf;
         rptVars[TOTAL_EVAP]   = totalEvap*ucf;
-        rptVars[SURF_INFIL]   = SurfaceInfil*ucf;
-        rptVars[SOIL_PERC]    = SoilPerc*ucf;
-        rptVars[STOR_INFIL]   = StorageInfil*ucf;
-        rptVars[SURF_OUTFLOW] = SurfaceOutflow*ucf;
-        rptVars[STOR_OUTFLOW] = StorageOutflow*ucf;
+        rptVars[SURF_INFIL]   = s->surfaceInfil*ucf;
+        rptVars[SOIL_PERC]    = s->soilPerc*ucf;
+        rptVars[STOR_INFIL]   = s->storageInfil*ucf;
+        rptVars[SURF_OUTFLOW] = s->surfaceOutflow*ucf;
+        rptVars[STOR_OUTFLOW] = s->storageOutflow*ucf;
 
         //... convert storage results to original units (in or mm)
         ucf = UCF(RAINDEPTH);
-        rptVars[SURF_DEPTH] = theLidUnit->surfaceDepth*ucf;
-        rptVars[SOIL_MOIST] = theLidUnit->soilMoisture;
-        rptVars[STOR_DEPTH] = theLidUnit->storageDepth*ucf;
+        rptVars[SURF_DEPTH] = s->unit->surfaceDepth*ucf;
+        rptVars[SOIL_MOIST] = s->unit->soilMoisture;
+        rptVars[STOR_DEPTH] = s->unit->storageDepth*ucf;
 
         //... write results to file
-        fprintf(theLidUnit->rptFile->file, "\n%7.3f\t",
+        fprintf(s->unit->rptFile->file, "\n%7.3f\t",
                 NewRunoffTime/1000.0/3600.0);
         for ( i = SURF_INFLOW; i <= STOR_OUTFLOW; i++)
-                fprintf(theLidUnit->rptFile->file, " %8.2f\t", rptVars[i]);
+                fprintf(s->unit->rptFile->file, " %8.2f\t", rptVars[i]);
         for ( i = SURF_DEPTH; i <= STOR_DEPTH; i++)
-                fprintf(theLidUnit->rptFile->file, " %8.2f\t", rptVars[i]);
+                fprintf(s->unit->rptFile->file, " %8.2f\t", rptVars[i]);
     }
 }
 
@@ -2442,7 +2460,8 @@ void saveResults()
 int modpuls_solve(int n, double* x, double* xOld, double* xPrev,
                   double* xMin, double* xMax, double* xTol,
                   double* qOld, double* q, double dt,
-                  void (*derivs)(double*, double*))
+                  void (*derivs)(TLidState*, double*, double*),
+                  TLidState* s)
 //
 //  Purpose: solves system of equations dx/dt = q(x) for x at end of time step
 //           dt using a modified Puls method.
@@ -2458,6 +2477,7 @@ int modpuls_solve(int n, double* x, double* xOld, double* xPrev,
 //           dt = time step (sec)
 //           derivs = pointer to function that computes flux rates q as a
 //                    function of state variables x
+//           s = conditions passed on to derivs
 //  Output:  returns number of steps required for convergence (or 0 if 
 //           process doesn't converge)
 //
@@ -2480,7 +2500,7 @@ int modpuls_solve(int n, double* x, double* xOld, double* xPrev,
     {
         //... compute flux rates for current state levels 
         canStop = 1;
-        derivs(x, q);
+        derivs(s, x, q);
 
         //... update state levels based on current flux rates
         for (i=0; i<n; i++)
@@ -32,6 +32,24 @@
                                                  /* uppercase char of x   */
 #define ARRAY_LENGTH(x) (sizeof(x)/sizeof(x[0])) /* length of array x     */
 
+//-------------------------------------------------
+// Macros to position files with 64-bit byte offsets
+//-------------------------------------------------
+//  (files using these must define _FILE_OFFSET_BITS as 64 before including
+//   any system header so that off_t is 64 bits on 32-bit POSIX systems;
+//   OFF_T_CHECK fails to compile if this was not done)
+#if defined(_MSC_VER)
+#define FSEEK64(f,p,o) _fseeki64((f),(p),(o))
+#define FTELL64(f)     _ftelli64((f))
+#elif defined(__MINGW32__)
+#define FSEEK64(f,p,o) fseeko64((f),(off64_t)(p),(o))
+#define FTELL64(f)     ((FilePos)ftello64((f)))
+#else
+#define OFF_T_CHECK    ((void)sizeof(char[(sizeof(off_t) == 8) ? 1 : -1]))
+#define FSEEK64(f,p,o) (OFF_T_CHECK, fseeko((f),(off_t)(p),(o)))
+#define FTELL64(f)     (OFF_T_CHECK, (FilePos)ftello((f)))
+#endif
+
 //-------------------------------------------------
 // Macro to evaluate function x with error checking
 //-------------------------------------------------
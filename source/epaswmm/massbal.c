@@ -17,6 +17,9 @@
 
 #include <stdlib.h>
 #include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "headers.h"
 
 //-----------------------------------------------------------------------------
@@ -37,6 +40,14 @@ TRoutingTotals   StepFlowTotals;  // routed flow totals over time step
 TRoutingTotals   OldStepFlowTotals;
 TRoutingTotals*  StepQualTotals;  // routed WQ totals over time step
 
+// Partial runoff totals of threads other than the master thread when
+// subcatchments are processed concurrently (slot 0 is not used since
+// the master thread adds directly to the overall totals).
+static int             ThreadCount;     // number of runoff threads
+static TRunoffTotals*  ThreadRunoff;    // runoff totals of each thread
+static TGwaterTotals*  ThreadGwater;    // groundwater totals of each thread
+static TLoadingTotals* ThreadLoading;   // loading totals of each thread
+
 //-----------------------------------------------------------------------------
 //  Exportable variables
 //-----------------------------------------------------------------------------
@@ -53,6 +64,7 @@ double   TotalArea;               // total drainage area (ft2)
 //  massbal_updateRunoffTotals  (called from subcatch_getRunoff)
 //  massbal_updateLoadingTotals (called from subcatch_getBuildup)              //(5.0.019 - LR)
 //  massbal_updateGwaterTotals  (called from updateMassBal in gwater.c)
+//  massbal_sumThreadTotals     (called from runoff_execute)
 //  massbal_updateRoutingTotals (called from routing_execute)
 //  massbal_initTimeStepTotals  (called from routing_execute)
 //  massbal_addInflowFlow       (called from routing.c)
@@ -74,6 +86,7 @@ double massbal_getLoadingError(void);
 double massbal_getGwaterError(void);
 double massbal_getFlowError(void);
 double massbal_getQualError(void);
+static int getThreadNum(void);
 
 
 //=============================================================================
@@ -180,6 +193,29 @@ int massbal_open()
          }
      }
 
+    // --- allocate memory for partial totals of each runoff thread
+    ThreadCount = 1;
+    ThreadRunoff = NULL;
+    ThreadGwater = NULL;
+    ThreadLoading = NULL;
+#ifdef _OPENMP
+    ThreadCount = omp_get_max_threads();
+#endif
+    if ( ThreadCount > 1 )
+    {
+        ThreadRunoff = (TRunoffTotals *) calloc(ThreadCount,
+                                                sizeof(TRunoffTotals));
+        ThreadGwater = (TGwaterTotals *) calloc(ThreadCount,
+                                                sizeof(TGwaterTotals));
+        ThreadLoading = (TLoadingTotals *) calloc(ThreadCount * n + 1,
+                                                  sizeof(TLoadingTotals));
+        if ( !ThreadRunoff || !ThreadGwater || !ThreadLoading )
+        {
+            report_writeErrorMsg(ERR_MEMORY, "");
+            return ErrorCode;
+        }
+    }
+
     // --- initialize WQ totals
     for (j = 0; j < n; j++)
     {
@@ -230,6 +266,9 @@ void massbal_close()
     FREE(StepQualTotals);
     FREE(NodeInflow);
     FREE(NodeOutflow);
+    FREE(ThreadRunoff);
+    FREE(ThreadGwater);
+    FREE(ThreadLoading);
 }
 
 //=============================================================================
@@ -322,10 +361,14 @@ void massbal_updateRunoffTotals(double vRainfall, double vEvap, double vInfil,
 //  Purpose: updates runoff totals after current time step.
 //
 {
-    RunoffTotals.rainfall += vRainfall;
-    RunoffTotals.evap     += vEvap;
-    RunoffTotals.infil    += vInfil;
-    RunoffTotals.runoff   += vRunoff;
+    TRunoffTotals* totals = &RunoffTotals;
+    int t = getThreadNum();
+
+    if ( t > 0 ) totals = &ThreadRunoff[t];
+    totals->rainfall += vRainfall;
+    totals->evap     += vEvap;
+    totals->infil    += vInfil;
+    totals->runoff   += vRunoff;
 }
 
 //=============================================================================
@@ -342,11 +385,70 @@ void massbal_updateGwaterTotals(double vInfil, double vUpperEvap, double vLowerE
 //  Purpose: updates groundwater totals after current time step.
 //
 {
-    GwaterTotals.infil     += vInfil;
-    GwaterTotals.upperEvap += vUpperEvap;
-    GwaterTotals.lowerEvap += vLowerEvap;
-    GwaterTotals.lowerPerc += vLowerPerc;
-    GwaterTotals.gwater    += vGwater;
+    TGwaterTotals* totals = &GwaterTotals;
+    int t = getThreadNum();
+
+    if ( t > 0 ) totals = &ThreadGwater[t];
+    totals->infil     += vInfil;
+    totals->upperEvap += vUpperEvap;
+    totals->lowerEvap += vLowerEvap;
+    totals->lowerPerc += vLowerPerc;
+    totals->gwater    += vGwater;
+}
+
+//=============================================================================
+
+void massbal_sumThreadTotals()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: adds the partial runoff, groundwater & loading totals of each
+//           runoff thread to the overall totals, in thread order.
+//
+{
+    int t, p;
+    int n = Nobjects[POLLUT];
+    TLoadingTotals* loading;
+
+    for (t = 1; t < ThreadCount; t++)
+    {
+        RunoffTotals.rainfall += ThreadRunoff[t].rainfall;
+        RunoffTotals.evap     += ThreadRunoff[t].evap;
+        RunoffTotals.infil    += ThreadRunoff[t].infil;
+        RunoffTotals.runoff   += ThreadRunoff[t].runoff;
+
+        GwaterTotals.infil     += ThreadGwater[t].infil;
+        GwaterTotals.upperEvap += ThreadGwater[t].upperEvap;
+        GwaterTotals.lowerEvap += ThreadGwater[t].lowerEvap;
+        GwaterTotals.lowerPerc += ThreadGwater[t].lowerPerc;
+        GwaterTotals.gwater    += ThreadGwater[t].gwater;
+
+        for (p = 0; p < n; p++)
+        {
+            loading = &ThreadLoading[t*n + p];
+            LoadingTotals[p].buildup    += loading->buildup;
+            LoadingTotals[p].deposition += loading->deposition;
+            LoadingTotals[p].sweeping   += loading->sweeping;
+            LoadingTotals[p].infil      += loading->infil;
+            LoadingTotals[p].bmpRemoval += loading->bmpRemoval;
+            LoadingTotals[p].runoff     += loading->runoff;
+            loading->buildup    = 0.0;
+            loading->deposition = 0.0;
+            loading->sweeping   = 0.0;
+            loading->infil      = 0.0;
+            loading->bmpRemoval = 0.0;
+            loading->runoff     = 0.0;
+        }
+        ThreadRunoff[t].rainfall = 0.0;
+        ThreadRunoff[t].evap     = 0.0;
+        ThreadRunoff[t].infil    = 0.0;
+        ThreadRunoff[t].runoff   = 0.0;
+        ThreadGwater[t].infil     = 0.0;
+        ThreadGwater[t].upperEvap = 0.0;
+        ThreadGwater[t].lowerEvap = 0.0;
+        ThreadGwater[t].lowerPerc = 0.0;
+        ThreadGwater[t].gwater    = 0.0;
+    }
 }
 
 //=============================================================================
@@ -412,14 +514,18 @@ void massbal_updateLoadingTotals(int type, int p, double w)
 //  Purpose: adds inflow mass loading to loading totals for current time step.
 //
 {
+    TLoadingTotals* totals = &LoadingTotals[p];
+    int t = getThreadNum();
+
+    if ( t > 0 ) totals = &ThreadLoading[t*Nobjects[POLLUT] + p];
     switch (type)
     {
-      case BUILDUP_LOAD:     LoadingTotals[p].buildup    += w; break;
-      case DEPOSITION_LOAD:  LoadingTotals[p].deposition += w; break;
-      case SWEEPING_LOAD:    LoadingTotals[p].sweeping   += w; break;
-      case INFIL_LOAD:       LoadingTotals[p].infil      += w; break;
-      case BMP_REMOVAL_LOAD: LoadingTotals[p].bmpRemoval += w; break;
-      case RUNOFF_LOAD:      LoadingTotals[p].runoff     += w; break;
+      case BUILDUP_LOAD:     totals->buildup    += w; break;
+      case DEPOSITION_LOAD:  totals->deposition += w; break;
+      case SWEEPING_LOAD:    totals->sweeping   += w; break;
+      case INFIL_LOAD:       totals->infil      += w; break;
+      case BMP_REMOVAL_LOAD: totals->bmpRemoval += w; break;
+      case RUNOFF_LOAD:      totals->runoff     += w; break;
     }
 }
 
@@ -958,3 +1064,19 @@ double massbal_getStoredMass(int p)
 }
 
 //=============================================================================
+
+//=============================================================================
+
+int getThreadNum()
+//
+//  Input:   none
+//  Output:  returns index of calling thread (0 for the master thread)
+//  Purpose: identifies which set of partial runoff totals a thread uses.
+//
+{
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
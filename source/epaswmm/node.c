@@ -27,6 +27,7 @@
 //-----------------------------------------------------------------------------                  
 static int     Kstar;                  // storage unit index
 static double  Vstar;                  // storage unit volume (ft3)
+#pragma omp threadprivate(Kstar, Vstar)
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
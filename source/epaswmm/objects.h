@@ -33,6 +33,8 @@
 //-----------------
 // FILE INFORMATION
 //-----------------
+typedef long long FilePos;             // byte position in a (large) file
+
 typedef struct
 {
    char          name[MAXFNAME+1];     // file name
@@ -89,9 +91,9 @@ typedef struct
    int           rainUnits;       // rain depth units (US or SI)
    double        snowFactor;      // snow catch deficiency correction
 
-   long          startFilePos;    // starting byte position in Rain file
-   long          endFilePos;      // ending byte position in Rain file
-   long          currentFilePos;  // current byte position in Rain file
+   FilePos       startFilePos;    // starting byte position in Rain file
+   FilePos       endFilePos;      // ending byte position in Rain file
+   FilePos       currentFilePos;  // current byte position in Rain file
    double        rainAccum;       // cumulative rainfall
    double        unitsFactor;     // units conversion factor (to inches or mm)
    DateTime      startDate;       // start date of current rainfall
@@ -103,6 +105,10 @@ typedef struct
    int           coGage;          // index of gage with same rain timeseries
    int           isUsed;          // TRUE if gage used by any subcatchment
    int           isCurrent;       // TRUE if gage's rainfall is current        //(5.0.012 - RD)
+   int           rainCount;       // number of intervals in rainfall vector
+   int           rainIndex;       // index of next interval in rainfall vector
+   DateTime*     rainDates;       // start dates of rainfall vector intervals
+   double*       rainRates;       // intensities of rainfall vector intervals
 }  TGage;
 
 
@@ -151,6 +157,7 @@ typedef struct
 
    double        season;          // snowmelt season
    double        removed;         // total snow plowed out of system (ft3)
+   double        rainmelt[3];     // rain melt eqn. terms at current climate
 }  TSnow;
 
 
@@ -241,6 +248,7 @@ typedef struct
    int           toSubcatch;      // index of subcatch receiving plowed snow
 
    double        dhm[3];          // melt coeff. for each surface (ft/sec-F)
+   double        dmelt[3];        // degree-day melt at current temp. (ft/sec)
 }  TSnowmelt;
 
 
@@ -294,6 +302,7 @@ typedef struct
 {
    double        fraction;        // fraction of land area with land use
    double*       buildup;         // array of buildups for each pollutant
+   double*       buildupDays;     // equivalent days of each buildup
    DateTime      lastSwept;       // date/time of last street sweeping
 }  TLandFactor;
 
@@ -324,6 +333,9 @@ typedef struct
    double        rainfall;        // current rainfall (ft/sec)
    double        losses;          // current infil + evap losses (ft/sec)
    double        runon;           // runon from other subcatchments (cfs)
+   double        oldDepth;        // ponded depth at start of time step (ft)
+   double        evapLoss;        // surface evap. over time step (ft)
+   double        infilLoss;       // infiltration over time step (ft)
    double        oldRunoff;       // previous runoff (cfs)
    double        newRunoff;       // current runoff (cfs)
    double        oldSnowDepth;    // previous snow depth (ft)
@@ -723,6 +735,7 @@ typedef struct
    int           funcType;        // buildup function type code
    double        coeff[3];        // coeffs. of buildup function
    double        maxDays;         // time to reach max. buildup (days)
+   double        extRate;         // current external buildup rate (mass/day)
 }  TBuildup;
 
 
@@ -851,6 +864,7 @@ typedef struct
    double        avgTimeStep;
    double        avgStepCount;
    double        steadyStateCount;
+   double        stepClassCount[MAXSTEPCLASSES];
 }  TSysStats;
 
 
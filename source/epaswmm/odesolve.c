@@ -24,91 +24,80 @@
 //-----------------------------------------------------------------------------
 //    Local declarations
 //-----------------------------------------------------------------------------
-int      nmax;      // max. number of equations
-double*  y;         // dependent variable
-double*  yscal;     // scaling factors
-double*  yerr;      // integration errors
-double*  ytemp;     // temporary values of y
-double*  dydx;      // derivatives of y
-double*  ak;        // derivatives at intermediate points
-
+// pointers into a caller-supplied workspace of ODE_WORKSIZE(n) doubles
+// (nothing is held between calls, so the solver is reentrant)
+typedef struct
+{
+    int      n;         // number of equations
+    double*  y;         // dependent variable
+    double*  yscal;     // scaling factors
+    double*  yerr;      // integration errors
+    double*  ytemp;     // temporary values of y
+    double*  dydx;      // derivatives of y
+    double*  ak;        // derivatives at intermediate points
+    odefunc  derivs;    // function that computes derivatives
+    void*    ctx;       // context passed to derivs
+} TOdeState;
+
+
+// function that assigns the solver's arrays to a workspace
+static void setState(TOdeState* s, int n, double work[], odefunc derivs,
+            void* ctx);
 
 // function that integrates over an error-controlled stepsize
-int rkqs(double* x, int n, double htry, double eps, double* hdid,
-         double* hnext, void (*derivs)(double, double*, double*));
+static int rkqs(TOdeState* s, double* x, double htry, double eps,
+            double* hdid, double* hnext);
 
 // function that performs the Runge-Kutta integration step
-void rkck(double x, int n, double h, void (*derivs)(double, double*, double*));
+static void rkck(TOdeState* s, double x, double h);
 
 
-//-----------------------------------------------------------------------------
-//    open the ODE solver to solve system of n equations
-//    (return 1 if successful, 0 if not)
-//-----------------------------------------------------------------------------
-int odesolve_open(int n)
+void setState(TOdeState* s, int n, double work[], odefunc derivs, void* ctx)
 {
-    nmax  = 0;
-    y     = (double *) calloc(n, sizeof(double));
-    yscal = (double *) calloc(n, sizeof(double));
-    dydx  = (double *) calloc(n, sizeof(double));
-    yerr  = (double *) calloc(n, sizeof(double));
-    ytemp = (double *) calloc(n, sizeof(double));
-    ak    = (double *) calloc(5*n, sizeof(double));
-    if ( !y || !yscal || !dydx || !yerr || !ytemp || !ak ) return 0;
-    nmax = n;
-    return 1;
-}
-
-
-//-----------------------------------------------------------------------------
-//    close the ODE solver
-//-----------------------------------------------------------------------------
-void odesolve_close()
-{
-    if ( y ) free(y);
-    y = NULL;
-    if ( yscal ) free(yscal);
-    yscal = NULL;
-    if ( dydx ) free(dydx);
-    dydx = NULL;
-    if ( yerr ) free(yerr);
-    yerr = NULL;
-    if ( ytemp ) free(ytemp);
-    ytemp = NULL;
-    if ( ak ) free(ak);
-    ak = NULL;
-    nmax = 0;
+    s->n      = n;
+    s->y      = work;
+    s->yscal  = work + n;
+    s->yerr   = work + 2*n;
+    s->ytemp  = work + 3*n;
+    s->dydx   = work + 4*n;
+    s->ak     = work + 5*n;
+    s->derivs = derivs;
+    s->ctx    = ctx;
 }
 
 
 int odesolve_integrate(double ystart[], int n, double x1, double x2,
-      double eps, double h1, void (*derivs)(double, double*, double*))
+      double eps, double h1, odefunc derivs, void* ctx, double work[])
 //---------------------------------------------------------------
 //   Driver function for Runge-Kutta integration with adaptive
 //   stepsize control. Integrates starting n values in ystart[]
 //   from x1 to x2 with accuracy eps. h1 is the initial stepsize
 //   guess and derivs is a user-supplied function that computes
-//   derivatives dy/dx of y. On completion, ystart[] contains the
-//   new values of y at the end of the integration interval.
+//   derivatives dy/dx of y, to which ctx is passed unchanged.
+//   work[] is a caller-supplied array of ODE_WORKSIZE(n) doubles.
+//   On completion, ystart[] contains the new values of y at the
+//   end of the integration interval.
 //---------------------------------------------------------------
 {
     int    i, errcode, nstp;
     double hdid, hnext;
     double x = x1;
     double h = h1;
-    if (nmax < n) return 1;
-    for (i=0; i<n; i++) y[i] = ystart[i];
+    TOdeState s;
+
+    setState(&s, n, work, derivs, ctx);
+    for (i=0; i<n; i++) s.y[i] = ystart[i];
     for (nstp=1; nstp<=MAXSTP; nstp++)
     {
-        derivs(x,y,dydx);
+        derivs(x, s.y, s.dydx, ctx);
         for (i=0; i<n; i++)
-            yscal[i] = fabs(y[i]) + fabs(dydx[i]*h) + TINY;
+            s.yscal[i] = fabs(s.y[i]) + fabs(s.dydx[i]*h) + TINY;
         if ((x+h-x2)*(x+h-x1) > 0.0) h = x2 - x;
-        errcode = rkqs(&x,n,h,eps,&hdid,&hnext,derivs);
+        errcode = rkqs(&s,&x,h,eps,&hdid,&hnext);
         if (errcode) break;
         if ((x-x2)*(x2-x1) >= 0.0)
         {
-            for (i=0; i<n; i++) ystart[i] = y[i];
+            for (i=0; i<n; i++) ystart[i] = s.y[i];
             return 0;
         }
         if (fabs(hnext) <= 0.0) return 2;
@@ -118,8 +107,8 @@ int odesolve_integrate(double ystart[], int n, double x1, double x2,
 }
 
 
-int rkqs(double* x, int n, double htry, double eps, double* hdid,
-         double* hnext, void (*derivs)(double, double*, double*))
+int rkqs(TOdeState* s, double* x, double htry, double eps, double* hdid,
+         double* hnext)
 //---------------------------------------------------------------
 //   Fifth-order Runge-Kutta integration step with monitoring of
 //   local truncation error to assure accuracy and adjust stepsize.
@@ -128,7 +117,7 @@ int rkqs(double* x, int n, double htry, double eps, double* hdid,
 //   next stepsize (hnext). Also updated are the values of y[].
 //---------------------------------------------------------------
 {
-    int i;
+    int i, n = s->n;
     double err, errmax, h, htemp, xnew, xold = *x;
 
     // --- set initial stepsize
@@ -136,13 +125,13 @@ int rkqs(double* x, int n, double htry, double eps, double* hdid,
     for (;;)
     {
         // --- take a Runge-Kutta-Cash-Karp step
-        rkck(xold, n, h, derivs);
+        rkck(s, xold, h);
 
         // --- compute scaled maximum error
         errmax = 0.0;
         for (i=0; i<n; i++)
         {
-            err = fabs(yerr[i]/yscal[i]);
+            err = fabs(s->yerr[i]/s->yscal[i]);
             if (err > errmax) errmax = err;
         }
         errmax /= eps;
@@ -172,14 +161,14 @@ int rkqs(double* x, int n, double htry, double eps, double* hdid,
             if (errmax > ERRCON) *hnext = SAFETY*h*pow(errmax,PGROW);
             else *hnext = 5.0*h;
             *x += (*hdid=h);
-            for (i=0; i<n; i++) y[i] = ytemp[i];
+            for (i=0; i<n; i++) s->y[i] = s->ytemp[i];
             return 0;
         }
     }
 }
 
 
-void rkck(double x, int n, double h, void (*derivs)(double, double*, double*))
+void rkck(TOdeState* s, double x, double h)
 //----------------------------------------------------------------------
 //   Uses the Runge-Kutta-Cash-Karp method to advance y[] at x
 //   over stepsize h.
@@ -194,7 +183,9 @@ void rkck(double x, int n, double h, void (*derivs)(double, double*, double*))
            dc5= -277.0/14336.0;
     double dc1=c1-2825.0/27648.0, dc3=c3-18575.0/48384.0,
            dc4=c4-13525.0/55296.0, dc6=c6-0.25;
-    int i;
+    int i, n = s->n;
+    double *y = s->y, *ytemp = s->ytemp, *dydx = s->dydx, *yerr = s->yerr;
+    double *ak = s->ak;
     double *ak2 = (ak);
     double *ak3 = ((ak)+(n));
     double *ak4 = ((ak)+(2*n));
@@ -203,24 +194,24 @@ void rkck(double x, int n, double h, void (*derivs)(double, double*, double*))
 
     for (i=0; i<n; i++)
         ytemp[i] = y[i] + b21*h*dydx[i];
-    derivs(x+a2*h,ytemp,ak2);
+    s->derivs(x+a2*h,ytemp,ak2,s->ctx);
 
     for (i=0; i<n; i++)
         ytemp[i] = y[i] + h*(b31*dydx[i]+b32*ak2[i]);
-    derivs(x+a3*h,ytemp,ak3);
+    s->derivs(x+a3*h,ytemp,ak3,s->ctx);
 
     for (i=0; i<n; i++)
         ytemp[i] = y[i] + h*(b41*dydx[i]+b42*ak2[i] + b43*ak3[i]);
-    derivs(x+a4*h,ytemp,ak4);
+    s->derivs(x+a4*h,ytemp,ak4,s->ctx);
 
     for (i=0; i<n; i++)
         ytemp[i] = y[i] + h*(b51*dydx[i]+b52*ak2[i] + b53*ak3[i] + b54*ak4[i]);
-    derivs(x+a5*h,ytemp,ak5);
+    s->derivs(x+a5*h,ytemp,ak5,s->ctx);
 
     for (i=0; i<n; i++)
         ytemp[i] = y[i] + h*(b61*dydx[i]+b62*ak2[i] + b63*ak3[i] + b64*ak4[i]
                    + b65*ak5[i]);
-    derivs(x+a6*h,ytemp,ak6);
+    s->derivs(x+a6*h,ytemp,ak6,s->ctx);
 
     for (i=0; i<n; i++)
         ytemp[i] = y[i] + h*(c1*dydx[i] + c3*ak3[i] + c4*ak4[i] + c6*ak6[i]);
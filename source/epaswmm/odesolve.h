@@ -5,8 +5,17 @@
 //
 //-----------------------------------------------------------------------------
 
-// functions that open, close, and use the ODE solver
-int  odesolve_open(int n);
-void odesolve_close(void);
+// size of the workspace (in doubles) the caller supplies for n equations
+#define ODE_WORKSIZE(n) (10*(n))
+
+// function that computes derivatives dydx at x for values y, given the
+// context pointer passed to the solver
+typedef void (*odefunc)(double x, double* y, double* dydx, void* ctx);
+
+// functions that use the ODE solver
+// (the solver keeps no state of its own, so independent systems can be
+//  integrated concurrently as long as each has its own work array; there
+//  is no batched entry point since runoff and groundwater integrate one
+//  subarea or subcatchment at a time from within their own loops)
 int  odesolve_integrate(double ystart[], int n, double x1, double x2,
-     double eps, double h1, void (*derivs)(double, double*, double*));
+     double eps, double h1, odefunc derivs, void* ctx, double work[]);
@@ -13,9 +13,11 @@
 //   Binary output file access functions.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
+#define _FILE_OFFSET_BITS 64
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "headers.h"
 
 
@@ -30,10 +32,10 @@ enum InputDataType {INPUT_TYPE_CODE, INPUT_AREA, INPUT_INVERT, INPUT_MAX_DEPTH,
 //-----------------------------------------------------------------------------
 //  Shared variables    
 //-----------------------------------------------------------------------------
-static INT4      IDStartPos;           // starting file position of ID names
-static INT4      InputStartPos;        // starting file position of input data
-static INT4      OutputStartPos;       // starting file position of output data
-static INT4      BytesPerPeriod;       // bytes saved per simulation time period
+static FilePos   IDStartPos;           // starting file position of ID names
+static FilePos   InputStartPos;        // starting file position of input data
+static FilePos   OutputStartPos;       // starting file position of output data
+static FilePos   BytesPerPeriod;       // bytes saved per simulation time period
 static INT4      NsubcatchResults;     // number of subcatchment output variables
 static INT4      NnodeResults;         // number of node output variables
 static INT4      NlinkResults;         // number of link output variables
@@ -114,9 +116,9 @@ int output_open()
 
 
     BytesPerPeriod = sizeof(REAL8)                                             //(5.0.014 - LR)
-        + NumSubcatch * NsubcatchResults * sizeof(REAL4)                       //(5.0.014 - LR)
-        + NumNodes * NnodeResults * sizeof(REAL4)                              //(5.0.014 - LR)
-        + NumLinks * NlinkResults * sizeof(REAL4)                              //(5.0.014 - LR)
+        + (FilePos)NumSubcatch * NsubcatchResults * sizeof(REAL4)              //(5.0.014 - LR)
+        + (FilePos)NumNodes * NnodeResults * sizeof(REAL4)                     //(5.0.014 - LR)
+        + (FilePos)NumLinks * NlinkResults * sizeof(REAL4)                     //(5.0.014 - LR)
         + MAX_SYS_RESULTS * sizeof(REAL4);
     Nperiods = 0;
 
@@ -149,7 +151,7 @@ int output_open()
     fwrite(&k, sizeof(INT4), 1, Fout.file);   // # pollutants
 
     // --- save ID names of subcatchments, nodes, links, & pollutants          //(5.0.014 - LR)
-    IDStartPos = ftell(Fout.file);
+    IDStartPos = FTELL64(Fout.file);
     for (j=0; j<Nobjects[SUBCATCH]; j++)
     {
         if ( Subcatch[j].rptFlag ) output_saveID(Subcatch[j].ID, Fout.file);
@@ -171,7 +173,7 @@ int output_open()
         fwrite(&k, sizeof(INT4), 1, Fout.file);
     }
 
-    InputStartPos = ftell(Fout.file);
+    InputStartPos = FTELL64(Fout.file);
 
     // --- save subcatchment area
     k = 1;
@@ -333,7 +335,7 @@ int output_open()
         report_writeErrorMsg(ERR_OUT_WRITE, "");
         return ErrorCode;
     }
-    OutputStartPos = ftell(Fout.file);
+    OutputStartPos = FTELL64(Fout.file);
     if ( Fout.mode == SCRATCH_FILE ) output_checkFileSize();                   //(5.0.015 - LR)
     return ErrorCode;
 }
@@ -346,16 +348,18 @@ void  output_checkFileSize()
 //
 //  Input:   none
 //  Output:  none
-//  Purpose: checks if the size of the binary output file will be too big
-//           to access using an integer file pointer variable.
+//  Purpose: checks if the binary output file will hold more reporting
+//           periods than can be counted in its 4-byte period count.
+//
+//  Note: file positions are 64-bit, so the size of the file itself is
+//        no longer limited to MAXFILESIZE bytes (see output_end).
 //
 {
     if ( RptFlags.subcatchments != NONE ||
          RptFlags.nodes != NONE ||
          RptFlags.links != NONE )
     {
-        if ( (double)OutputStartPos + (double)BytesPerPeriod * TotalDuration
-             / 1000.0 / (double)ReportStep >= (double)MAXFILESIZE )
+        if ( TotalDuration / 1000.0 / (double)ReportStep >= (double)INT_MAX )
         {
             report_writeErrorMsg(ERR_FILE_SIZE, "");
         }
@@ -430,16 +434,36 @@ void output_end()
 //  Output:  none
 //  Purpose: writes closing records to binary file.
 //
+//  Note: a file no larger than MAXFILESIZE bytes saves the starting
+//        positions of its sections as 4-byte integers and ends with
+//        MAGICNUMBER, as in earlier versions. A larger file saves them
+//        as 8-byte integers and ends with MAGICNUMBER64, so that readers
+//        can tell which layout of closing records was used.
+//
 {
     INT4 k;
-    fwrite(&IDStartPos, sizeof(INT4), 1, Fout.file);
-    fwrite(&InputStartPos, sizeof(INT4), 1, Fout.file);
-    fwrite(&OutputStartPos, sizeof(INT4), 1, Fout.file);
+    int  isLarge = ( FTELL64(Fout.file) > MAXFILESIZE );
+    if ( isLarge )
+    {
+        fwrite(&IDStartPos, sizeof(FilePos), 1, Fout.file);
+        fwrite(&InputStartPos, sizeof(FilePos), 1, Fout.file);
+        fwrite(&OutputStartPos, sizeof(FilePos), 1, Fout.file);
+    }
+    else
+    {
+        k = (INT4)IDStartPos;
+        fwrite(&k, sizeof(INT4), 1, Fout.file);
+        k = (INT4)InputStartPos;
+        fwrite(&k, sizeof(INT4), 1, Fout.file);
+        k = (INT4)OutputStartPos;
+        fwrite(&k, sizeof(INT4), 1, Fout.file);
+    }
     k = Nperiods;
     fwrite(&k, sizeof(INT4), 1, Fout.file);
     k = (INT4)error_getCode(ErrorCode);
     fwrite(&k, sizeof(INT4), 1, Fout.file);
-    k = MAGICNUMBER;
+    if ( isLarge ) k = MAGICNUMBER64;
+    else           k = MAGICNUMBER;
     if (fwrite(&k, sizeof(INT4), 1, Fout.file) < 1)
     {
         report_writeErrorMsg(ERR_OUT_WRITE, "");
@@ -619,8 +643,8 @@ void output_readDateTime(int period, DateTime* days)
 //           from the binary output file.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
-    fseek(Fout.file, bytePos, SEEK_SET);
+    FilePos bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
+    FSEEK64(Fout.file, bytePos, SEEK_SET);
     *days = NO_DATE;
     fread(days, sizeof(REAL8), 1, Fout.file);
 }
@@ -636,9 +660,9 @@ void output_readSubcatchResults(int period, int index)
 //           period.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
+    FilePos bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
     bytePos += sizeof(REAL8) + index*NsubcatchResults*sizeof(REAL4);
-    fseek(Fout.file, bytePos, SEEK_SET);
+    FSEEK64(Fout.file, bytePos, SEEK_SET);
     fread(SubcatchResults, sizeof(REAL4), NsubcatchResults, Fout.file);
 }
 
@@ -652,10 +676,10 @@ void output_readNodeResults(int period, int index)
 //  Purpose: reads computed results for a node at a specific time period.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
+    FilePos bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
     bytePos += sizeof(REAL8) + NumSubcatch*NsubcatchResults*sizeof(REAL4);     //(5.0.014 - LR)
     bytePos += index*NnodeResults*sizeof(REAL4);
-    fseek(Fout.file, bytePos, SEEK_SET);
+    FSEEK64(Fout.file, bytePos, SEEK_SET);
     fread(NodeResults, sizeof(REAL4), NnodeResults, Fout.file);
 }
 
@@ -669,11 +693,11 @@ void output_readLinkResults(int period, int index)
 //  Purpose: reads computed results for a link at a specific time period.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
+    FilePos bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
     bytePos += sizeof(REAL8) + NumSubcatch*NsubcatchResults*sizeof(REAL4);     //(5.0.014 - LR)
     bytePos += NumNodes*NnodeResults*sizeof(REAL4);                            //(5.0.014 - LR)
     bytePos += index*NlinkResults*sizeof(REAL4);
-    fseek(Fout.file, bytePos, SEEK_SET);
+    FSEEK64(Fout.file, bytePos, SEEK_SET);
     fread(LinkResults, sizeof(REAL4), NlinkResults, Fout.file);
     fread(SysResults, sizeof(REAL4), MAX_SYS_RESULTS, Fout.file);
 }
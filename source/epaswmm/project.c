@@ -480,10 +480,20 @@ int project_readOption(char* s1, char* s2)
         else InertDamping = m;
         break;
 
+      // --- method used to solve the dynamic wave equations
+      case DYNWAVE_SOLVER:
+        m = findmatch(s2, DynWaveSolverWords);
+        if ( m < 0 ) return error_setInpError(ERR_KEYWORD, s2);
+        DynWaveSolver = m;
+        break;
+
       // --- Yes/No options (NO = 0, YES = 1)                                  //(5.0.014 - LR)
       case ALLOW_PONDING:
       case SLOPE_WEIGHTING:
       case SKIP_STEADY_STATE:
+      case FAST_FORWARD_DRY:
+      case IMPLICIT_PONDING:
+      case INPUT_CACHE:
       case IGNORE_RAINFALL:
       case IGNORE_SNOWMELT:                                                    //(5.0.014 - LR)
       case IGNORE_GWATER:                                                      //(5.0.014 - LR)
@@ -496,6 +506,9 @@ int project_readOption(char* s1, char* s2)
           case ALLOW_PONDING:     AllowPonding    = m;  break;
           case SLOPE_WEIGHTING:   SlopeWeighting  = m;  break;
           case SKIP_STEADY_STATE: SkipSteadyState = m;  break;
+          case FAST_FORWARD_DRY:  FastForwardDry  = m;  break;
+          case IMPLICIT_PONDING:  ImplicitPonding = m;  break;
+          case INPUT_CACHE:       InputCache      = m;  break;
           case IGNORE_RAINFALL:   IgnoreRainfall  = m;  break;
           case IGNORE_SNOWMELT:   IgnoreSnowmelt  = m;  break;                 //(5.0.014 - LR)
           case IGNORE_GWATER:     IgnoreGwater    = m;  break;                 //(5.0.014 - LR)
@@ -570,6 +583,16 @@ int project_readOption(char* s1, char* s2)
             return error_setInpError(ERR_NUMBER, s2);
         break;
 
+      // --- number of time step classes that conduits are sorted into
+      //     under variable step dynamic wave routing (a value of 1 means
+      //     that all links use the same time step)
+      case STEP_CLASSES:
+        if ( !getInt(s2, &StepClasses) )
+            return error_setInpError(ERR_NUMBER, s2);
+        if ( StepClasses < 1 || StepClasses > MAXSTEPCLASSES )
+            return error_setInpError(ERR_NUMBER, s2);
+        break;
+
       // --- minimum surface area (ft2 or sq. meters) associated with nodes
       //     under dynamic wave flow routing 
       case MIN_SURFAREA:
@@ -672,6 +695,8 @@ void setDefaults()
    RouteModel      = KW;               // Kin. wave flow routing method
    AllowPonding    = FALSE;            // No ponding at nodes
    InertDamping    = SOME;             // Partial inertial damping
+   DynWaveSolver   = PICARD;           // Successive approx. dyn. wave solver
+   StepClasses     = 1;                // Single time step for all links
    NormalFlowLtd   = BOTH;             // Default normal flow limitation       //(5.0.010 - LR)
    ForceMainEqn    = H_W;              // Hazen-Williams eqn. for force mains  //(5.0.010 - LR)
    LinkOffsets     = DEPTH_OFFSET;     // Use depth for link offsets           //(5.0.012 - LR)
@@ -679,6 +704,9 @@ void setDefaults()
    CourantFactor   = 0.0;              // No variable time step 
    MinSurfArea     = 0.0;              // Use default min. nodal surface area
    SkipSteadyState = FALSE;            // Do flow routing in steady state periods 
+   FastForwardDry  = FALSE;            // Use normal time steps in dry periods
+   ImplicitPonding = FALSE;            // Integrate ponded depth with ODE solver
+   InputCache      = TRUE;             // Cache input file's parsed lines
    IgnoreRainfall  = FALSE;            // Analyze rainfall/runoff
    IgnoreSnowmelt  = FALSE;            // Analyze snowmelt                     //(5.0.014 - LR)
    IgnoreGwater    = FALSE;            // Analyze groundwater                  //(5.0.014 - LR)
@@ -895,6 +923,8 @@ void createObjects()
         {
             Subcatch[j].landFactor[k].buildup =
                 (double *) calloc(Nobjects[POLLUT], sizeof(double));
+            Subcatch[j].landFactor[k].buildupDays =
+                (double *) calloc(Nobjects[POLLUT], sizeof(double));
         }
     }
 
@@ -983,6 +1013,7 @@ void deleteObjects()
         for (k = 0; k < Nobjects[LANDUSE]; k++)
         {
             FREE(Subcatch[j].landFactor[k].buildup);
+            FREE(Subcatch[j].landFactor[k].buildupDays);
         }
         FREE(Subcatch[j].landFactor);
         FREE(Subcatch[j].groundwater);
@@ -1029,6 +1060,9 @@ void deleteObjects()
         treatmnt_delete(j);
     }
 
+    // --- free memory used for rain gage rainfall vectors
+    if ( Gage ) for (j = 0; j < Nobjects[GAGE]; j++) gage_delete(j);
+
     // --- delete table entries for curves and time series
     if ( Tseries ) for (j = 0; j < Nobjects[TSERIES]; j++)
         table_deleteEntries(&Tseries[j]);
@@ -31,7 +31,7 @@
 //     File stamp ("SWMM5-RAIN") (10 bytes)
 //     Number of SWMM rain gages in file (4-byte int)
 //     Repeated for each rain gage:
-//       recording station ID (not SWMM rain gage ID) (MAXMSG+1 (=80) bytes)
+//       recording station ID (not SWMM rain gage ID) (MAXMSG+1 bytes)
 //       gage recording interval (seconds) (4-byte int)
 //       starting byte of rain data in file (4-byte int)
 //       ending byte+1 of rain data in file (4-byte int)
@@ -39,11 +39,24 @@
 //       For each time period with non-zero rain:
 //         Date/time for start of period (8-byte double)
 //         Rain depth (inches) (4-byte float)
+//   A file larger than MAXFILESIZE bytes is stamped "SWMM5-RN64" instead
+//   and uses 8-byte ints for the starting and ending bytes of each gage's
+//   data.
+//
+//   The data files of all gages are read concurrently into memory before
+//   the interface file is written. The data read for each gage are also
+//   cached in a file placed next to the gage's data file, named
+//   <data file>.<hash>.rfc where <hash> is an 8-digit hex (djb2) hash of
+//   the station ID, dates and rainfall type, interval and units read. The
+//   cache is re-used for as long as the data file's size and time of last
+//   modification stay the same and a checksum of its contents matches.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
+#define _FILE_OFFSET_BITS 64
 
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include "headers.h"
 
 //-----------------------------------------------------------------------------
@@ -55,21 +68,44 @@ enum RainFileFormat {UNKNOWN_FORMAT, NWS_TAPE, NWS_SPACE_DELIMITED,
 enum ConditionCodes {NO_CONDITION, ACCUMULATED_PERIOD, DELETED_PERIOD,
                      MISSING_PERIOD};
 
+#define RAIN_RECD_SIZE (sizeof(DateTime) + sizeof(float)) // bytes per record
+
 //-----------------------------------------------------------------------------
-//  Shared variables
+//  Data Structures
 //-----------------------------------------------------------------------------
-TRainStats RainStats;                  // see objects.h for definition
-int        Condition;                  // rainfall condition code
-int        TimeOffset;                 // time offset of rainfall reading (sec)
-int        RainType;                   // rain measurement type code
-int        Interval;                   // rain measurement interval (sec)
-double     UnitsFactor;                // units conversion factor
-float      RainAccum;                  // rainfall depth accumulation
-char       *StationID;                 // station ID appearing in rain file
-DateTime   AccumStartDate;             // date when accumulation begins        //(5.0.010 - LR)
-DateTime   PreviousDate;               // date of previous rainfall record     //(5.0.022 - LR)
-int        GageIndex;                  // index of rain gage analyzed          //(5.0.022 - LR)
-int        hasStationName;             // true if data contains station name   //(5.0.015 - LR)
+typedef struct                         // State of a gage's rain data file
+{                                      // -------------------------------------
+   int        gage;                    // index of first gage using the data
+   int        condition;               // rainfall condition code
+   int        timeOffset;              // time offset of rainfall reading (sec)
+   int        rainType;                // rain measurement type code
+   int        interval;                // rain measurement interval (sec)
+   double     unitsFactor;             // units conversion factor
+   float      rainAccum;               // rainfall depth accumulation
+   char*      stationID;               // station ID appearing in rain file
+   DateTime   accumStartDate;          // date when accumulation begins
+   DateTime   previousDate;            // date of previous rainfall record
+   int        hasStationName;          // true if data contains station name
+   TRainStats stats;                   // summary of rain data read
+   char*      data;                    // rain records read (date & depth)
+   size_t     size;                    // bytes of rain records read
+   size_t     capacity;                // bytes allocated for rain records
+   FilePos    filePos;                 // position of records in Rain file
+   int        errCode;                 // error code from reading data file
+   char*      errLine;                 // data line that caused the error
+}  TRainReader;
+
+typedef struct                         // Identifies data in a rain cache file
+{                                      // -------------------------------------
+   FilePos    fileSize;                // size of rain data file (bytes)
+   FilePos    fileTime;                // time data file was last modified
+   DateTime   startFileDate;           // starting date of data read
+   DateTime   endFileDate;             // ending date of data read
+   int        rainType;                // intensity, volume, cumulative
+   int        rainInterval;            // recording time interval (seconds)
+   int        rainUnits;               // rain depth units (US or SI)
+   char       staID[MAXMSG+1];         // station number
+}  TRainCacheKey;
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
@@ -83,23 +119,33 @@ int        hasStationName;             // true if data contains station name   /
 static void createRainFile(int count);
 static int  rainFileConflict(int i);                                           //(5.0.019 - LR)              
 static void initRainFile(void);
-static int  findGageInFile(int i, int kount);
-static int  addGageToRainFile(int i);
-static int  findFileFormat(FILE *f, int i, int *hdrLines);
-static void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
-            DateTime day2);
-static int  readNWSLine(char *line, int fileFormat, DateTime day1,
+static int  findGageInFile(int i, int kount, int posSize);
+static int  findReader(TRainReader* readers, int n, int i);
+static int  reportReadError(TRainReader* r);
+static void readGageData(TRainReader* r);
+static int  getCacheKey(int i, TRainCacheKey* key, char* cacheName);
+static int  readCacheFile(TRainReader* r, TRainCacheKey* key, char* cacheName);
+static void saveCacheFile(TRainReader* r, TRainCacheKey* key, char* cacheName);
+static unsigned long long getCacheChecksum(TRainReader* r, int interval,
+            size_t size);
+static int  findFileFormat(FILE *f, TRainReader* r, int *hdrLines);
+static void readFile(FILE *f, TRainReader* r, int fileFormat, int hdrLines,
+            DateTime day1, DateTime day2);
+static int  readNWSLine(TRainReader* r, char *line, int fileFormat,
+            DateTime day1, DateTime day2);
+static int  readCMCLine(TRainReader* r, char *line, int fileFormat,
+            DateTime day1, DateTime day2);
+static int  readStdLine(TRainReader* r, char *line, DateTime day1,
             DateTime day2);
-static int  readCMCLine(char *line, int fileFormat, DateTime day1,
-            DateTime day2);
-static int  readStdLine(char *line, DateTime day1, DateTime day2);
-static void saveAccumRainfall(DateTime date1, int hour, int minute, long v);   //(5.0.010 - LR)
-static void saveRainfall(DateTime date1, int hour, int minute, float x,
-            char isMissing);
-static void setCondition(char flag);
+static void saveAccumRainfall(TRainReader* r, DateTime date1, int hour,
+            int minute, long v);
+static void saveRainfall(TRainReader* r, DateTime date1, int hour, int minute,
+            float x, char isMissing);
+static void addRainRecord(TRainReader* r, DateTime date, float x);
+static void setCondition(TRainReader* r, char flag);
 static int  getNWSInterval(char *elemType);
-static int  parseStdLine(char *line, int *year, int *month, int *day,
-            int *hour, int *minute, float *value);
+static int  parseStdLine(char *line, char *staID, int *year, int *month,
+            int *day, int *hour, int *minute, float *value);
 
 //=============================================================================
 
@@ -185,8 +231,6 @@ void rain_close(void)
     rdii_closeRdii();
 }
 
-//=============================================================================
-
 void createRainFile(int count)
 //
 //  Input:   count = number of files to include in rain interface file
@@ -194,63 +238,131 @@ void createRainFile(int count)
 //  Purpose: adds rain data from all rain gage files to the interface file.
 //
 {
-    int   i, k;
+    int   i, k, n;
     int   kount = count;               // number of gages in data file
-    int   filePos1;                    // starting byte of gage's header data
-    int   filePos2;                    // starting byte of gage's rain data
-    int   filePos3;                    // starting byte of next gage's data
     int   interval;                    // recording interval (sec)
-    int   dummy = -1;
+    int*  readerIndex;                 // index of reader used by each gage
+    FilePos filePos;                   // starting byte of rain data
+    FilePos endPos;                    // ending byte of rain data
     char  staID[MAXMSG+1];             // gage's ID name
-    char  fileStamp[] = "SWMM5-RAIN";
+    int   pos1, pos2;                  // 4-byte copies of filePos & endPos
+    int   posSize;                     // bytes used to store a file position
+    FilePos dataSize;                  // bytes of rain data of all gages
+    char  fileStamp[] = "SWMM5-RAIN";  // stamp of file with 32-bit positions
+    char  fileStamp64[] = "SWMM5-RN64";// stamp of file with 64-bit positions
+    TRainReader* readers;              // readers of the gages' data files
+    TRainReader* r;
 
     // --- make sure interface file is open and no error condition
     if ( ErrorCode || !Frain.file ) return;
 
-    // --- write file stamp & # gages to file
-    fwrite(fileStamp, sizeof(char), strlen(fileStamp), Frain.file);
-    fwrite(&kount, sizeof(int), 1, Frain.file);
-    filePos1 = ftell(Frain.file); 
-
-    // --- write default fill-in header records to file for each gage
-    //     (will be replaced later with actual records)
-    if ( count > 0 ) report_writeRainStats(-1, &RainStats);
-    for ( i = 0;  i < count; i++ )
+    // --- assign a reader to each distinct data file & station
+    //     (gages that share both share the same reader)
+    readers = (TRainReader *) calloc(count, sizeof(TRainReader));
+    readerIndex = (int *) calloc(Nobjects[GAGE], sizeof(int));
+    if ( !readers || !readerIndex )
     {
-        fwrite(staID, sizeof(char), MAXMSG+1, Frain.file);
-        for ( k = 1; k <= 3; k++ )
-            fwrite(&dummy, sizeof(int), 1, Frain.file);
+        FREE(readers);
+        FREE(readerIndex);
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+    n = 0;
+    for ( i = 0; i < Nobjects[GAGE]; i++ )
+    {
+        readerIndex[i] = -1;
+        if ( Gage[i].dataSource != RAIN_FILE ) continue;
+        k = findReader(readers, n, i);
+        if ( k < 0 )
+        {
+            k = n;
+            readers[k].gage = i;
+            n++;
+        }
+        readerIndex[i] = k;
     }
-    filePos2 = ftell(Frain.file);
 
-    // --- loop through project's  rain gages,
-    //     looking for ones using rain files
+    // --- read the data files of all readers concurrently
+    #pragma omp parallel for schedule(dynamic) if(n > 1)
+    for ( k = 0; k < n; k++ ) readGageData(&readers[k]);
+
+    // --- report the data read for each gage
+    if ( count > 0 ) report_writeRainStats(-1, &readers[0].stats);
     for ( i = 0; i < Nobjects[GAGE]; i++ )
     {
-        if ( ErrorCode || Gage[i].dataSource != RAIN_FILE ) continue;
+        if ( readerIndex[i] < 0 ) continue;
         if ( rainFileConflict(i) ) break;                                      //(5.0.019 - LR)
+        r = &readers[readerIndex[i]];
+        if ( reportReadError(r) ) break;
+        Gage[i].rainInterval = r->interval;
+        report_writeRainStats(i, &r->stats);
+    }
 
-        // --- position rain file to where data for gage will begin
-        fseek(Frain.file, filePos2, SEEK_SET);
-
-        // --- add gage's data to rain file
-        if ( addGageToRainFile(i) )
+    // --- write file stamp, # gages & each gage's header record to file
+    //     (file positions are saved as 4-byte ints, as in earlier versions,
+    //     unless the file will be larger than MAXFILESIZE bytes)
+    if ( !ErrorCode )
+    {
+        dataSize = 0;
+        for ( k = 0; k < n; k++ ) dataSize += readers[k].size;
+        filePos = FTELL64(Frain.file) + strlen(fileStamp) + sizeof(int);
+        if ( filePos + dataSize + (FilePos)count *
+             (MAXMSG+1 + sizeof(int) + 2*sizeof(int)) > MAXFILESIZE )
         {
-            // --- write header records for gage to beginning of rain file
-            filePos3 = ftell(Frain.file);
-            fseek(Frain.file, filePos1, SEEK_SET);
+            posSize = sizeof(FilePos);
+            fwrite(fileStamp64, sizeof(char), strlen(fileStamp64), Frain.file);
+        }
+        else
+        {
+            posSize = sizeof(int);
+            fwrite(fileStamp, sizeof(char), strlen(fileStamp), Frain.file);
+        }
+        fwrite(&kount, sizeof(int), 1, Frain.file);
+        filePos += (FilePos)count * (MAXMSG+1 + sizeof(int) + 2*posSize);
+        for ( k = 0; k < n; k++ )
+        {
+            readers[k].filePos = filePos;
+            filePos += readers[k].size;
+        }
+        for ( i = 0; i < Nobjects[GAGE]; i++ )
+        {
+            if ( readerIndex[i] < 0 ) continue;
+            r = &readers[readerIndex[i]];
             sstrncpy(staID, Gage[i].staID, MAXMSG);
-            interval = Interval;
-            fwrite(staID,      sizeof(char), MAXMSG+1, Frain.file);
-            fwrite(&interval,  sizeof(int), 1, Frain.file);
-            fwrite(&filePos2,  sizeof(int), 1, Frain.file);
-            fwrite(&filePos3,  sizeof(int), 1, Frain.file);
-            filePos1 = ftell(Frain.file);
-            filePos2 = filePos3;
-            report_writeRainStats(i, &RainStats);
+            interval = r->interval;
+            endPos = r->filePos + r->size;
+            fwrite(staID,       sizeof(char), MAXMSG+1, Frain.file);
+            fwrite(&interval,   sizeof(int), 1, Frain.file);
+            if ( posSize == sizeof(FilePos) )
+            {
+                fwrite(&r->filePos, sizeof(FilePos), 1, Frain.file);
+                fwrite(&endPos,     sizeof(FilePos), 1, Frain.file);
+            }
+            else
+            {
+                pos1 = (int)r->filePos;
+                pos2 = (int)endPos;
+                fwrite(&pos1, sizeof(int), 1, Frain.file);
+                fwrite(&pos2, sizeof(int), 1, Frain.file);
+            }
+        }
+
+        // --- then write the rain data of each reader in turn
+        for ( k = 0; k < n; k++ )
+        {
+            fwrite(readers[k].data, 1, readers[k].size, Frain.file);
         }
     }
 
+    // --- free the readers
+    for ( k = 0; k < n; k++ )
+    {
+        FREE(readers[k].data);
+        FREE(readers[k].errLine);
+    }
+    FREE(readers);
+    FREE(readerIndex);
+
     // --- if there was an error condition, then delete newly created file
     if ( ErrorCode )
     {
@@ -262,6 +374,56 @@ void createRainFile(int count)
 
 //=============================================================================
 
+int findReader(TRainReader* readers, int n, int i)
+//
+//  Input:   readers = readers of rain data files
+//           n = number of readers
+//           i = rain gage index
+//  Output:  returns index of reader that reads the same data as gage i
+//           or -1 if there is none
+//  Purpose: finds a reader whose data can be shared with a rain gage.
+//
+{
+    int k, j;
+    for ( k = 0; k < n; k++ )
+    {
+        j = readers[k].gage;
+        if ( strcomp(Gage[j].fname, Gage[i].fname) &&
+             strcmp(Gage[j].staID, Gage[i].staID) == 0 &&
+             Gage[j].startFileDate == Gage[i].startFileDate &&
+             Gage[j].endFileDate == Gage[i].endFileDate &&
+             Gage[j].rainType == Gage[i].rainType &&
+             Gage[j].rainInterval == Gage[i].rainInterval &&
+             Gage[j].rainUnits == Gage[i].rainUnits ) return k;
+    }
+    return -1;
+}
+
+//=============================================================================
+
+int reportReadError(TRainReader* r)
+//
+//  Input:   r = reader of a gage's rain data file
+//  Output:  returns 1 if the reader had an error, 0 if not
+//  Purpose: reports any error that occurred while reading a rain data file.
+//
+{
+    if ( r->errCode == 0 ) return 0;
+    if ( r->errCode == ERR_RAIN_FILE_SEQUENCE )                                //(5.0.022 - LR)
+    {
+        report_writeLine(
+            "ERROR 318: the following line is out of sequence in rainfall file ");
+        report_writeLine(Gage[r->gage].fname);
+        report_writeLine(r->errLine);
+        ErrorCode = ERR_RAIN_FILE_SEQUENCE;
+    }
+    else if ( r->errCode == ERR_MEMORY ) report_writeErrorMsg(ERR_MEMORY, "");
+    else report_writeErrorMsg(r->errCode, Gage[r->gage].fname);
+    return 1;
+}
+
+//=============================================================================
+
 ////  New function added to release 5.0.019  ////                              //(5.0.019 - LR)
 
 int rainFileConflict(int i)
@@ -288,45 +450,215 @@ int rainFileConflict(int i)
 
 //=============================================================================
 
-int addGageToRainFile(int i)
+void readGageData(TRainReader* r)
 //
-//  Input:   i = rain gage index
-//  Output:  returns 1 if successful, 0 if not
-//  Purpose: adds a gage's rainfall record to rain interface file
+//  Input:   r = reader of a gage's rain data file
+//  Output:  none
+//  Purpose: reads a gage's rainfall record into memory, either from its
+//           cache file or else from its rain data file.
+//
+//  Note: this function may run concurrently for different readers and so
+//        must not report errors or change any shared data other than the
+//        rain interval of the reader's own gage.
 //
 {
     FILE* f;                           // pointer to rain file
+    int   i = r->gage;                 // rain gage index
     int   fileFormat;                  // file format code
     int   hdrLines;                    // number of header lines skipped
+    int   hasCache;                    // true if a cache file can be used
+    char  cacheName[MAXFNAME+1];       // name of cache file
+    TRainCacheKey key;                 // identifies data in cache file
+
+    // --- use the cache file if it holds the gage's current data
+    hasCache = getCacheKey(i, &key, cacheName);
+    if ( hasCache && readCacheFile(r, &key, cacheName) ) return;
 
     // --- let StationID point to NULL
-    StationID = NULL;
+    r->stationID = NULL;
 
     // --- check that rain file exists
     if ( (f = fopen(Gage[i].fname, "rt")) == NULL )
-        report_writeErrorMsg(ERR_RAIN_FILE_DATA, Gage[i].fname);
+        r->errCode = ERR_RAIN_FILE_DATA;
     else
     {
-        fileFormat = findFileFormat(f, i, &hdrLines);
+        fileFormat = findFileFormat(f, r, &hdrLines);
         if ( fileFormat == UNKNOWN_FORMAT )
         {
-            report_writeErrorMsg(ERR_RAIN_FILE_FORMAT, Gage[i].fname);
+            r->errCode = ERR_RAIN_FILE_FORMAT;
         }
         else
         {
-            GageIndex = i;                                                     //(5.0.022 - LR)
-            readFile(f, fileFormat, hdrLines, Gage[i].startFileDate,
+            readFile(f, r, fileFormat, hdrLines, Gage[i].startFileDate,
                      Gage[i].endFileDate);
         }
         fclose(f);
     }
-    if ( ErrorCode ) return 0;
-    else
+    if ( r->errCode == 0 && hasCache ) saveCacheFile(r, &key, cacheName);
+}
+
+//=============================================================================
+
+int getCacheKey(int i, TRainCacheKey* key, char* cacheName)
+//
+//  Input:   i = rain gage index
+//  Output:  key = identifies the data read for the gage
+//           cacheName = name of the gage's cache file (MAXFNAME+1 chars);
+//           returns 1 if a cache file can be used, 0 if not
+//  Purpose: identifies the cache file that holds a gage's rainfall record.
+//
+{
+    struct stat fileStats;
+    unsigned int hash = 5381;
+    size_t k;
+    unsigned char* bytes;
+
+    // --- the data file's size & modification time must be known
+    if ( stat(Gage[i].fname, &fileStats) != 0 ) return 0;
+
+    // --- the key also includes everything else that affects the data read
+    memset(key, 0, sizeof(TRainCacheKey));
+    key->startFileDate = Gage[i].startFileDate;
+    key->endFileDate   = Gage[i].endFileDate;
+    key->rainType      = Gage[i].rainType;
+    key->rainInterval  = Gage[i].rainInterval;
+    key->rainUnits     = Gage[i].rainUnits;
+    sstrncpy(key->staID, Gage[i].staID, MAXMSG);
+
+    // --- name the cache file after the data file and a hash of the key
+    //     (so that different stations in the same data file use
+    //     different cache files)
+    bytes = (unsigned char *)key;
+    for (k = 0; k < sizeof(TRainCacheKey); k++) hash = hash * 33 + bytes[k];
+    if ( snprintf(cacheName, MAXFNAME+1, "%s.%08x.rfc", Gage[i].fname,
+                  hash) > MAXFNAME ) return 0;
+    key->fileSize = (FilePos)fileStats.st_size;
+    key->fileTime = (FilePos)fileStats.st_mtime;
+    return 1;
+}
+
+//=============================================================================
+
+int readCacheFile(TRainReader* r, TRainCacheKey* key, char* cacheName)
+//
+//  Input:   r = reader of a gage's rain data file
+//           key = identifies the data to be read
+//           cacheName = name of cache file
+//  Output:  returns 1 if data were read from the cache file, 0 if not
+//  Purpose: reads a gage's rainfall record from its cache file.
+//
+{
+    FILE*   f;
+    char    fileStamp[] = "SWMM5-RAINCACHE";
+    char    fStamp[] = "SWMM5-RAINCACHE";
+    int     interval = 0;
+    FilePos size = -1;
+    unsigned long long checksum = 0;
+    TRainCacheKey fileKey;
+
+    // --- check that cache file holds data with the same key
+    if ( (f = fopen(cacheName, "rb")) == NULL ) return 0;
+    memset(&fileKey, 0, sizeof(TRainCacheKey));
+    fread(fStamp, sizeof(char), strlen(fileStamp), f);
+    fread(&fileKey, sizeof(TRainCacheKey), 1, f);
+    fread(&interval, sizeof(int), 1, f);
+    fread(&r->stats, sizeof(TRainStats), 1, f);
+    fread(&size, sizeof(FilePos), 1, f);
+    if ( strcmp(fStamp, fileStamp) != 0 ||
+         memcmp(&fileKey, key, sizeof(TRainCacheKey)) != 0 ||
+         interval <= 0 || size < 0 || size % RAIN_RECD_SIZE != 0 )
+    {
+        fclose(f);
+        return 0;
+    }
+
+    // --- read the gage's rainfall records & check that they match the
+    //     checksum saved after them
+    r->data = (char *) malloc((size_t)size + 1);
+    if ( r->data == NULL ||
+         fread(r->data, 1, (size_t)size, f) < (size_t)size ||
+         fread(&checksum, sizeof(checksum), 1, f) < 1 ||
+         checksum != getCacheChecksum(r, interval, (size_t)size) )
+    {
+        FREE(r->data);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+    r->size = (size_t)size;
+    r->capacity = r->size + 1;
+    r->interval = interval;
     return 1;
 }
 
 //=============================================================================
 
+void saveCacheFile(TRainReader* r, TRainCacheKey* key, char* cacheName)
+//
+//  Input:   r = reader of a gage's rain data file
+//           key = identifies the data read
+//           cacheName = name of cache file
+//  Output:  none
+//  Purpose: saves a gage's rainfall record to its cache file.
+//
+//  Note: failure to save a cache file is not an error; the gage's data
+//        file will simply be read again next time. The file is written
+//        under a unique temporary name and then renamed, so that a partly
+//        written cache file is never read and concurrent runs saving the
+//        same cache do not write into each other's file.
+//
+{
+    FILE*   f;
+    char    fileStamp[] = "SWMM5-RAINCACHE";
+    char    tmpName[MAXFNAME+1];
+    FilePos size = (FilePos)r->size;
+    unsigned long long checksum = getCacheChecksum(r, r->interval, r->size);
+    int     ok;
+
+    if ( (f = openTmpFile(cacheName, tmpName)) == NULL ) return;
+    fwrite(fileStamp, sizeof(char), strlen(fileStamp), f);
+    fwrite(key, sizeof(TRainCacheKey), 1, f);
+    fwrite(&r->interval, sizeof(int), 1, f);
+    fwrite(&r->stats, sizeof(TRainStats), 1, f);
+    fwrite(&size, sizeof(FilePos), 1, f);
+    ok = ( fwrite(r->data, 1, r->size, f) == r->size );
+    if ( fwrite(&checksum, sizeof(checksum), 1, f) < 1 ) ok = FALSE;
+    if ( fclose(f) != 0 ) ok = FALSE;
+    if ( !ok )
+    {
+        remove(tmpName);
+        return;
+    }
+
+    // --- replace any existing cache file (rename() fails on Windows
+    //     if the new name already exists)
+    if ( rename(tmpName, cacheName) != 0 )
+    {
+        remove(cacheName);
+        if ( rename(tmpName, cacheName) != 0 ) remove(tmpName);
+    }
+}
+
+//=============================================================================
+
+unsigned long long getCacheChecksum(TRainReader* r, int interval, size_t size)
+//
+//  Input:   r = reader holding a gage's rainfall record
+//           interval = recording interval of the record (sec)
+//           size = bytes of rainfall records
+//  Output:  returns a checksum of the record
+//  Purpose: computes the checksum that guards a rain cache file's contents.
+//
+{
+    unsigned long long checksum;
+
+    checksum = hashBytes(&interval, sizeof(int), 0);
+    checksum = hashBytes(&r->stats, sizeof(TRainStats), checksum);
+    return hashBytes(r->data, size, checksum);
+}
+
+//=============================================================================
+
 void initRainFile(void)
 //
 //  Input:   none
@@ -334,25 +666,30 @@ void initRainFile(void)
 //  Purpose: initializes rain interface file for reading.
 //
 {
-    char  fileStamp[] = "SWMM5-RAIN";
+    char  fileStamp[] = "SWMM5-RAIN";  // stamp of file with 32-bit positions
+    char  fileStamp64[] = "SWMM5-RN64";// stamp of file with 64-bit positions
     char  fStamp[] = "SWMM5-RAIN";
     int   i;
     int   kount;
-    long  filePos;
+    int   posSize;                     // bytes used to store a file position
+    FilePos filePos;
 
     // --- make sure interface file is open and no error condition
     if ( ErrorCode || !Frain.file ) return;
 
     // --- check that interface file contains proper file stamp
+    //     (files written by earlier versions use 32-bit positions)
     rewind(Frain.file);
     fread(fStamp, sizeof(char), strlen(fileStamp), Frain.file);
-    if ( strcmp(fStamp, fileStamp) != 0 )
+    if ( strcmp(fStamp, fileStamp64) == 0 ) posSize = sizeof(FilePos);
+    else if ( strcmp(fStamp, fileStamp) == 0 ) posSize = sizeof(int);
+    else
     {
         report_writeErrorMsg(ERR_RAIN_FILE_FORMAT, "");
         return;
     }
     fread(&kount, sizeof(int), 1, Frain.file);
-    filePos = ftell(Frain.file);
+    filePos = FTELL64(Frain.file);
 
     // --- locate information for each raingage in interface file
     for ( i = 0; i < Nobjects[GAGE]; i++ )
@@ -360,8 +697,8 @@ void initRainFile(void)
         if ( ErrorCode || Gage[i].dataSource != RAIN_FILE ) continue;
 
         // --- match station ID for gage with one in file
-        fseek(Frain.file, filePos, SEEK_SET);
-        if ( !findGageInFile(i, (int)kount) ||                                 //(5.0.019 - LR)
+        FSEEK64(Frain.file, filePos, SEEK_SET);
+        if ( !findGageInFile(i, (int)kount, posSize) ||                        //(5.0.019 - LR)
              Gage[i].startFilePos == Gage[i].endFilePos )                      //(5.0.019 - LR)
         {
             report_writeErrorMsg(ERR_RAIN_FILE_GAGE, Gage[i].ID);
@@ -372,32 +709,44 @@ void initRainFile(void)
 
 //=============================================================================
 
-int findGageInFile(int i, int kount)
+int findGageInFile(int i, int kount, int posSize)
 //
-//  Input:   i     = rain gage index
-//           kount = number of rain gages stored on interface file
+//  Input:   i       = rain gage index
+//           kount   = number of rain gages stored on interface file
+//           posSize = number of bytes used to store a file position
 //  Output:  returns TRUE if successful, FALSE if not
 //  Purpose: checks if rain gage's station ID appears in interface file.
 //
 {
     int   k;
     int  interval;
-    int  filePos1, filePos2;
+    int  pos1, pos2;
+    FilePos filePos1, filePos2;
     char  staID[MAXMSG+1];
 
     for ( k = 1; k <= kount; k++ )
     {
         fread(staID,      sizeof(char), MAXMSG+1, Frain.file);
         fread(&interval,  sizeof(int), 1, Frain.file);
-        fread(&filePos1,  sizeof(int), 1, Frain.file);
-        fread(&filePos2,  sizeof(int), 1, Frain.file);
+        if ( posSize == sizeof(FilePos) )
+        {
+            fread(&filePos1,  sizeof(FilePos), 1, Frain.file);
+            fread(&filePos2,  sizeof(FilePos), 1, Frain.file);
+        }
+        else
+        {
+            fread(&pos1,  sizeof(int), 1, Frain.file);
+            fread(&pos2,  sizeof(int), 1, Frain.file);
+            filePos1 = pos1;
+            filePos2 = pos2;
+        }
         if ( strcmp(staID, Gage[i].staID) == 0 )
         {
             // --- match found; save file parameters
             Gage[i].rainType     = RAINFALL_VOLUME;
             Gage[i].rainInterval = interval;
-            Gage[i].startFilePos = (long)filePos1;
-            Gage[i].endFilePos   = (long)filePos2;
+            Gage[i].startFilePos = filePos1;
+            Gage[i].endFilePos   = filePos2;
             Gage[i].currentFilePos = Gage[i].startFilePos;
             return TRUE;
         }
@@ -407,15 +756,16 @@ int findGageInFile(int i, int kount)
 
 //=============================================================================
 
-int findFileFormat(FILE *f, int i, int *hdrLines)
+int findFileFormat(FILE *f, TRainReader* r, int *hdrLines)
 //
 //  Input:   f = ptr. to rain gage's rainfall data file
-//           i = rain gage index
+//           r = reader of the rain gage's data
 //  Output:  hdrLines  = number of header lines found in data file;
 //           returns type of format used in a rainfall data file
 //  Purpose: finds the format of a gage's rainfall data file.
 //
 {
+    int   i = r->gage;
     int   fileFormat;
     int   lineCount;
     int   maxCount = 5;
@@ -431,9 +781,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
     
     // --- check first few lines for known formats
     fileFormat = UNKNOWN_FORMAT;
-    hasStationName = FALSE;                                                    //(5.0.015 - LR)
-    UnitsFactor = 1.0;
-    Interval = 0;
+    r->hasStationName = FALSE;                                                 //(5.0.015 - LR)
+    r->unitsFactor = 1.0;
+    r->interval = 0;
     *hdrLines = 0;
     for (lineCount = 1; lineCount <= maxCount; lineCount++)
     {
@@ -443,9 +793,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%6d %2d %4s", &sn2, &div, elemType);
         if ( n == 3 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);
+            r->timeOffset = r->interval;
+            if ( r->interval > 0 )
             {
                 fileFormat = NWS_SPACE_DELIMITED;
                 break;
@@ -457,12 +807,12 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(&line[37], "%2d %4s %2s %4d", &div, elemType, recdType, &year);
         if ( n == 4 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);
+            r->timeOffset = r->interval;
+            if ( r->interval > 0 )
             {
                 fileFormat = NWS_SPACE_DELIMITED;
-                hasStationName = TRUE;
+                r->hasStationName = TRUE;
                 break;
             }
         }
@@ -471,9 +821,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%6d,%2d,%4s", &sn2, &div, elemType);
         if ( n == 3 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);
+            r->timeOffset = r->interval;
+            if ( r->interval > 0 )
             {
                 fileFormat = NWS_COMMA_DELIMITED;
                 break;
@@ -485,12 +835,12 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(&line[37], "%2d,%4s,%2s,%4d", &div, elemType, recdType, &year);
         if ( n == 4 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);
+            r->timeOffset = r->interval;
+            if ( r->interval > 0 )
             {
                 fileFormat = NWS_COMMA_DELIMITED;
-                hasStationName = TRUE;
+                r->hasStationName = TRUE;
                 break;
             }
         }
@@ -499,9 +849,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%3s%6d%2d%4s", recdType, &sn2, &div, elemType);
         if ( n == 4 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);
+            r->timeOffset = r->interval;
+            if ( r->interval > 0 )
             {
                 fileFormat = NWS_TAPE;
                 break;
@@ -515,9 +865,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
             if ( elem == 123 && strlen(line) >= 185 )
             {
                 fileFormat = AES_HLY;
-                Interval = 3600;
-                TimeOffset = Interval;
-                UnitsFactor = 1.0/MMperINCH;
+                r->interval = 3600;
+                r->timeOffset = r->interval;
+                r->unitsFactor = 1.0/MMperINCH;
                 break;
             }
         }
@@ -529,36 +879,37 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
             if ( elem == 159 && strlen(line) >= 691 )
             {
                 fileFormat = CMC_FIF;
-                Interval = 900;
+                r->interval = 900;
             }
             else if ( elem == 123 && strlen(line) >= 186 )
             {
                 fileFormat = CMC_HLY;
-                Interval = 3600;
+                r->interval = 3600;
             }
             if ( fileFormat == CMC_FIF || fileFormat == CMC_HLY )
             {
-                TimeOffset = Interval;
-                UnitsFactor = 1.0/MMperINCH;
+                r->timeOffset = r->interval;
+                r->unitsFactor = 1.0/MMperINCH;
                 break;
             }
         }
 
         // --- check for standard format
-        if ( parseStdLine(line, &year, &month, &day, &hour, &minute, &x) )
+        if ( parseStdLine(line, r->stationID, &year, &month, &day, &hour,
+                          &minute, &x) )
         {
             fileFormat = STD_SPACE_DELIMITED;
-            RainType = Gage[i].rainType;
-            Interval = Gage[i].rainInterval;
-            if ( Gage[i].rainUnits == SI ) UnitsFactor = 1.0/MMperINCH;
-            TimeOffset = 0;
-            StationID = Gage[i].staID;
+            r->rainType = Gage[i].rainType;
+            r->interval = Gage[i].rainInterval;
+            if ( Gage[i].rainUnits == SI ) r->unitsFactor = 1.0/MMperINCH;
+            r->timeOffset = 0;
+            r->stationID = Gage[i].staID;
             break;         
         }
         (*hdrLines)++;
 
     }
-    if ( fileFormat != UNKNOWN_FORMAT ) Gage[i].rainInterval = Interval;
+    if ( fileFormat != UNKNOWN_FORMAT ) Gage[i].rainInterval = r->interval;
     return fileFormat;
 }
 
@@ -579,30 +930,31 @@ int getNWSInterval(char *elemType)
 
 //=============================================================================
 
-void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
-              DateTime day2)
+void readFile(FILE *f, TRainReader* r, int fileFormat, int hdrLines,
+              DateTime day1, DateTime day2)
 //
 //  Input:   f          = ptr. to gage's rainfall data file
+//           r          = reader of the gage's data
 //           fileFormat = code of data file's format
 //           hdrLines   = number of header lines in data file
 //           day1       = starting day of record of interest
 //           day2       = ending day of record of interest
 //  Output:  none
-//  Purpose: reads rainfall records from gage's data file to interface file.
+//  Purpose: reads rainfall records from gage's data file into memory.
 //
 {
     char line[MAXLINE];
     int  i, n;
 
     rewind(f);
-    RainStats.startDate  = NO_DATE;
-    RainStats.endDate    = NO_DATE;
-    RainStats.periodsRain = 0;
-    RainStats.periodsMissing = 0;
-    RainStats.periodsMalfunc = 0;
-    RainAccum = 0.0;
-    AccumStartDate = NO_DATE;                                                  //(5.0.010 - LR)
-    PreviousDate = NO_DATE;                                                    //(5.0.022 - LR)
+    r->stats.startDate  = NO_DATE;
+    r->stats.endDate    = NO_DATE;
+    r->stats.periodsRain = 0;
+    r->stats.periodsMissing = 0;
+    r->stats.periodsMalfunc = 0;
+    r->rainAccum = 0.0;
+    r->accumStartDate = NO_DATE;                                               //(5.0.010 - LR)
+    r->previousDate = NO_DATE;                                                 //(5.0.022 - LR)
 
     for (i = 1; i <= hdrLines; i++)
     {
@@ -613,41 +965,43 @@ void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
        switch (fileFormat)
        {
          case STD_SPACE_DELIMITED:
-          n = readStdLine(line, day1, day2);
+          n = readStdLine(r, line, day1, day2);
           break;
 
          case NWS_TAPE:
          case NWS_SPACE_DELIMITED:
          case NWS_COMMA_DELIMITED:
-           n = readNWSLine(line, fileFormat, day1, day2);
+           n = readNWSLine(r, line, fileFormat, day1, day2);
            break;
 
          case AES_HLY:
          case CMC_FIF:
          case CMC_HLY:
-           n = readCMCLine(line, fileFormat, day1, day2);
+           n = readCMCLine(r, line, fileFormat, day1, day2);
            break;
 
          default:
            n = -1;
            break;
        }
-       if ( n < 0 ) break;
+       if ( n < 0 || r->errCode ) break;
     }
 }
 
 //=============================================================================
 
-int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
+int readNWSLine(TRainReader* r, char *line, int fileFormat, DateTime day1,
+                DateTime day2)
 //
-//  Input:   line       = line of data from rainfall data file
+//  Input:   r          = reader of a gage's data
+//           line       = line of data from rainfall data file
 //           fileFormat = code of data file's format
 //           day1       = starting day of record of interest
 //           day2       = ending day of record of interest
 //  Output:  returns -1 if past end of desired record, 0 if data line could
 //           not be read successfully or 1 if line read successfully
-//  Purpose: reads a line of data from a rainfall data file and writes its
-//           data to the rain interface file.
+//  Purpose: reads a line of data from a rainfall data file and adds its
+//           data to the gage's rainfall record.
 //
 {
     char     flag1, flag2, isMissing;
@@ -670,7 +1024,7 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
         break;
 
       case NWS_SPACE_DELIMITED:
-        if ( hasStationName ) nameLength = 31;                                 //(5.0.015 - LR)
+        if ( r->hasStationName ) nameLength = 31;                              //(5.0.015 - LR)
         if ( lineLength <= 28 + nameLength ) return 0;                         //(5.0.015 - LR)
         k = 18 + nameLength;                                                   //(5.0.015 - LR)
         if (sscanf(&line[k], "%4d %2d %2d", &y, &m, &d) < 3) return 0;         //(5.0.015 - LR)
@@ -728,9 +1082,9 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
 
         // --- set special condition code & update daily & hourly counts
 
-        setCondition(flag1);
-        if ( Condition == DELETED_PERIOD ||                                    //(5.0.011 - LR)
-             Condition == MISSING_PERIOD ||                                    //(5.0.011 - LR)
+        setCondition(r, flag1);
+        if ( r->condition == DELETED_PERIOD ||                                 //(5.0.011 - LR)
+             r->condition == MISSING_PERIOD ||                                 //(5.0.011 - LR)
              flag1 == 'M' ) isMissing = TRUE;                                  //(5.0.011 - LR)
         else if ( v == 99999 ) isMissing = TRUE;
         else isMissing = FALSE;
@@ -738,11 +1092,11 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
         // --- handle accumulation codes                                       //(5.0.010 - LR)
         if ( flag1 == 'a' )                                                    //(5.0.010 - LR)
         {                                                                      //(5.0.010 - LR)
-            AccumStartDate = date1 + datetime_encodeTime(hour, minute, 0);     //(5.0.010 - LR)
+            r->accumStartDate = date1 + datetime_encodeTime(hour, minute, 0);  //(5.0.010 - LR)
         }                                                                      //(5.0.010 - LR)
         else if ( flag1 == 'A' )                                               //(5.0.010 - LR)
         {                                                                      //(5.0.010 - LR)
-            saveAccumRainfall(date1, hour, minute, v);                         //(5.0.010 - LR)
+            saveAccumRainfall(r, date1, hour, minute, v);                         //(5.0.010 - LR)
         }                                                                      //(5.0.010 - LR)
 
         // --- handle all other conditions                                     //(5.0.010 - LR)
@@ -751,50 +1105,52 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
             // --- convert rain measurement to inches & save it                //(5.0.010 - LR)
             x = (float)v / 100.0f; 
             if ( x > 0 || isMissing )                                          //(5.0.011 - LR)
-                saveRainfall(date1, hour, minute, x, isMissing);               //(5.0.011 - LR)
+                saveRainfall(r, date1, hour, minute, x, isMissing);               //(5.0.011 - LR)
         }                                                                      //(5.0.010 - LR)
 
         // --- reset condition code if special condition period ended
-        if ( flag1 == 'A' || flag1 == '}' || flag1 == ']') Condition = 0;
+        if ( flag1 == 'A' || flag1 == '}' || flag1 == ']') r->condition = 0;
     }
     return result;
 }
 
 //=============================================================================
 
-void  setCondition(char flag)
+void  setCondition(TRainReader* r, char flag)
 {
     switch ( flag )
     {
       case 'a': 
       case 'A':
-        Condition = ACCUMULATED_PERIOD;
+        r->condition = ACCUMULATED_PERIOD;
         break;
       case '{':
       case '}':
-        Condition = DELETED_PERIOD;
+        r->condition = DELETED_PERIOD;
         break;
       case '[':
       case ']':
-        Condition = MISSING_PERIOD;
+        r->condition = MISSING_PERIOD;
         break;
       default:
-        Condition = NO_CONDITION;
+        r->condition = NO_CONDITION;
     }
 }
 
 //=============================================================================
 
-int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
+int readCMCLine(TRainReader* r, char *line, int fileFormat, DateTime day1,
+                DateTime day2)
 //
-//  Input:   line = line of data from rainfall data file
+//  Input:   r = reader of a gage's data
+//           line = line of data from rainfall data file
 //           fileFormat = code of data file's format
 //           day1 = starting day of record of interest
 //           day2 = ending day of record of interest
 //  Output:  returns -1 if past end of desired record, 0 if data line could
 //           not be read successfully or 1 if line read successfully
 //  Purpose: reads a line of data from an AES or CMC rainfall data file and
-//           writes its data to the rain interface file.
+//           adds its data to the gage's rainfall record.
 //
 {
     char     flag, isMissing;
@@ -845,7 +1201,7 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
         x = (float)( (double)v / 10.0 / MMperINCH);
         if ( x > 0 || isMissing)
         {
-            saveRainfall(date1, hour, minute, x, isMissing);
+            saveRainfall(r, date1, hour, minute, x, isMissing);
         }
 
         // --- update hour & minute for next interval
@@ -865,15 +1221,16 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
 
 //=============================================================================
 
-int readStdLine(char *line, DateTime day1, DateTime day2)
+int readStdLine(TRainReader* r, char *line, DateTime day1, DateTime day2)
 //
-//  Input:   line = line of data from a standard rainfall data file
+//  Input:   r = reader of a gage's data
+//           line = line of data from a standard rainfall data file
 //           day1 = starting day of record of interest
 //           day2 = ending day of record of interest
 //  Output:  returns -1 if past end of desired record, 0 if data line could
 //           not be read successfully or 1 if line read successfully
 //  Purpose: reads a line of data from a standard rainfall data file and
-//           writes its data to the rain interface file.
+//           adds its data to the gage's rainfall record.
 //
 {
     DateTime date1;
@@ -882,7 +1239,8 @@ int readStdLine(char *line, DateTime day1, DateTime day2)
     float    x;
 
     // --- parse data from input line
-    if (!parseStdLine(line, &year, &month, &day, &hour, &minute, &x)) return 0;
+    if (!parseStdLine(line, r->stationID, &year, &month, &day, &hour,
+                      &minute, &x)) return 0;
 
     // --- see if date is within period of record requested
     date1 = datetime_encodeDate(year, month, day);
@@ -892,37 +1250,37 @@ int readStdLine(char *line, DateTime day1, DateTime day2)
 // Added for release 5.0.022  //////////////                                   //(5.0.022 - LR)
     // --- see if record is out of sequence
     date2 = date1 + datetime_encodeTime(hour, minute, 0);
-    if ( date2 <= PreviousDate )
+    if ( date2 <= r->previousDate )
     {
-        report_writeLine(
-            "ERROR 318: the following line is out of sequence in rainfall file ");
-        report_writeLine(Gage[GageIndex].fname);
-        report_writeLine(line);
-        ErrorCode = ERR_RAIN_FILE_SEQUENCE;
+        // --- save the line so the error can be reported later
+        r->errCode = ERR_RAIN_FILE_SEQUENCE;
+        r->errLine = (char *) malloc(strlen(line) + 1);
+        if ( r->errLine ) strcpy(r->errLine, line);
+        else r->errCode = ERR_MEMORY;
         return -1;
     }
-    PreviousDate = date2;
+    r->previousDate = date2;
 ////////////////////////////////////////////
 
-    switch (RainType)
+    switch (r->rainType)
     {
       case RAINFALL_INTENSITY:
-        x = x * Interval / 3600.0f;
+        x = x * r->interval / 3600.0f;
         break;
 
       case CUMULATIVE_RAINFALL:
-        if ( x >= RainAccum )
+        if ( x >= r->rainAccum )
         {
-            x = x - RainAccum;
-            RainAccum += x;
+            x = x - r->rainAccum;
+            r->rainAccum += x;
         }
-        else RainAccum = x;
+        else r->rainAccum = x;
         break;
     }
-    x *= (float)UnitsFactor;
+    x *= (float)r->unitsFactor;
 
-    // --- save rainfall to binary interface file
-    saveRainfall(date1, hour, minute, x, FALSE);
+    // --- save rainfall to gage's rainfall record
+    saveRainfall(r, date1, hour, minute, x, FALSE);
     return 1;
 }
 
@@ -930,10 +1288,11 @@ int readStdLine(char *line, DateTime day1, DateTime day2)
 
 ////  This function was re-written for release 5.0.022  ////                   //(5.0.022 - LR)
 
-int parseStdLine(char *line, int *year, int *month, int *day, int *hour,
-                 int *minute, float *value)
+int parseStdLine(char *line, char *staID, int *year, int *month, int *day,
+                 int *hour, int *minute, float *value)
 //
 //  Input:   line = line of data from a standard rainfall data file
+//           staID = station ID of rainfall wanted (NULL for any station)
 //  Output:  *year = year when rainfall occurs
 //           *month = month of year when rainfall occurs
 //           *day = day of month when rainfall occurs
@@ -950,22 +1309,24 @@ int parseStdLine(char *line, int *year, int *month, int *day, int *hour,
 
     n = sscanf(line, "%s%d%d%d%d%d%f", token, year, month, day, hour, minute, value);
     if ( n < 7 ) return 0;
-    if ( StationID != NULL && !strcomp(token, StationID) ) return 0;
+    if ( staID != NULL && !strcomp(token, staID) ) return 0;
     return 1;
 }
 
 //=============================================================================
 
-void saveAccumRainfall(DateTime date1, int hour, int minute, long v)
+void saveAccumRainfall(TRainReader* r, DateTime date1, int hour, int minute,
+                       long v)
 //
-//  Input:   date1 = date of latest rainfall reading (in DateTime format)
+//  Input:   r = reader of a gage's data
+//           date1 = date of latest rainfall reading (in DateTime format)
 //           hour = hour of day of latest rain reading
 //           minute = minute of hour of latest rain reading
 //           v = accumulated rainfall reading in hundreths of inches
 //  Output:  none
 //  Purpose: divides accumulated rainfall evenly into individual recording
-//           periods over the accumulation period and writes each period's
-//           rainfall to the binary rainfall file.
+//           periods over the accumulation period and adds each period's
+//           rainfall to the gage's rainfall record.
 //
 //  This function was added to Release 5.0.010.                                //(5.0.010 - LR)
 //
@@ -975,20 +1336,20 @@ void saveAccumRainfall(DateTime date1, int hour, int minute, long v)
     float    x;
 
     // --- return if accumulated start date is missing                         //(5.0.022 - LR)
-    if ( AccumStartDate == NO_DATE ) return;
+    if ( r->accumStartDate == NO_DATE ) return;
     //if ( v == -99999 ) return;                                               //(5.0.022 - LR)
 
     // --- find number of recording intervals over accumulation period
     date2 = date1 + datetime_encodeTime(hour, minute, 0);
-    n = (datetime_timeDiff(date2, AccumStartDate) / Interval) + 1;
+    n = (datetime_timeDiff(date2, r->accumStartDate) / r->interval) + 1;
 
     // --- update count of rain or missing periods                             //(5.0.022 - LR)
     if ( v == 99999 )                                                          //(5.0.022 - LR)
     {                                                                          //(5.0.022 - LR)
-        RainStats.periodsMissing += n;                                         //(5.0.022 - LR)
+        r->stats.periodsMissing += n;                                          //(5.0.022 - LR)
         return;                                                                //(5.0.022 - LR)
     }                                                                          //(5.0.022 - LR)
-    RainStats.periodsRain += n;                                                //(5.0.022 - LR)
+    r->stats.periodsRain += n;                                                 //(5.0.022 - LR)
 
     // --- divide accumulated amount evenly into each period
     x = (float)v / (float)n / 100.0f;
@@ -996,55 +1357,87 @@ void saveAccumRainfall(DateTime date1, int hour, int minute, long v)
     // --- save this amount to file for each period
     if ( x > 0.0f )
     {
-        date2 = datetime_addSeconds(AccumStartDate, -TimeOffset);
-        if ( RainStats.startDate == NO_DATE ) RainStats.startDate = date2;
+        date2 = datetime_addSeconds(r->accumStartDate, -r->timeOffset);
+        if ( r->stats.startDate == NO_DATE ) r->stats.startDate = date2;
         for (j = 0; j < n; j++)
         {
-            fwrite(&date2, sizeof(DateTime), 1, Frain.file);
-            fwrite(&x, sizeof(float), 1, Frain.file);
-            date2 = datetime_addSeconds(date2, Interval);
-            RainStats.endDate = date2;
+            addRainRecord(r, date2, x);
+            date2 = datetime_addSeconds(date2, r->interval);
+            r->stats.endDate = date2;
         }
     }
 
     // --- reset start of accumulation period
-    AccumStartDate = NO_DATE;
+    r->accumStartDate = NO_DATE;
 }
 
 
 //=============================================================================
 
-void saveRainfall(DateTime date1, int hour, int minute, float x, char isMissing)
+void saveRainfall(TRainReader* r, DateTime date1, int hour, int minute,
+                  float x, char isMissing)
 //
-//  Input:   date1 = date of rainfall reading (in DateTime format)
+//  Input:   r = reader of a gage's data
+//           date1 = date of rainfall reading (in DateTime format)
 //           hour = hour of day of current rain reading
 //           minute = minute of hour of current rain reading
 //           x = rainfall reading in inches
 //           isMissing = TRUE if rainfall value is missing
 //  Output:  none
-//  Purpose: writes current rainfall reading from an external rainfall file
-//           to project's binary rainfall file.
+//  Purpose: adds current rainfall reading from an external rainfall file
+//           to the gage's rainfall record.
 //
 {
     DateTime date2;
     double   seconds;
 
-    if ( isMissing ) RainStats.periodsMissing++;
-    else             RainStats.periodsRain++;
+    if ( isMissing ) r->stats.periodsMissing++;
+    else             r->stats.periodsRain++;
 
-    // --- if rainfall not missing then save it to rainfall interface file
+    // --- if rainfall not missing then save it to gage's rainfall record
     if ( !isMissing )
     {
-        seconds = 3600*hour + 60*minute - TimeOffset;
+        seconds = 3600*hour + 60*minute - r->timeOffset;
         date2 = datetime_addSeconds(date1, seconds);
 
-        // --- write date & value (in inches) to interface file
-        fwrite(&date2, sizeof(DateTime), 1, Frain.file);
-        fwrite(&x, sizeof(float), 1, Frain.file);
+        // --- add date & value (in inches) to rainfall record
+        addRainRecord(r, date2, x);
 
         // --- update actual start & end of record dates
-        if ( RainStats.startDate == NO_DATE ) RainStats.startDate = date2;
-        RainStats.endDate = date2;
+        if ( r->stats.startDate == NO_DATE ) r->stats.startDate = date2;
+        r->stats.endDate = date2;
+    }
+}
+//=============================================================================
+
+void addRainRecord(TRainReader* r, DateTime date, float x)
+//
+//  Input:   r = reader of a gage's data
+//           date = date/time at start of rainfall period
+//           x = rainfall depth (inches)
+//  Output:  none
+//  Purpose: appends a date & rainfall value to a gage's rainfall record.
+//
+{
+    size_t n;
+    char*  data;
+
+    if ( r->errCode ) return;
+    if ( r->size + RAIN_RECD_SIZE > r->capacity )
+    {
+        n = MAX(2 * r->capacity, 1024 * RAIN_RECD_SIZE);
+        data = (char *) realloc(r->data, n);
+        if ( data == NULL )
+        {
+            r->errCode = ERR_MEMORY;
+            return;
+        }
+        r->data = data;
+        r->capacity = n;
     }
+    memcpy(r->data + r->size, &date, sizeof(DateTime));
+    memcpy(r->data + r->size + sizeof(DateTime), &x, sizeof(float));
+    r->size += RAIN_RECD_SIZE;
 }
+
 //=============================================================================
@@ -35,6 +35,13 @@ const double ZERO_RDII = 0.0001;       // Minimum non-zero RDII inflow (cfs)
 // Data Structures
 //-----------------------------------------------------------------------------
                      
+typedef struct                         // Ordinates of a UH for one month
+{                                      // -------------------------------------
+   int       lastPeriod[2];            // last UH period on rising/falling limb
+   double    u0[2];                    // ordinate at period 0 of each limb
+   double    du[2];                    // change in ordinate per UH period
+}  TUHOrd;
+
 typedef struct                         // Data for a single unit hydrograph
 {                                      // -------------------------------------
    double*   pastRain;                 // array of past rainfall values
@@ -44,6 +51,9 @@ typedef struct                         // Data for a single unit hydrograph
    int       maxPeriods;               // max. past rainfall periods
    long      drySeconds;               // time since last nonzero rainfall
    double    iaUsed;                   // initial abstraction used (in or mm)
+   TUHOrd    ord[12];                  // UH ordinates for each month
+   double    rainSum[12][2];           // sum of past rain on each UH limb
+   double    rainMoment[12][2];        // sum of UH period * past rain
 }  TUHData;
 
 typedef struct                         // Data for a unit hydrograph group
@@ -110,9 +120,10 @@ static void   getRainfall(DateTime currentDate);
 static double applyIA(int j, int k, DateTime aDate, double dt,
               double rainDepth);
 static void   updateDryPeriod(int j, int k, double rain, int gageInterval);
+static void   addPastRain(int j, int k, double rain, int month);
 static void   getUnitHydRdii(DateTime currentDate);
-static double getUnitHydConvol(int j, int k, int gageInterval);
-static double getUnitHydOrd(int j, int m, int k, double t);
+static double getUnitHydConvol(int j, int k);
+static void   setUnitHydOrd(int j, int k);
 
 static int    getNodeRdii(void);
 static void   saveRdiiFlows(DateTime currentDate);
@@ -962,6 +973,9 @@ void initUnitHydData()
 
             // --- assign initial abstraction used
             UHGroup[i].uh[k].iaUsed = UnitHyd[i].iaInit[month][k];
+
+            // --- tabulate the UH's ordinates for each month
+            setUnitHydOrd(i, k);
         }
 
         // --- initialize gage date to simulation start date
@@ -1044,7 +1058,6 @@ void getRainfall(DateTime currentDate)
     int      j;                        // UH group index
     int      k;                        // UH index
     int      g;                        // rain gage index
-    int      i;                        // past rainfall index
     int      month;                    // month of current date
     int      rainInterval;             // rainfall interval (sec)              //(5.0.017 - LR)
     int      gageInterval;             // gage recording interval (sec)
@@ -1085,13 +1098,8 @@ void getRainfall(DateTime currentDate)
                 // --- adjust extent of dry period for the UH
                 updateDryPeriod(j, k, excessDepth, rainInterval);              //(5.0.017 - LR)
 
-                // --- add rainfall to list of past values,
-                //     wrapping array index if necessary
-                i = UHGroup[j].uh[k].period;
-                if ( i >= UHGroup[j].uh[k].maxPeriods ) i = 0;
-                UHGroup[j].uh[k].pastRain[i] = excessDepth;
-                UHGroup[j].uh[k].pastMonth[i] = (char)month;
-                UHGroup[j].uh[k].period = i + 1;
+                // --- add rainfall to list of past values
+                addPastRain(j, k, excessDepth, month);
             }
 
             // --- advance rain date by gage recording interval
@@ -1202,7 +1210,6 @@ void getUnitHydRdii(DateTime currentDate)
     int   j;                           // UH group index
     int   k;                           // UH index
 //  int   g;                           // rain gage index                      //(5.0.017 - LR)
-    int   rainInterval;                // rainfall time interval (sec)         //(5.0.017 - LR)
 
     // --- examine each UH group
     for (j=0; j<Nobjects[UNITHYD]; j++)
@@ -1217,13 +1224,12 @@ void getUnitHydRdii(DateTime currentDate)
 
         // --- perform convolution for each UH in the group
 //      g = UnitHyd[j].rainGage;                                               //(5.0.017 - LR)
-        rainInterval = UHGroup[j].rainInterval;                                //(5.0.017 - LR)
         UHGroup[j].rdii = 0.0;                                                 //(5.0.016 - LR)
         for (k=0; k<3; k++)
         {
             if ( UHGroup[j].uh[k].hasPastRain )
             {
-                UHGroup[j].rdii += getUnitHydConvol(j, k, rainInterval);       //(5.0.017 - LR)
+                UHGroup[j].rdii += getUnitHydConvol(j, k);
             }
         }
     }
@@ -1231,90 +1237,185 @@ void getUnitHydRdii(DateTime currentDate)
 
 //=============================================================================
 
-double getUnitHydConvol(int j, int k, int rainInterval)                        //(5.0.017 - LR)
+double getUnitHydConvol(int j, int k)
 //
 //  Input:   j = UH group index
 //           k = UH index
-//           rainInterval = rainfall time interval (sec)                       //(5.0.017 - LR)
 //  Output:  returns a RDII flow value
 //  Purpose: computes convolution of Unit Hydrographs with past rainfall.
 //
+//  Note: each limb of a UH is linear in its time period p, so the
+//        convolution over the past rainfall v on a limb equals
+//        u0*sum(v) + du*sum(p*v), where the sums are kept current by
+//        addPastRain().
+//
 {
-    int    i;                          // previous rainfall period index
     int    m;                          // month of year index
-    int    p;                          // UH time period index
-    int    pMax;                       // max. number of periods
-    double t;                          // UH time value (sec)
-    double u;                          // UH ordinate
-    double v;                          // rainfall volume
+    int    s;                          // UH limb index
     double rdii;                       // RDII flow
     TUHData* uh;                       // UH data
 
-    // --- initialize RDII, rain period index and UH period index
     rdii = 0.0;
     uh = &UHGroup[j].uh[k];
-    i = uh->period - 1;
-    if ( i < 0 ) i = uh->maxPeriods - 1;
-    pMax = uh->maxPeriods;
-    p = 1;
+    for (m=0; m<12; m++)
+    {
+        for (s=0; s<2; s++)
+        {
+            rdii += uh->ord[m].u0[s] * uh->rainSum[m][s] +
+                    uh->ord[m].du[s] * uh->rainMoment[m][s];
+        }
+    }
+    return MAX(rdii, 0.0);
+}
+
+//=============================================================================
 
-    // --- evaluate each time period of UH's
-    while ( p < pMax )
+void addPastRain(int j, int k, double rain, int month)
+//
+//  Input:   j = UH group index
+//           k = UH index
+//           rain = excess rainfall depth (in or mm)
+//           month = month in which the rainfall occurred
+//  Output:  none
+//  Purpose: adds a rainfall value to a UH's list of past values and updates
+//           the sums used to convolute the UH with them.
+//
+{
+    int    i;                          // past rainfall index
+    int    m;                          // month of year index
+    int    s;                          // UH limb index
+    int    n;                          // max. number of periods
+    int    p;                          // UH time period index
+    double v;                          // past rainfall volume
+    TUHData* uh;                       // UH data
+
+    uh = &UHGroup[j].uh[k];
+    n = uh->maxPeriods;
+
+    // --- if past rainfall was just cleared then so are the sums
+    if ( uh->period < 1 || uh->period > n )
     {
-        // --- if rain period has rainfall
-        v = uh->pastRain[i];
-        m = uh->pastMonth[i];
-        if ( v > 0.0 )
+        for (m=0; m<12; m++)
         {
-            // --- find mid-point time of UH period in seconds
-            t = ((double)(p) - 0.5) * (double)rainInterval;                    //(5.0.017 - LR)
+            for (s=0; s<2; s++)
+            {
+                uh->rainSum[m][s] = 0.0;
+                uh->rainMoment[m][s] = 0.0;
+            }
+        }
+    }
+
+    // --- otherwise move each past value one UH period further back
+    else for (m=0; m<12; m++)
+    {
+        for (s=0; s<2; s++) uh->rainMoment[m][s] += uh->rainSum[m][s];
 
-            // --- convolute rain volume with UH ordinate
-            u = getUnitHydOrd(j, m, k, t) * UnitHyd[j].r[m][k];
-            rdii += u * v;
+        // --- remove the value that has just passed the end of each limb,
+        //     adding it to the falling limb if it leaves the rising one
+        for (s=0; s<2; s++)
+        {
+            if ( s == 1 && uh->ord[m].lastPeriod[1] <= uh->ord[m].lastPeriod[0] )
+                continue;
+            if ( s == 0 && uh->ord[m].lastPeriod[0] < 1 ) continue;
+            p = uh->ord[m].lastPeriod[s] + 1;
+            i = uh->period - p + 1;
+            if ( i < 0 ) i += n;
+            v = uh->pastRain[i];
+            if ( v <= 0.0 || uh->pastMonth[i] != m ) continue;
+            uh->rainSum[m][s] -= v;
+            uh->rainMoment[m][s] -= p * v;
+            if ( s == 0 && p <= uh->ord[m].lastPeriod[1] )
+            {
+                uh->rainSum[m][1] += v;
+                uh->rainMoment[m][1] += p * v;
+            }
         }
+    }
+
+    // --- add rainfall to list of past values,
+    //     wrapping array index if necessary
+    i = uh->period;
+    if ( i >= n ) i = 0;
+    uh->pastRain[i] = rain;
+    uh->pastMonth[i] = (char)month;
+    uh->period = i + 1;
 
-        // --- move to next UH period & previous rainfall period
-        p = p + 1;
-        i = i - 1;
-        if ( i < 0 ) i = uh->maxPeriods - 1;
+    // --- add rainfall to the limb that holds UH period 1
+    if ( rain > 0.0 )
+    {
+        if ( uh->ord[month].lastPeriod[0] >= 1 ) s = 0;
+        else if ( uh->ord[month].lastPeriod[1] >= 1 ) s = 1;
+        else return;
+        uh->rainSum[month][s] += rain;
+        uh->rainMoment[month][s] += rain;
     }
-    return rdii;
 }
 
 //=============================================================================
 
-double getUnitHydOrd(int h, int m, int k, double t)
+void setUnitHydOrd(int j, int k)
+//
+//  Input:   j = UH group index
+//           k = UH index
+//  Output:  none
+//  Purpose: finds the linear ordinates of each limb of a unit hydrograph
+//           for each month of the year.
 //
-//  Input:   h = index of UH group
-//           m = month index
-//           k = individual UH index
-//           t = UH time (sec)
-//  Output:  returns ordinate of a unit hydrograph
-//  Purpose: gets ordinate of a particular unit hydrograph at specified time.
+//  Note: the ordinate of UH period p is the height of the triangular UH
+//        (times its response ratio) at the mid-point of the period,
+//        t = (p - 0.5)*dt, where dt is the rainfall processing interval.
 //
 {
-    double qPeak;                      // peak flow of unit hydrograph 
-    double f;                          // fraction of time to/from peak on UH
-    double t1;                         // time to peak on UH (sec)
+    int    m;                          // month index
+    int    s;                          // UH limb index
+    int    n;                          // last UH period used in convolution
+    long   dt;                         // rainfall time interval (sec)
+    long   t1;                         // time to peak on UH (sec)
+    long   tBase;                      // base time of UH (sec)
     double t2;                         // time after peak on UH (sec)
-    double tBase;                      // base time of UH (sec)
+    double qPeak;                      // peak flow of unit hydrograph
+    TUHOrd* ord;                       // UH ordinates
 
-    // --- return 0 if past end of UH time base
-    tBase = UnitHyd[h].tBase[m][k];
-    if ( t >= tBase ) return 0.0;
+    dt = UHGroup[j].rainInterval;
+    n = UHGroup[j].uh[k].maxPeriods - 1;
+    for (m=0; m<12; m++)
+    {
+        ord = &UHGroup[j].uh[k].ord[m];
+        for (s=0; s<2; s++)
+        {
+            ord->lastPeriod[s] = 0;
+            ord->u0[s] = 0.0;
+            ord->du[s] = 0.0;
+        }
 
-    // --- compute peak value of UH in original rainfall units (in/hr or mm/hr)
-    qPeak = 2. / tBase * 3600.0;
-    
-    // --- break UH base into times before & after peak flow
-    t1 = UnitHyd[h].tPeak[m][k];
-    t2 = tBase - t1;
-
-    // --- find UH flow at time t
-    if ( t <= t1 ) f = t / t1;
-    else           f = 1.0 - (t - t1) / t2;
-    return MAX(f, 0.0) * qPeak;                  
+        // --- no UH exists without a base time
+        tBase = UnitHyd[j].tBase[m][k];
+        if ( tBase <= 0 ) continue;
+        t1 = UnitHyd[j].tPeak[m][k];
+        t2 = (double)(tBase - t1);
+
+        // --- last periods whose mid-points lie at or before the peak
+        //     and before the end of the UH base
+        ord->lastPeriod[1] = MIN((2*tBase + dt - 1) / (2*dt), n);
+        ord->lastPeriod[0] = MIN((2*t1 + dt) / (2*dt), ord->lastPeriod[1]);
+
+        // --- peak value of UH in original rainfall units (in/hr or mm/hr)
+        qPeak = 2. / tBase * 3600.0 * UnitHyd[j].r[m][k];
+
+        // --- rising limb: u = qPeak * t / t1
+        if ( t1 > 0 )
+        {
+            ord->du[0] = qPeak * dt / t1;
+            ord->u0[0] = -0.5 * ord->du[0];
+        }
+
+        // --- falling limb: u = qPeak * (1 - (t - t1) / t2)
+        if ( t2 > 0.0 )
+        {
+            ord->du[1] = -qPeak * dt / t2;
+            ord->u0[1] = qPeak * (1.0 + (t1 + 0.5 * dt) / t2);
+        }
+    }
 }
 
 //=============================================================================
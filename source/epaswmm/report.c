@@ -940,6 +940,7 @@ void report_writeSysStats(TSysStats* sysStats)
 //  Purpose: writes simulation statistics for overall system to report file.
 //
 {
+    int    k;
     double x;
 
     if ( Nobjects[LINK] == 0 || StepCount == 0 ) return;
@@ -962,6 +963,15 @@ void report_writeSysStats(TSysStats* sysStats)
     fprintf(Frpt.file,
         "\n  Average Iterations per Step :  %7.2f",
         sysStats->avgStepCount / StepCount);
+    if ( StepClasses > 1 && CourantFactor > 0.0 )
+    {
+        for (k=0; k<StepClasses; k++)
+        {
+            fprintf(Frpt.file,
+                "\n  Avg. Links in Step Class %d  :  %7.2f",
+                k+1, sysStats->stepClassCount[k] / StepCount);
+        }
+    }
     WRITE("");
 }
 
@@ -30,11 +30,40 @@
 static const double LATERAL_FLOW_TOL = 0.5;  // for steady state (cfs)         //(5.0.012 - LR)
 static const double FLOW_ERR_TOL = 0.05;     // for steady state               //(5.0.012 - LR)
 
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    char    steady;                    // TRUE if flow routing can be skipped
+    char    changed;                   // TRUE if inflows or controls changed
+    double  inflow;                    // total inflow over last step (cfs)
+    double  outflow;                   // total outflow over last step (cfs)
+} TSubnet;
+
 //-----------------------------------------------------------------------------
 // Shared variables
 //-----------------------------------------------------------------------------
 static int* SortedLinks;
+static int* PartStart;                 // start of each sub-network in SortedLinks
+static int  PartCount;                 // number of independent sub-networks
+static int* NodePart;                  // sub-network each node belongs to
+static TSubnet* Subnet;                // state of each sub-network
+static int* ActiveLinks;               // links in sub-networks being routed
+static int* ActiveStart;               // start of each sub-network in ActiveLinks
+static int  ActiveCount;               // number of sub-networks being routed
+static int* ActiveNodes;               // nodes in sub-networks being routed
+static int  ActiveNodeCount;           // number of nodes being routed
 static int  InSteadyState;
+static int* ExtNodes;                  // nodes with external inflows
+static int  ExtNodeCount;              // number of nodes with external inflows
+static int* DwfNodes;                  // nodes with dry weather inflows
+static int  DwfNodeCount;              // number of nodes with dry weather inflows
+static double* DwfFlow;                // current DWF flow of each DWF node (cfs)
+static double* DwfLoad;                // current DWF pollutant loads (mass/sec)
+static int  DwfPeriod;                 // month/day/hour period of DWF values
+static int* GwSubcatch;                // subcatchments sending GW flow to nodes
+static int  GwSubcatchCount;           // number of such subcatchments
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
@@ -59,7 +88,11 @@ static void addRdiiInflows(DateTime currentDate);
 static void addIfaceInflows(DateTime currentDate);
 static void removeStorageLosses(void);                                         //(5.0.019 - LR)
 static void removeOutflows(void);
+static int  createInflowSchedule(void);
+static void updateDwfSchedule(DateTime currentDate);
 static int  systemHasChanged(int routingModel);
+static double getSubnetFlowError(int p);
+static void setActiveSubnets(void);
 static int  readFloat(float *x);                                               //(5.0.013 - LR)
 
 //=============================================================================
@@ -79,16 +112,51 @@ int routing_open(int routingModel)
 
     // --- topologically sort the links
     SortedLinks = NULL;
+    PartStart = NULL;
+    PartCount = 0;
+    NodePart = NULL;
+    Subnet = NULL;
+    ActiveLinks = NULL;
+    ActiveStart = NULL;
+    ActiveNodes = NULL;
     if ( Nobjects[LINK] > 0 )
     {
         SortedLinks = (int *) calloc(Nobjects[LINK], sizeof(int));
-        if ( !SortedLinks )
+        PartStart = (int *) calloc(Nobjects[LINK]+1, sizeof(int));
+        NodePart = (int *) calloc(Nobjects[NODE], sizeof(int));
+        ActiveLinks = (int *) calloc(Nobjects[LINK], sizeof(int));
+        ActiveStart = (int *) calloc(Nobjects[LINK]+1, sizeof(int));
+        ActiveNodes = (int *) calloc(Nobjects[NODE], sizeof(int));
+        Subnet = (TSubnet *) calloc(Nobjects[LINK], sizeof(TSubnet));
+        if ( !SortedLinks || !PartStart || !NodePart || !ActiveLinks ||
+             !ActiveStart || !ActiveNodes || !Subnet )
         {
             report_writeErrorMsg(ERR_MEMORY, "");
             return ErrorCode;
         }
         toposort_sortLinks(SortedLinks);
         if ( ErrorCode ) return ErrorCode;
+
+        // --- group the sorted links into independent sub-networks
+        //     that can be routed concurrently or skipped separately
+        //     when in steady state
+        PartCount = toposort_partitionLinks(SortedLinks, PartStart, NodePart);
+        if ( ErrorCode ) return ErrorCode;
+        setActiveSubnets();
+    }
+
+    // --- list the nodes that receive external & dry weather inflows
+    if ( !createInflowSchedule() )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return ErrorCode;
+    }
+
+    // --- compile the control rules
+    if ( controls_init() > 0 )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return ErrorCode;
     }
 
     // --- open any routing interface files
@@ -128,6 +196,17 @@ void routing_close(int routingModel)
     flowrout_close(routingModel);
     treatmnt_close();
     FREE(SortedLinks);
+    FREE(PartStart);
+    FREE(NodePart);
+    FREE(Subnet);
+    FREE(ActiveLinks);
+    FREE(ActiveStart);
+    FREE(ActiveNodes);
+    FREE(ExtNodes);
+    FREE(DwfNodes);
+    FREE(DwfFlow);
+    FREE(DwfLoad);
+    FREE(GwSubcatch);
 }
 
 //=============================================================================
@@ -156,9 +235,7 @@ void routing_execute(int routingModel, double routingStep)
 {
     int      j;
     int      stepCount = 1;
-    int      actionCount = 0;                                                  //(5.0.010 - LR)
     DateTime currentDate;
-    double   stepFlowError;                                                    //(5.0.012 - LR)
 
     // --- update continuity with current state
     //     applied over 1/2 of time step
@@ -170,12 +247,13 @@ void routing_execute(int routingModel, double routingStep)
     for (j=0; j<Nobjects[LINK]; j++) link_setTargetSetting(j);                 //(5.0.010 - LR)
     controls_evaluate(currentDate, currentDate - StartDateTime,                //(5.0.010 - LR)
                       routingStep/SECperDAY);                                  //(5.0.010 - LR)
+    for (j=0; j<PartCount; j++) Subnet[j].changed = FALSE;
     for (j=0; j<Nobjects[LINK]; j++)                                           //(5.0.010 - LR)
     {                                                                          //(5.0.010 - LR)
         if ( Link[j].targetSetting != Link[j].setting )                        //(5.0.010 - LR)
         {                                                                      //(5.0.010 - LR)
             link_setSetting(j, routingStep);                                   //(5.0.010 - LR)
-            actionCount++;                                                     //(5.0.010 - LR)
+            Subnet[NodePart[Link[j].node1]].changed = TRUE;
         }                                                                      //(5.0.010 - LR)
     }                                                                          //(5.0.010 - LR)
 
@@ -185,7 +263,6 @@ void routing_execute(int routingModel, double routingStep)
     currentDate = getDateTime(NewRoutingTime);
 
     // --- initialize mass balance totals for time step
-    stepFlowError = massbal_getStepFlowError();                                //(5.0.012 - LR)
     massbal_initTimeStepTotals();
 
     // --- replace old water quality state with new state
@@ -208,31 +285,57 @@ void routing_execute(int routingModel, double routingStep)
     addRdiiInflows(currentDate);
     addIfaceInflows(currentDate);
 
-    // --- check if can skip steady state periods
-    if ( SkipSteadyState )
+    // --- check if can skip steady state periods in each sub-network
+    //     (the system is in steady state only if all of them are)
+    if ( SkipSteadyState && Nobjects[LINK] > 0 )
     {
-        if ( OldRoutingTime == 0.0
-        ||   actionCount > 0
-        ||   fabs(stepFlowError) > FLOW_ERR_TOL                                //(5.0.012 - LR)
-        ||   systemHasChanged(routingModel) ) InSteadyState = FALSE;
-        else InSteadyState = TRUE;
+        if ( OldRoutingTime == 0.0 )
+        {
+            for (j = 0; j < PartCount; j++) Subnet[j].changed = TRUE;
+        }
+        systemHasChanged(routingModel);
+        InSteadyState = TRUE;
+        for (j = 0; j < PartCount; j++)
+        {
+            Subnet[j].steady = !Subnet[j].changed;
+            if ( Subnet[j].changed ) InSteadyState = FALSE;
+            Subnet[j].inflow = 0.0;
+            Subnet[j].outflow = 0.0;
+        }
+        setActiveSubnets();
+
+        // --- start new flow totals for each sub-network
+        for (j = 0; j < Nobjects[NODE]; j++)
+        {
+            if ( NodePart[j] >= 0 )
+                Subnet[NodePart[j]].inflow += Node[j].newLatFlow;
+        }
     }
 
     // --- find new hydraulic state if system has changed
     if ( InSteadyState == FALSE )
     {
         // --- replace old hydraulic state values with current ones
-        for (j = 0; j < Nobjects[LINK]; j++) link_setOldHydState(j);
-        for (j = 0; j < Nobjects[NODE]; j++)
+        //     in the sub-networks being routed
+        if ( Nobjects[LINK] > 0 )
         {
-            node_setOldHydState(j);
-            node_initInflow(j, routingStep);
-        }
+            for (j = 0; j < ActiveStart[ActiveCount]; j++)
+                link_setOldHydState(ActiveLinks[j]);
+            for (j = 0; j < ActiveNodeCount; j++)
+            {
+                node_setOldHydState(ActiveNodes[j]);
+                node_initInflow(ActiveNodes[j], routingStep);
+            }
 
-        // --- route flow through the drainage network
-        if ( Nobjects[LINK] > 0 )
+            // --- route flow through those sub-networks
+            stepCount = flowrout_execute(ActiveLinks, ActiveStart, ActiveCount,
+                                         ActiveNodes, ActiveNodeCount,
+                                         routingModel, routingStep);
+        }
+        else for (j = 0; j < Nobjects[NODE]; j++)
         {
-            stepCount = flowrout_execute(SortedLinks, routingModel, routingStep);
+            node_setOldHydState(j);
+            node_initInflow(j, routingStep);
         }
     }
 
@@ -259,6 +362,20 @@ void routing_execute(int routingModel, double routingStep)
 
 //=============================================================================
 
+int routing_isSteady(void)
+//
+//  Input:   none
+//  Output:  returns TRUE if the whole drainage network was in steady state
+//           over the most recent routing time step
+//  Purpose: reports the result of the steady state test made when
+//           SKIP_STEADY_STATE is in effect (FALSE otherwise).
+//
+{
+    return InSteadyState;
+}
+
+//=============================================================================
+
 void addExternalInflows(DateTime currentDate)
 //
 //  Input:   currentDate = current date/time
@@ -266,15 +383,15 @@ void addExternalInflows(DateTime currentDate)
 //  Purpose: adds direct external inflows to nodes at current date.
 //
 {
-    int     j, p;
+    int     i, j, p;
     double  q, w;
     TExtInflow* inflow;
 
     // --- for each node with a defined external inflow
-    for (j = 0; j < Nobjects[NODE]; j++)
+    for (i = 0; i < ExtNodeCount; i++)
     {
+        j = ExtNodes[i];
         inflow = Node[j].extInflow;
-        if ( !inflow ) continue;
 
         // --- get flow inflow
         q = 0.0;
@@ -325,25 +442,149 @@ void addDryWeatherInflows(DateTime currentDate)
 //  Purpose: adds dry weather inflows to nodes at current date.
 //
 {
-    int      j, p;
-    int      month, day, hour;
+    int      i, j, p;
     double   q, w;
+    double*  load;
+
+    // --- update DWF values if a new time pattern period has begun
+    updateDwfSchedule(currentDate);
+
+    // --- for each node with a defined dry weather inflow
+    for (i = 0; i < DwfNodeCount; i++)
+    {
+        // --- add flow inflow to node's lateral inflow
+        j = DwfNodes[i];
+        q = DwfFlow[i];
+        Node[j].newLatFlow += q;
+        massbal_addInflowFlow(DRY_WEATHER_INFLOW, q);
+
+        // --- add pollutant mass inflows
+        load = DwfLoad + i * Nobjects[POLLUT];
+        for ( p = 0; p < Nobjects[POLLUT]; p++ )
+        {
+            w = load[p];
+            if ( w == 0.0 ) continue;
+            Node[j].newQual[p] += w;
+            massbal_addInflowQual(DRY_WEATHER_INFLOW, p, w);
+        }
+    }
+}
+
+//=============================================================================
+
+int createInflowSchedule()
+//
+//  Input:   none
+//  Output:  returns FALSE if memory could not be allocated
+//  Purpose: lists the nodes that receive external and dry weather inflows,
+//           and the subcatchments that send groundwater flow to nodes, so
+//           that other objects need not be examined each time step.
+//
+{
+    int j;
+
+    ExtNodes = NULL;
+    DwfNodes = NULL;
+    DwfFlow  = NULL;
+    DwfLoad  = NULL;
+    ExtNodeCount = 0;
+    DwfNodeCount = 0;
+    DwfPeriod = -1;
+    GwSubcatch = NULL;
+    GwSubcatchCount = 0;
+    for (j = 0; j < Nobjects[NODE]; j++)
+    {
+        if ( Node[j].extInflow ) ExtNodeCount++;
+        if ( Node[j].dwfInflow ) DwfNodeCount++;
+    }
+    if ( ExtNodeCount > 0 )
+    {
+        ExtNodes = (int *) calloc(ExtNodeCount, sizeof(int));
+        if ( !ExtNodes ) return FALSE;
+    }
+    if ( DwfNodeCount > 0 )
+    {
+        DwfNodes = (int *) calloc(DwfNodeCount, sizeof(int));
+        DwfFlow  = (double *) calloc(DwfNodeCount, sizeof(double));
+        DwfLoad  = (double *) calloc(DwfNodeCount * Nobjects[POLLUT] + 1,
+                                     sizeof(double));
+        if ( !DwfNodes || !DwfFlow || !DwfLoad ) return FALSE;
+    }
+
+    ExtNodeCount = 0;
+    DwfNodeCount = 0;
+    for (j = 0; j < Nobjects[NODE]; j++)
+    {
+        if ( Node[j].extInflow )
+        {
+            ExtNodes[ExtNodeCount] = j;
+            ExtNodeCount++;
+        }
+        if ( Node[j].dwfInflow )
+        {
+            DwfNodes[DwfNodeCount] = j;
+            DwfNodeCount++;
+        }
+    }
+
+    // --- list subcatchments that send groundwater flow to nodes
+    for (j = 0; j < Nobjects[SUBCATCH]; j++)
+    {
+        if ( Subcatch[j].groundwater && Subcatch[j].groundwater->node >= 0 )
+            GwSubcatchCount++;
+    }
+    if ( GwSubcatchCount > 0 )
+    {
+        GwSubcatch = (int *) calloc(GwSubcatchCount, sizeof(int));
+        if ( !GwSubcatch ) return FALSE;
+        GwSubcatchCount = 0;
+        for (j = 0; j < Nobjects[SUBCATCH]; j++)
+        {
+            if ( Subcatch[j].groundwater &&
+                 Subcatch[j].groundwater->node >= 0 )
+            {
+                GwSubcatch[GwSubcatchCount] = j;
+                GwSubcatchCount++;
+            }
+        }
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void updateDwfSchedule(DateTime currentDate)
+//
+//  Input:   currentDate = current date/time
+//  Output:  none
+//  Purpose: re-evaluates the dry weather flow and pollutant loading of each
+//           DWF node when the month, day of week or hour of day changes.
+//
+{
+    int      i, p;
+    int      month, day, hour, period;
+    double   q, w;
+    double*  load;
     TDwfInflow* inflow;
 
+    if ( DwfNodeCount == 0 ) return;
+
     // --- get month (zero-based), day-of-week (zero-based),
     //     & hour-of-day for routing date/time
     month = datetime_monthOfYear(currentDate) - 1;
     day   = datetime_dayOfWeek(currentDate) - 1;
     hour  = datetime_hourOfDay(currentDate);
 
-    // --- for each node with a defined dry weather inflow
-    for (j = 0; j < Nobjects[NODE]; j++)
-    {
-        inflow = Node[j].dwfInflow;
-        if ( !inflow ) continue;
+    // --- DWF time patterns only vary with these three quantities
+    period = (month * 7 + day) * 24 + hour;
+    if ( period == DwfPeriod ) return;
+    DwfPeriod = period;
 
+    for (i = 0; i < DwfNodeCount; i++)
+    {
         // --- get flow inflow (i.e., the inflow whose param code is -1)
         q = 0.0;
+        inflow = Node[DwfNodes[i]].dwfInflow;
         while ( inflow )
         {
             if ( inflow->param < 0 )
@@ -354,44 +595,24 @@ void addDryWeatherInflows(DateTime currentDate)
             inflow = inflow->next;
         }
         if ( fabs(q) < FLOW_TOL ) q = 0.0;
+        DwfFlow[i] = q;
 
-        // --- add flow inflow to node's lateral inflow
-        Node[j].newLatFlow += q;
-        massbal_addInflowFlow(DRY_WEATHER_INFLOW, q);
-
-////  Following code segment added to release 5.0.017.  ////                   //(5.0.017 - LR)
-        // --- add default DWF pollutant inflows
+        // --- start with default DWF pollutant inflows
+        load = DwfLoad + i * Nobjects[POLLUT];
         for ( p = 0; p < Nobjects[POLLUT]; p++)
         {
-            if ( Pollut[p].dwfConcen > 0.0 )
-            {
-                w = q * Pollut[p].dwfConcen;
-                Node[j].newQual[p] += w;
-                massbal_addInflowQual(DRY_WEATHER_INFLOW, p, w);
-            }
+            load[p] = q * Pollut[p].dwfConcen;
         }
-////  End of new code segment  ////                                            //(5.0.017 - LR)
 
-        // --- get pollutant mass inflows
-        inflow = Node[j].dwfInflow;
+        // --- replace them with any specified pollutant inflows
+        inflow = Node[DwfNodes[i]].dwfInflow;
         while ( inflow )
         {
             if ( inflow->param >= 0 )
             {
                 p = inflow->param;
                 w = q * inflow_getDwfInflow(inflow, month, day, hour);
-                Node[j].newQual[p] += w;
-                massbal_addInflowQual(DRY_WEATHER_INFLOW, p, w);
-
-////  Following code segment added to release 5.0.017.  ////                   //(5.0.017 - LR)
-                // --- subtract off any default inflow
-                if ( Pollut[p].dwfConcen > 0.0 )
-                {
-                    w = q * Pollut[p].dwfConcen;
-                    Node[j].newQual[p] -= w;
-                    massbal_addInflowQual(DRY_WEATHER_INFLOW, p, -w);
-                }
-////  End of new code segment  ////                                            //(5.0.017 - LR)
+                load[p] += w - q * Pollut[p].dwfConcen;
             }
             inflow = inflow->next;
         }
@@ -449,46 +670,44 @@ void addGroundwaterInflows(double routingTime)
 //  Output:  none
 //  Purpose: adds groundwater inflows to nodes at current elapsed time.
 //
+//  Note:    subcatchments are visited in a fixed (index) order so that
+//           the flows they add to a shared node sum to the same result
+//           no matter how their groundwater was computed.
 {
-    int    i, j, p;
+    int    i, j, k, p;
     double q, w;
     double f;
     TGroundwater* gw;
 
     // --- find where current routing time lies between latest runoff times
-    if ( Nobjects[SUBCATCH] == 0 ) return;
+    if ( GwSubcatchCount == 0 ) return;
     f = (routingTime - OldRunoffTime) / (NewRunoffTime - OldRunoffTime);
     if ( f < 0.0 ) f = 0.0;
     if ( f > 1.0 ) f = 1.0;
 
-    // --- for each subcatchment
-    for (i = 0; i < Nobjects[SUBCATCH]; i++)
+    // --- for each subcatchment that sends groundwater to a node
+    for (k = 0; k < GwSubcatchCount; k++)
     {
-        // --- see if subcatch contains groundwater
+        // --- identify node receiving groundwater flow
+        i = GwSubcatch[k];
         gw = Subcatch[i].groundwater;
-        if ( gw )
+        j = gw->node;
+
+        // add groundwater flow to lateral inflow
+        q = ( (1.0 - f)*(gw->oldFlow) + f*(gw->newFlow) )
+            * Subcatch[i].area;
+        if ( fabs(q) < FLOW_TOL ) continue;
+        Node[j].newLatFlow += q;
+        massbal_addInflowFlow(GROUNDWATER_INFLOW, q);
+
+        // add pollutant load (for positive inflow)
+        if ( q > 0.0 )
         {
-            // --- identify node receiving groundwater flow
-            j = gw->node;
-            if ( j >= 0 )
+            for (p = 0; p < Nobjects[POLLUT]; p++)
             {
-                // add groundwater flow to lateral inflow
-                q = ( (1.0 - f)*(gw->oldFlow) + f*(gw->newFlow) )
-                    * Subcatch[i].area;
-                if ( fabs(q) < FLOW_TOL ) continue;
-                Node[j].newLatFlow += q;
-                massbal_addInflowFlow(GROUNDWATER_INFLOW, q);
-
-                // add pollutant load (for positive inflow)
-                if ( q > 0.0 )
-                {
-                    for (p = 0; p < Nobjects[POLLUT]; p++)
-                    {
-                        w = q * Pollut[p].gwConcen;
-                        Node[j].newQual[p] += w;
-                        massbal_addInflowQual(GROUNDWATER_INFLOW, p, w);
-                    }
-                }
+                w = q * Pollut[p].gwConcen;
+                Node[j].newQual[p] += w;
+                massbal_addInflowQual(GROUNDWATER_INFLOW, p, w);
             }
         }
     }
@@ -579,25 +798,37 @@ int  systemHasChanged(int routingModel)
 //  Input:   none
 //  Output:  returns TRUE if external inflows or hydraulics have changed
 //           from the previous time step
-//  Purpose: checks if the hydraulic state of the system has changed from
-//           the previous time step.
+//  Purpose: checks if the hydraulic state of each sub-network has changed
+//           from the previous time step, marking those that have.
 //
 {
-    int    j;                                                                  //(5.0.012 - LR)
+    int    j, p;                                                               //(5.0.012 - LR)
+    int    changed = FALSE;
     double diff;
 
     // --- check if external inflows or outflows have changed                  //(5.0.012 - LR)
     for (j=0; j<Nobjects[NODE]; j++)
     {
+        p = NodePart[j];
+        if ( p < 0 || Subnet[p].changed ) continue;
         diff = Node[j].oldLatFlow - Node[j].newLatFlow;
-        if ( fabs(diff) > LATERAL_FLOW_TOL ) return TRUE;                      //(5.0.012 - LR)
-        if ( Node[j].type == OUTFALL || Node[j].degree == 0 )                  //(5.0.012 - LR)
+        if ( fabs(diff) > LATERAL_FLOW_TOL ) Subnet[p].changed = TRUE;         //(5.0.012 - LR)
+        else if ( Node[j].type == OUTFALL || Node[j].degree == 0 )             //(5.0.012 - LR)
         {                                                                      //(5.0.012 - LR)
             diff = Node[j].oldFlowInflow - Node[j].inflow;                     //(5.0.012 - LR)
-            if ( fabs(diff) > LATERAL_FLOW_TOL ) return TRUE;                  //(5.0.012 - LR)
+            if ( fabs(diff) > LATERAL_FLOW_TOL ) Subnet[p].changed = TRUE;     //(5.0.012 - LR)
         }                                                                      //(5.0.012 - LR)
     }
 
+    // --- check if flow continuity error over last step is too large
+    for (p=0; p<PartCount; p++)
+    {
+        if ( !Subnet[p].changed &&
+             fabs(getSubnetFlowError(p)) > FLOW_ERR_TOL ) Subnet[p].changed = TRUE;
+        if ( Subnet[p].changed ) changed = TRUE;
+    }
+    return changed;
+
 //// Start of deprecated code block.  ////                                     //(5.0.012 - LR)
 /*
     // --- if system was already in steady state & there are no changes
@@ -647,7 +878,62 @@ int  systemHasChanged(int routingModel)
     }
 */
 ////  End of deprecated code block.  ////                                      //(5.0.012 - LR)
-    return FALSE;
+}
+
+//=============================================================================
+
+double getSubnetFlowError(int p)
+//
+//  Input:   p = sub-network index
+//  Output:  returns fractional difference between total inflow and outflow
+//  Purpose: computes flow routing mass balance error for a sub-network
+//           over the previous time step.
+//
+{
+    if ( Subnet[p].inflow > 0.0 )
+        return 1.0 - Subnet[p].outflow / Subnet[p].inflow;
+    else if ( Subnet[p].outflow > 0.0 )
+        return Subnet[p].inflow / Subnet[p].outflow - 1.0;
+    else return 0.0;
+}
+
+//=============================================================================
+
+void setActiveSubnets()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: lists the links & nodes of all sub-networks not in steady state
+//           (nodes not connected to any link are always listed).
+//
+{
+    int i, j, p;
+
+    // --- links of each active sub-network form a contiguous block
+    j = 0;
+    ActiveCount = 0;
+    ActiveStart[0] = 0;
+    for (p = 0; p < PartCount; p++)
+    {
+        if ( Subnet[p].steady ) continue;
+        for (i = PartStart[p]; i < PartStart[p+1]; i++)
+        {
+            ActiveLinks[j] = SortedLinks[i];
+            j++;
+        }
+        ActiveCount++;
+        ActiveStart[ActiveCount] = j;
+    }
+
+    // --- nodes of active sub-networks
+    ActiveNodeCount = 0;
+    for (i = 0; i < Nobjects[NODE]; i++)
+    {
+        p = NodePart[i];
+        if ( p >= 0 && Subnet[p].steady ) continue;
+        ActiveNodes[ActiveNodeCount] = i;
+        ActiveNodeCount++;
+    }
 }
 
 //=============================================================================
@@ -672,8 +958,10 @@ void removeStorageLosses()
         if (Node[i].type == STORAGE)
         {
 
-            // --- update total system storage losses
+            // --- update total system & sub-network storage losses
             losses += Storage[Node[i].subIndex].losses;
+            if ( NodePart && NodePart[i] >= 0 )
+                Subnet[NodePart[i]].outflow += Storage[Node[i].subIndex].losses;
 
             // --- adjust storage concentrations for any evaporation loss
             if ( Nobjects[POLLUT] > 0 && Node[i].newVolume > FUDGE )
@@ -711,6 +999,11 @@ void removeOutflows()
         if ( q != 0.0 )
         {
             massbal_addOutflowFlow(q, isFlooded);
+            if ( NodePart && NodePart[i] >= 0 )
+            {
+                if ( q >= 0.0 ) Subnet[NodePart[i]].outflow += q;
+                else            Subnet[NodePart[i]].inflow -= q;
+            }
             for ( p = 0; p < Nobjects[POLLUT]; p++ )
             {
                 w = q * Node[i].newQual[p];
@@ -15,7 +15,7 @@
 #include <string.h>
 #include <malloc.h>
 #include "headers.h"
-#include "odesolve.h"
+#include "infil.h"
 
 //-----------------------------------------------------------------------------
 // Shared variables
@@ -23,6 +23,7 @@
 static char  IsRaining;                // TRUE if precip.falls on study area
 static char  HasRunoff;                // TRUE if study area generates runoff
 static char  HasSnow;                  // TRUE if any snow cover on study area
+static long  RunoffDryStep;            // time step used in dry periods (sec)
 static int   Nsteps;                   // number of runoff time steps taken
 static int   MaxSteps;                 // final number of runoff time steps
 static long  MaxStepsPos;              // position in Runoff interface file
@@ -33,6 +34,7 @@ static long  MaxStepsPos;              // position in Runoff interface file
 //-----------------------------------------------------------------------------
 double* WashoffQual;         // washoff quality for a subcatchment (mass/ft3)
 double* WashoffLoad;         // washoff loads for a landuse (mass/sec)
+#pragma omp threadprivate(WashoffQual, WashoffLoad)
 
 //-----------------------------------------------------------------------------
 //  Imported variables
@@ -44,6 +46,7 @@ extern float* SubcatchResults;         // Results vector defined in OUTPUT.C
 //-----------------------------------------------------------------------------
 // runoff_open     (called from swmm_start in swmm5.c)
 // runoff_execute  (called from swmm_step in swmm5.c)
+// runoff_isDry    (called from execRouting in swmm5.c)
 // runoff_close    (called from swmm_end in swmm5.c)
 
 //-----------------------------------------------------------------------------
@@ -64,25 +67,43 @@ int runoff_open()
 //  Purpose: opens the runoff analyzer.
 //
 {
+    int j;
+    int memErrors = 0;                 // number of threads w/o washoff arrays
+
     IsRaining = FALSE;
     HasRunoff = FALSE;
     HasSnow = FALSE;
     Nsteps = 0;
 
-    // --- open the Ordinary Differential Equation solver
-    //     to solve up to 3 ode's.
-    if ( !odesolve_open(3) ) report_writeErrorMsg(ERR_ODE_SOLVER, "");
+    // --- dry periods can be fast-forwarded in steps of up to a day
+    //     (pollutant buildup is found in closed form) unless groundwater
+    //     is simulated, since its exchange with the drainage system is
+    //     only updated once per time step
+    RunoffDryStep = DryStep;
+    if ( FastForwardDry && RunoffDryStep < (long)SECperDAY )
+    {
+        for (j = 0; j < Nobjects[SUBCATCH]; j++)
+        {
+            if ( !IgnoreGwater && Subcatch[j].groundwater ) break;
+        }
+        if ( j == Nobjects[SUBCATCH] ) RunoffDryStep = (long)SECperDAY;
+    }
 
-    // --- allocate memory for pollutant washoff loads
-    WashoffQual = NULL;
-    WashoffLoad = NULL;
-    if ( Nobjects[POLLUT] > 0 )
+    // --- each thread that computes subcatchment runoff needs its own
+    //     washoff load arrays
+    #pragma omp parallel reduction(+:memErrors)
     {
-        WashoffQual = (double *) calloc(Nobjects[POLLUT], sizeof(double));
-        if ( !WashoffQual ) report_writeErrorMsg(ERR_MEMORY, "");
-        WashoffLoad = (double *) calloc(Nobjects[POLLUT], sizeof(double));
-        if ( !WashoffLoad ) report_writeErrorMsg(ERR_MEMORY, "");
+        // --- allocate memory for pollutant washoff loads
+        WashoffQual = NULL;
+        WashoffLoad = NULL;
+        if ( Nobjects[POLLUT] > 0 )
+        {
+            WashoffQual = (double *) calloc(Nobjects[POLLUT], sizeof(double));
+            WashoffLoad = (double *) calloc(Nobjects[POLLUT], sizeof(double));
+            if ( !WashoffQual || !WashoffLoad ) memErrors++;
+        }
     }
+    if ( memErrors ) report_writeErrorMsg(ERR_MEMORY, "");
 
     // --- see if a runoff interface file should be opened
     switch ( Frunoff.mode )
@@ -116,12 +137,12 @@ void runoff_close()
 //  Purpose: closes the runoff analyzer.
 //
 {
-    // --- close the ODE solver
-    odesolve_close();
-
-    // --- free memory for pollutant washoff loads
-    FREE(WashoffQual);
-    FREE(WashoffLoad);
+    #pragma omp parallel
+    {
+        // --- free memory for pollutant washoff loads
+        FREE(WashoffQual);
+        FREE(WashoffLoad);
+    }
 
     // --- close runoff interface file if in use
     if ( Frunoff.file )
@@ -136,7 +157,7 @@ void runoff_close()
     }
 
     // --- close climate file if in use
-    if ( Fclimate.file ) fclose(Fclimate.file);
+    climate_closeFile();
 }
 
 //=============================================================================
@@ -149,6 +170,9 @@ void runoff_execute()
 //
 {
     int      j;                        // object index
+    int      n;                        // number of subcatchments
+    int      hasRunoff;                // TRUE if any subcatch has runoff
+    int      hasSnow;                  // TRUE if any subcatch has snow cover
     int      day;                      // day of calendar year
     double    runoffStep;              // runoff time step (sec)
     double    runoff;                  // subcatchment runoff (ft/sec)
@@ -206,6 +230,9 @@ void runoff_execute()
     OldRunoffTime = NewRunoffTime;
     NewRunoffTime += (double)(1000.0 * runoffStep);
 
+    // --- update external pollutant buildup rates for the new time
+    if ( !IgnoreQuality ) landuse_setExternalBuildup(getDateTime(NewRunoffTime));
+
     // --- update old state of each subcatchment, 
     for (j = 0; j < Nobjects[SUBCATCH]; j++) subcatch_setOldState(j);
 
@@ -215,11 +242,20 @@ void runoff_execute()
         subcatch_getRunon(j);
         if ( !IgnoreSnowmelt ) snow_plowSnow(j, runoffStep);                   //(5.0.014 - LR)
     }
+
+    // --- find infiltration rates into the pervious area of all subcatchments
+    infil_setRates(InfilModel, runoffStep);
     
     // --- determine runoff and pollutant buildup/washoff in each subcatchment
-    HasSnow = FALSE;
-    HasRunoff = FALSE;
-    for (j = 0; j < Nobjects[SUBCATCH]; j++)
+    //     (runon was found above from the previous period's runoff, so the
+    //     subcatchments are independent of one another and can be processed
+    //     concurrently)
+    hasSnow = FALSE;
+    hasRunoff = FALSE;
+    n = Nobjects[SUBCATCH];
+    #pragma omp parallel for schedule(static) private(runoff) \
+            reduction(||:hasRunoff, hasSnow) if(n > 1)
+    for (j = 0; j < n; j++)
     {
         // --- find total runoff rate (in ft/sec) over the subcatchment
         //     (the amount that actually leaves the subcatchment (in cfs)
@@ -227,8 +263,8 @@ void runoff_execute()
         runoff = subcatch_getRunoff(j, runoffStep);
 
         // --- update state of study area surfaces
-        if ( runoff > 0.0 ) HasRunoff = TRUE;
-        if ( Subcatch[j].newSnowDepth > 0.0 ) HasSnow = TRUE;
+        if ( runoff > 0.0 ) hasRunoff = TRUE;
+        if ( Subcatch[j].newSnowDepth > 0.0 ) hasSnow = TRUE;
 
         // --- skip pollutant buildup/washoff if quality ignored               //(5.0.014 - LR)
         if ( IgnoreQuality ) continue;                                         //(5.0.014 - LR)   
@@ -242,6 +278,11 @@ void runoff_execute()
         // --- compute pollutant washoff 
         subcatch_getWashoff(j, runoff, runoffStep);
     }
+    HasRunoff = (char)hasRunoff;
+    HasSnow = (char)hasSnow;
+
+    // --- add mass balance totals found by each thread to overall totals
+    massbal_sumThreadTotals();
 
     // --- update tracking of system-wide max. runoff rate
     stats_updateMaxRunoff();
@@ -256,6 +297,20 @@ void runoff_execute()
 
 //=============================================================================
 
+int runoff_isDry(void)
+//
+//  Input:   none
+//  Output:  returns TRUE if the current runoff period is dry
+//  Purpose: checks if no rain, snow cover or runoff exists anywhere on the
+//           study area over the most recent runoff time step.
+//
+{
+    if ( Frunoff.mode == USE_FILE ) return FALSE;
+    return !IsRaining && !HasSnow && !HasRunoff;
+}
+
+//=============================================================================
+
 double runoff_getTimeStep(DateTime currentDate)
 //
 //  Input:   currentDate = current simulation date/time
@@ -265,7 +320,7 @@ double runoff_getTimeStep(DateTime currentDate)
 {
     int  j;
     long timeStep;
-    long maxStep = DryStep;
+    long maxStep = RunoffDryStep;
 
     // --- find shortest time until next evaporation or rainfall value
     //     (this represents the maximum possible time step)
@@ -280,7 +335,7 @@ double runoff_getTimeStep(DateTime currentDate)
 
     // --- determine whether wet or dry time step applies
     if ( IsRaining || HasSnow || HasRunoff ) timeStep = WetStep;
-    else timeStep = DryStep;
+    else timeStep = RunoffDryStep;
 
     // --- limit time step if necessary
     if ( timeStep > maxStep ) timeStep = maxStep;
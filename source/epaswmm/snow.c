@@ -31,6 +31,7 @@ enum SnowKeywords {SNOW_PLOWABLE, SNOW_IMPERV, SNOW_PERV, SNOW_REMOVAL};
 //  snow_validateSnowmelt(called from project_validate)                        //(5.0.012 - LR)
 //  snow_readMeltParams  (called from parseLine in input.c)
 //  snow_setMeltCoeffs   (called from setTemp in climate.c)
+//  snow_setClimateCoeffs(called from climate_setState)
 //  snow_plowSnow        (called from runoff_execute)
 //  snow_getSnowMelt     (called from subcatch_getRunoff)
 //  snow_getSnowCover    (called from massbal_open) 
@@ -304,6 +305,38 @@ void snow_setMeltCoeffs(int j, double s)
 
 //=============================================================================
 
+void snow_setClimateCoeffs(void)
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: evaluates the parts of the snow melt equations that depend only
+//           on the current climate, once per time step for all snow packs.
+//
+{
+    int    j;                          // snowmelt parameter set index
+    int    k;                          // snow sub-area index
+    double uadj;                       // adjusted wind speed
+
+    // --- terms of the rain melt eqn. that don't depend on rainfall
+    uadj = 0.006 * Wind.ws;
+    Snow.rainmelt[0] = Temp.ta - 32.0;
+    Snow.rainmelt[1] = 0.001167 + 7.5 * Temp.gamma * uadj;
+    Snow.rainmelt[2] = 8.5 * uadj * (Temp.ea - 0.18);
+
+    // --- degree-day melt rate of each surface of each parameter set
+    //     (only used when air temp. is at or above the base melt temp.)
+    for (j = 0; j < Nobjects[SNOWMELT]; j++)
+    {
+        for (k = SNOW_PLOWABLE; k <= SNOW_PERV; k++)
+        {
+            Snowmelt[j].dmelt[k] = Snowmelt[j].dhm[k] *
+                                   (Temp.ta - Snowmelt[j].tbase[k]);
+        }
+    }
+}
+
+//=============================================================================
+
 void snow_plowSnow(int j, double tStep)
 //
 //  Input:   j     = subcatchment index
@@ -378,7 +411,10 @@ void snow_plowSnow(int j, double tStep)
             if ( Snowmelt[k].sfrac[4] > 0.0 )
             {
                 m = Snowmelt[k].toSubcatch;
-                if ( Subcatch[m].snowpack )                                    //(5.0.014 - LR)
+
+                // --- toSubcatch is -1 when no receiving subcatchment
+                //     was named, so check it before indexing Subcatch
+                if ( m >= 0 && Subcatch[m].snowpack )                          //(5.0.014 - LR)
                 {                                                              //(5.0.014 - LR)
                     f = Subcatch[m].snowpack->fArea[SNOW_PERV];                //(5.0.014 - LR)
                 }                                                              //(5.0.014 - LR)
@@ -641,7 +677,7 @@ double meltSnowpack(TSnowpack* snowpack, int i, double rmelt, double asc,
     // --- else if air temp. >= base melt temp. then use degree-day eqn.
     else if ( Temp.ta >= Snowmelt[k].tbase[i] )
     {
-         smelt = Snowmelt[k].dhm[i] * (Temp.ta - Snowmelt[k].tbase[i]);
+         smelt = Snowmelt[k].dmelt[i];
     }
 
     // --- otherwise alter cold content and return 0
@@ -666,19 +702,17 @@ double getRainmelt(double rainfall)
 //  Output:  returns snow melt rate (ft/sec)
 //  Purpose: computes rate of snow melt when rainfall occurs.
 //
+//  Note: the terms that depend only on climate are found once per time
+//        step by snow_setClimateCoeffs().
+//
 {
-    double uadj;                       // adjusted wind speed
-    double t1, t2, t3;
     double smelt;                      // snow melt in in/hr
 
     rainfall = rainfall * 43200.0;     // convert rain to in/hr
     if ( rainfall > 0.02 )
-   {
-        uadj = 0.006 * Wind.ws;
-        t1 = Temp.ta - 32.0;
-        t2 = 7.5 * Temp.gamma * uadj;
-        t3 = 8.5 * uadj * (Temp.ea - 0.18);
-        smelt =  t1 * (0.001167 + t2 +  0.007 * rainfall) + t3;
+    {
+        smelt = Snow.rainmelt[0] * (Snow.rainmelt[1] + 0.007 * rainfall)
+                + Snow.rainmelt[2];
         return smelt / 43200.0;
     }
     else return 0.0;
@@ -240,6 +240,7 @@ int  stats_open()
     SysStats.avgTimeStep = 0.0;
     SysStats.avgStepCount = 0.0;
     SysStats.steadyStateCount = 0.0;
+    for (j=0; j<MAXSTEPCLASSES; j++) SysStats.stepClassCount[j] = 0.0;
     return 0;
 }
 
@@ -382,16 +383,23 @@ void   stats_updateFlowStats(double tStep, DateTime aDate, int stepCount,
 
 //=============================================================================
    
-void stats_updateCriticalTimeCount(int node, int link)
+void stats_updateCriticalTimeCount(int node, int link, int classCount[])
 //
 //  Input:   node = node index
 //           link = link index
+//           classCount = number of links in each time step class
 //  Output:  none
-//  Purpose: updates count of times a node or link was time step-critical.
+//  Purpose: updates count of times a node or link was time step-critical
+//           and the number of links sub-cycled in each time step class.
 //
 {
+    int k;
+
     if      ( node >= 0 ) NodeStats[node].timeCourantCritical += 1.0;
     else if ( link >= 0 ) LinkStats[link].timeCourantCritical += 1.0;
+    if ( classCount == NULL ) return;
+    for (k=0; k<StepClasses; k++)
+        SysStats.stepClassCount[k] += classCount[k];
 }
 
 //=============================================================================
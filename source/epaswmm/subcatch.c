@@ -21,6 +21,7 @@
 #include <string.h>
 #include "headers.h"
 #include "lid.h"                                                               //(5.0.019 - LR)
+#include "infil.h"
 #include "odesolve.h"
 
 //-----------------------------------------------------------------------------
@@ -29,17 +30,29 @@
 const double MCOEFF    = 1.49;              // constant in Manning Eq.
 const double MEXP      = 1.6666667;         // exponent in Manning Eq.
 const double ODETOL    = 0.0001;            // acceptable error for ODE solver
+const int    MAXNEWTON = 20;                // max. Newton iterations for depth
+
+//-----------------------------------------------------------------------------
+// Data Structures
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    double   losses;              // evap. + infil. loss rate (ft/sec)
+    double   outflow;             // outflow rate (ft/sec)
+    double   vEvap;               // evap. volume over a time step (ft)
+    double   vInfil;              // infil. volume over a time step (ft)
+    double   vOutflow;            // outflow volume over a time step (ft)
+}  TSubareaFlux;
+
+typedef struct
+{
+    TSubarea* subarea;            // subarea to which getDdDt() is applied
+    double    losses;             // loss rate used by getDdDt() (ft/sec)
+}  TDepthContext;
 
 //-----------------------------------------------------------------------------
 // Shared variables   
 //-----------------------------------------------------------------------------
-static  double     Losses;        // subcatch evap. + infil. loss rate (ft/sec)
-static  double     Outflow;       // subcatch outflow rate (ft/sec)
-static  double     Vevap;         // subcatch evap. volume over a time step (ft)
-static  double     Vinfil;        // subcatch infil. volume over a time step (ft)
-static  double     Voutflow;      // subcatch outflow volume over a time step (ft)
-static  double     Vponded;       // subcatch ponded volume (ft)
-static  TSubarea* theSubarea;     // subarea to which getDdDt() is applied
 static  char *RunoffRoutingWords[] = { w_OUTLET,  w_IMPERV, w_PERV, NULL};
 
 //-----------------------------------------------------------------------------
@@ -47,6 +60,7 @@ static  char *RunoffRoutingWords[] = { w_OUTLET,  w_IMPERV, w_PERV, NULL};
 //-----------------------------------------------------------------------------
 extern  double*    WashoffQual;   // washoff quality for a subcatchment (mass/ft3)
 extern  double*    WashoffLoad;   // washoff loads for a landuse (mass/sec)
+#pragma omp threadprivate(WashoffQual, WashoffLoad)
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)   
@@ -81,11 +95,14 @@ extern  double*    WashoffLoad;   // washoff loads for a landuse (mass/sec)
 static char   sweptSurfacesDry(int subcatch);
 static void   getNetPrecip(int j, double* netPrecip, double tStep);            //(5.0.019 - LR)
 static void   getSubareaRunoff(int subcatch, int subarea, double rainfall,
-              double evap, double tStep);
-static double getSubareaInfil(int j, TSubarea* subarea, double tStep);         //(5.0.021 - LR)
+              double evap, double tStep, TSubareaFlux* flux);
+static double getSubareaInfil(int j, double tStep);                            //(5.0.021 - LR)
 static void   findSubareaRunoff(TSubarea* subarea, double tRunoff);            //(5.0.019 - LR)
-static void   updatePondedDepth(TSubarea* subarea, double* tx);
-static void   getDdDt(double t, double* d, double* dddt);
+static void   updatePondedDepth(TSubarea* subarea, double losses, double* tx);
+static void   getDdDt(double t, double* d, double* dddt, void* ctx);
+static int    findPondedDepth(TSubarea* subarea, double ix, double tx);
+static int    solveImplicitDepth(double alpha, double ix, double x0,
+              double tx, double theta, double* x1);
 static void   getPondedQual(double wUp[], double qUp, double qPpt,
               double qEvap, double qInfil, double v, double area,
               double tStep, double pondedQual[]);
@@ -411,6 +428,7 @@ void  subcatch_initState(int j)
     double curb;                       // curb length (users units)
     double startDrySeconds;            // antecedent dry period (sec)
     double buildup;                    // initial mass buildup (lbs or kg)
+    double days;                       // equivalent days of initial buildup
 
     // --- initialize rainfall, runoff, & snow depth
     Subcatch[j].rainfall = 0.0;
@@ -419,6 +437,9 @@ void  subcatch_initState(int j)
     Subcatch[j].oldSnowDepth = 0.0;
     Subcatch[j].newSnowDepth = 0.0;
     Subcatch[j].runon = 0.0;
+    Subcatch[j].oldDepth = 0.0;
+    Subcatch[j].evapLoss = 0.0;
+    Subcatch[j].infilLoss = 0.0;
 
     // --- set isUsed property of subcatchment's rain gage
     i = Subcatch[j].gage;
@@ -472,6 +493,7 @@ void  subcatch_initState(int j)
             // --- if an initial loading was supplied, then use it to
             //     find the starting buildup over the land use
             buildup = 0.0;
+            days = -1.0;
             if ( Subcatch[j].initBuildup[p] > 0.0 )
             {
                 buildup = Subcatch[j].initBuildup[p] * area;
@@ -480,8 +502,9 @@ void  subcatch_initState(int j)
             // --- otherwise use the land use's buildup function to 
             //     compute a buildup over the antecedent dry period
             else buildup = landuse_getBuildup(i, p, area, curb, buildup,
-                           startDrySeconds);
+                           &days, startDrySeconds);
             Subcatch[j].landFactor[i].buildup[p] = buildup;
+            Subcatch[j].landFactor[i].buildupDays[p] = days;
         }
     }
 }
@@ -671,6 +694,7 @@ double subcatch_getRunoff(int j, double tStep)
     double runoff      = 0.0;          // total runoff rate on subcatch (ft/sec)
     double pervEvapVol = 0.0;          // evaporation over pervious area (ft3)
     double evapRate    = 0.0;          // max. evaporation rate (ft/sec)       //(5.0.019 - LR)
+    TSubareaFlux flux;                 // subarea losses & outflow
 
     // NOTE: The 'runoff' value returned by this function is the total runoff
     //       generated (in ft/sec) by the subcatchment before any internal
@@ -681,7 +705,9 @@ double subcatch_getRunoff(int j, double tStep)
     //       LID controls) and is saved to Subcatch[j].newRunoff.
 
     // --- save current depth of ponded water
-    Vponded = subcatch_getDepth(j);
+    Subcatch[j].oldDepth = subcatch_getDepth(j);
+    Subcatch[j].evapLoss = 0.0;
+    Subcatch[j].infilLoss = 0.0;
 
     // --- get net precipitation (rainfall + snowmelt) on subcatchment
     getNetPrecip(j, netPrecip, tStep);
@@ -702,19 +728,23 @@ double subcatch_getRunoff(int j, double tStep)
         if ( area > 0.0 )
         {
             // --- get runoff rate from sub-area
-            getSubareaRunoff(j, i, netPrecip[i], evapRate, tStep);             //(5.0.019 - LR)
+            getSubareaRunoff(j, i, netPrecip[i], evapRate, tStep, &flux);      //(5.0.019 - LR)
             runoff += Subcatch[j].subArea[i].runoff * area;
 
             // --- update components of volumetric water balance (in ft3)
-            Subcatch[j].losses += Losses * area;
-            outflow    += Outflow * area;
-            evapVol    += Vevap * area;
-            infilVol   += Vinfil * area;
-            outflowVol += Voutflow * area;
+            Subcatch[j].losses += flux.losses * area;
+            outflow    += flux.outflow * area;
+            evapVol    += flux.vEvap * area;
+            infilVol   += flux.vInfil * area;
+            outflowVol += flux.vOutflow * area;
 
             // --- save evap losses from pervious area
             //     (needed for groundwater modeling)
-            if ( i == PERV ) pervEvapVol += Vevap * area;                      //(5.0.021 - LR)
+            if ( i == PERV ) pervEvapVol += flux.vEvap * area;                 //(5.0.021 - LR)
+
+            // --- save losses used for ponded water quality
+            Subcatch[j].evapLoss = flux.vEvap;
+            Subcatch[j].infilLoss = flux.vInfil;
         }
     }
 
@@ -863,7 +893,7 @@ void subcatch_getBuildup(int j, double tStep)
             // --- use land use's buildup function to update buildup amount
             oldBuildup = Subcatch[j].landFactor[i].buildup[p];        
             newBuildup = landuse_getBuildup(i, p, area, curb, oldBuildup,
-                         tStep);
+                         &Subcatch[j].landFactor[i].buildupDays[p], tStep);
             newBuildup = MAX(newBuildup, oldBuildup);                          //(5.0.014 - LR)
             Subcatch[j].landFactor[i].buildup[p] = newBuildup;
             massbal_updateLoadingTotals(BUILDUP_LOAD, p, 
@@ -917,6 +947,8 @@ void subcatch_sweepBuildup(int j, DateTime aDate)
                 newBuildup = MIN(oldBuildup, newBuildup);
                 newBuildup = MAX(0.0, newBuildup);
                 Subcatch[j].landFactor[i].buildup[p] = newBuildup;
+                if ( newBuildup < oldBuildup )
+                    Subcatch[j].landFactor[i].buildupDays[p] = -1.0;
 
                 // --- update mass balance totals
                 massbal_updateLoadingTotals(SWEEPING_LOAD, p,
@@ -960,8 +992,8 @@ void  subcatch_getWashoff(int j, double runoff, double tStep)
     // --- get flow rates of the various inflows & outflows
     qUp    = Subcatch[j].runon;             // upstream runon
     qPpt   = Subcatch[j].rainfall;          // precipitation (rain + snow)
-    qEvap  = Vevap / tStep;                 // evaporation
-    qInfil = Vinfil / tStep;                // infiltration
+    qEvap  = Subcatch[j].evapLoss / tStep;  // evaporation
+    qInfil = Subcatch[j].infilLoss / tStep; // infiltration
 
     // --- assign upstream runon load (computed previously from call to 
     //     subcatch_getRunon) and ponded quality to local variables
@@ -970,7 +1002,7 @@ void  subcatch_getWashoff(int j, double runoff, double tStep)
     pondedQual = Subcatch[j].pondedQual;
 
     // --- average the ponded depth volumes over the time step
-    v = 0.5 * (Vponded + subcatch_getDepth(j));
+    v = 0.5 * (Subcatch[j].oldDepth + subcatch_getDepth(j));
 
     // --- get quality in surface ponding at end of time step
     getPondedQual(wUp, qUp, qPpt, qEvap, qInfil, v, area, tStep, pondedQual);
@@ -1275,7 +1307,8 @@ char  sweptSurfacesDry(int j)
 
 ////  This function was re-written for the SWMM5 LID edition  ////             //(5.0.019 - LR)
 
-void getSubareaRunoff(int j, int i, double precip, double evap, double tStep)
+void getSubareaRunoff(int j, int i, double precip, double evap, double tStep,
+                      TSubareaFlux* flux)
 //
 //  Purpose: computes runoff & losses from a subarea over the current time step.
 //  Input:   j = subcatchment index
@@ -1283,7 +1316,7 @@ void getSubareaRunoff(int j, int i, double precip, double evap, double tStep)
 //           precip = rainfall + snowmelt over subarea (ft/sec)
 //           evap = evaporation (ft/sec)
 //           tStep = time step (sec)
-//  Output:  none
+//  Output:  flux = subarea's loss & outflow rates and volumes
 //
 {
     double    tRunoff;                 // time over which runoff occurs (sec)
@@ -1303,11 +1336,11 @@ void getSubareaRunoff(int j, int i, double precip, double evap, double tStep)
     oldRunoff = subarea->runoff;
     subarea->runoff = 0.0;
     infil    = 0.0;
-    Vevap    = 0.0;
-    Vinfil   = 0.0;
-    Voutflow = 0.0;
-    Losses   = 0.0;
-    Outflow  = 0.0;
+    flux->vEvap    = 0.0;
+    flux->vInfil   = 0.0;
+    flux->vOutflow = 0.0;
+    flux->losses   = 0.0;
+    flux->outflow  = 0.0;
 
     // --- no runoff if no area
     if ( subarea->fArea == 0.0 ) return;
@@ -1319,7 +1352,7 @@ void getSubareaRunoff(int j, int i, double precip, double evap, double tStep)
     surfEvap = MIN(surfMoisture, evap);
 
     // --- compute infiltration loss rate
-    if ( i == PERV ) infil = getSubareaInfil(j, subarea, tStep);
+    if ( i == PERV ) infil = getSubareaInfil(j, tStep);
 
     // --- add precip to other subarea inflows
     subarea->inflow += precip;
@@ -1328,20 +1361,20 @@ void getSubareaRunoff(int j, int i, double precip, double evap, double tStep)
 ////  End of modified code segment  ////                                       //(5.0.022 - LR)
 
     // --- save volumes lost to evaporation & infiltration
-    Vevap = surfEvap * tStep;
-    Vinfil = infil * tStep;
+    flux->vEvap = surfEvap * tStep;
+    flux->vInfil = infil * tStep;
 
     // --- if losses exceed available moisture then no ponded water remains
-    Losses = surfEvap + infil;
-    if ( Losses >= surfMoisture )
+    flux->losses = surfEvap + infil;
+    if ( flux->losses >= surfMoisture )
     {
-        Losses = surfMoisture;
+        flux->losses = surfMoisture;
         subarea->depth = 0.0;
     }
 
     // --- otherwise update depth of ponded water
     //     and time over which runoff occurs
-    else updatePondedDepth(subarea, &tRunoff);
+    else updatePondedDepth(subarea, flux->losses, &tRunoff);
 
     // --- compute runoff based on updated ponded depth
     findSubareaRunoff(subarea, tRunoff);
@@ -1351,9 +1384,9 @@ void getSubareaRunoff(int j, int i, double precip, double evap, double tStep)
     //     subcatchment outlet as opposed to another subarea of the subcatchment)
     if ( subarea->fOutlet > 0.0 )
     {
-        Voutflow = 0.5 * (oldRunoff + subarea->runoff) * tRunoff
-                  * subarea->fOutlet;
-        Outflow = subarea->fOutlet * subarea->runoff;
+        flux->vOutflow = 0.5 * (oldRunoff + subarea->runoff) * tRunoff
+                         * subarea->fOutlet;
+        flux->outflow = subarea->fOutlet * subarea->runoff;
     }
 }
 
@@ -1363,20 +1396,19 @@ void getSubareaRunoff(int j, int i, double precip, double evap, double tStep)
 ////  This function was re-written for release 5.0.021  ////                   //(5.0.021 - LR)
 ////  This function was re-written for release 5.0.022  ////                   //(5.0.022 - LR)
 
-double getSubareaInfil(int j, TSubarea* subarea, double tStep)
+double getSubareaInfil(int j, double tStep)
 //
 //  Purpose: computes infiltration rate at current time step.
 //  Input:   j = subcatchment index
-//           subarea = ptr. to a subarea
 //           tStep = time step (sec)
 //  Output:  returns infiltration rate (ft/s)
 //
 {
     double infil = 0.0;                     // actual infiltration rate (ft/sec)
 
-    // --- compute infiltration rate 
-    infil = infil_getInfil(j, InfilModel, tStep, Subcatch[j].rainfall,
-                           subarea->inflow, subarea->depth);
+    // --- retrieve infiltration rate found for all subcatchments at the
+    //     start of the time step (see infil_setRates)
+    infil = infil_getRate(j);
 
     // --- limit infiltration rate by available void space in unsaturated
     //     zone of any groundwater aquifer
@@ -1425,9 +1457,10 @@ void findSubareaRunoff(TSubarea* subarea, double tRunoff)
 
 //=============================================================================
 
-void updatePondedDepth(TSubarea* subarea, double* dt)
+void updatePondedDepth(TSubarea* subarea, double losses, double* dt)
 //
 //  Input:   subarea = ptr. to a subarea,
+//           losses = evap. + infil. loss rate (ft/sec)
 //           dt = time step (sec)
 //  Output:  dt = time ponded depth is above depression storage (sec)
 //  Purpose: computes new ponded depth over subarea after current time step.
@@ -1436,9 +1469,11 @@ void updatePondedDepth(TSubarea* subarea, double* dt)
     double ix;                         // excess inflow to subarea (ft/sec)
     double dx;                         // depth above depression storage (ft)
     double tx = *dt;                   // time over which dx > 0 (sec)
+    TDepthContext ctx;                 // context passed to getDdDt
+    double work[ODE_WORKSIZE(1)];      // ODE solver workspace
 
     // --- excess inflow = total inflow - losses
-    ix = subarea->inflow - Losses;
+    ix = subarea->inflow - losses;
 
     // --- see if not enough inflow to fill depression storage (dStore)
     if ( subarea->depth + ix*tx <= subarea->dStore )
@@ -1460,9 +1495,16 @@ void updatePondedDepth(TSubarea* subarea, double* dt)
         // --- now integrate depth over remaining time step tx
         if ( subarea->alpha > 0.0 && tx > 0.0 )
         {
-            theSubarea = subarea;
-            odesolve_integrate(&(subarea->depth), 1, 0, tx, ODETOL, tx,
-                               getDdDt);
+            // --- if requested, try a closed-form or implicit update
+            //     first, falling back to the adaptive Runge-Kutta solver
+            //     if it fails or is not accurate enough
+            if ( !ImplicitPonding || !findPondedDepth(subarea, ix, tx) )
+            {
+                ctx.subarea = subarea;
+                ctx.losses = losses;
+                odesolve_integrate(&(subarea->depth), 1, 0, tx, ODETOL, tx,
+                                   getDdDt, &ctx, work);
+            }
         }
         else
         {
@@ -1481,16 +1523,106 @@ void updatePondedDepth(TSubarea* subarea, double* dt)
 
 //=============================================================================
 
-void  getDdDt(double t, double* d, double* dddt)
+int findPondedDepth(TSubarea* subarea, double ix, double tx)
+//
+//  Input:   subarea = ptr. to a subarea whose depth is at or above dStore
+//           ix = excess inflow (inflow - losses) to subarea (ft/sec)
+//           tx = time step (sec)
+//  Output:  returns TRUE if subarea's ponded depth was updated, FALSE if
+//           the ODE solver must be used instead
+//  Purpose: updates ponded depth over a time step without the ODE solver.
+//
+//  The depth x above depression storage obeys dx/dt = ix - alpha*x^MEXP.
+//  With no excess inflow this has an exact solution. Otherwise the
+//  trapezoidal rule is solved with Newton's method and accepted only when
+//  its difference from a backward Euler solution, which bounds its error,
+//  is within the tolerance used by the ODE solver.
+{
+    double alpha = subarea->alpha;
+    double x0 = subarea->depth - subarea->dStore;
+    double x1, xBE, f0, scale;
+
+    if ( x0 < 0.0 ) return FALSE;
+
+    // --- exact recession when there is no excess inflow
+    if ( ix == 0.0 )
+    {
+        if ( x0 > 0.0 )
+        {
+            x1 = pow(x0, 1.0 - MEXP) + (MEXP - 1.0) * alpha * tx;
+            subarea->depth = subarea->dStore + pow(x1, 1.0 / (1.0 - MEXP));
+        }
+        return TRUE;
+    }
+
+    // --- trapezoidal & backward Euler solutions
+    if ( !solveImplicitDepth(alpha, ix, x0, tx, 0.5, &x1) ) return FALSE;
+    if ( !solveImplicitDepth(alpha, ix, x0, tx, 1.0, &xBE) ) return FALSE;
+
+    // --- accept trapezoidal solution if error estimate is small enough
+    //     (error is scaled the same way as in the ODE solver)
+    f0 = ix - alpha * pow(x0, MEXP);
+    scale = fabs(subarea->depth) + fabs(f0 * tx) + 1.0e-30;
+    if ( fabs(x1 - xBE) > ODETOL * scale ) return FALSE;
+    subarea->depth = subarea->dStore + x1;
+    return TRUE;
+}
+
+//=============================================================================
+
+int solveImplicitDepth(double alpha, double ix, double x0, double tx,
+                       double theta, double* x1)
+//
+//  Input:   alpha = subarea's Manning's coefficient
+//           ix = excess inflow to subarea (ft/sec)
+//           x0 = depth above depression storage at start of step (ft)
+//           tx = time step (sec)
+//           theta = implicit weighting (0.5 = trapezoidal, 1 = backward Euler)
+//  Output:  x1 = depth above depression storage at end of step (ft);
+//           returns TRUE if a non-negative solution was found
+//  Purpose: solves x1 = x0 + tx*(ix - alpha*(theta*x1^m + (1-theta)*x0^m))
+//           for x1 using Newton's method.
+//
+//  Note:    the residual is convex and increasing in x1 and the starting
+//           value makes it non-negative, so iterates decrease monotonically.
+{
+    int    iter;
+    double x, xm, g, dg, dx;
+    double c = x0 + tx * (ix - alpha * (1.0 - theta) * pow(x0, MEXP));
+
+    x = x0 + tx * MAX(ix, 0.0);
+    for (iter = 1; iter <= MAXNEWTON; iter++)
+    {
+        if ( x <= 0.0 ) return FALSE;
+        xm = alpha * pow(x, MEXP);
+        g  = x + tx * theta * xm - c;
+        dg = 1.0 + tx * theta * MEXP * xm / x;
+        dx = g / dg;
+        x -= dx;
+        if ( fabs(dx) <= 1.0e-6 * ODETOL * x )
+        {
+            if ( x < 0.0 ) return FALSE;
+            *x1 = x;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+//=============================================================================
+
+void  getDdDt(double t, double* d, double* dddt, void* ctx)
 //
 //  Input:   t = current time (not used)
 //           d = stored depth (ft)
+//           ctx = ptr. to the subarea & loss rate being analyzed
 //  Output   dddt = derivative of d with respect to time
 //  Purpose: evaluates derivative of stored depth w.r.t. time
 //           for the subarea whose runoff is being computed.
 //
 {
-    double ix = theSubarea->inflow - Losses;
+    TSubarea* theSubarea = ((TDepthContext *)ctx)->subarea;
+    double ix = theSubarea->inflow - ((TDepthContext *)ctx)->losses;
     double rx = *d - theSubarea->dStore;
     if ( rx < 0.0 )
     {
@@ -54,6 +54,11 @@
 #include <math.h>
 #include <time.h>
 #include <float.h>
+#ifndef WINDOWS
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#endif
 
 //-----------------------------------------------------------------------------
 //  SWMM's header files
@@ -453,6 +458,7 @@ void execRouting(DateTime elapsedTime)
 {
     double   nextRoutingTime;          // updated elapsed routing time (msec)
     double   routingStep;              // routing time step (sec)
+    double   dryStep;                  // dry weather routing time step (sec)
 
 #ifdef WINDOWS
     // --- begin exception handling loop here
@@ -476,6 +482,20 @@ void execRouting(DateTime elapsedTime)
             runoff_execute();
             if ( ErrorCode ) return;
         }
+
+        // --- when fast-forwarding through a dry runoff period over which
+        //     the network was also in steady state (as found only when
+        //     SKIP_STEADY_STATE is used), let steady or kinematic wave
+        //     routing step to the end of it (up to the reporting time step);
+        //     a change in dry weather or external inflow that occurs within
+        //     such a step is not seen until the step ends
+        if ( FastForwardDry && DoRunoff && DoRouting && RouteModel != DW
+        &&   runoff_isDry() && routing_isSteady() )
+        {
+            dryStep = MIN((NewRunoffTime - NewRoutingTime) / 1000.0,
+                          (double)ReportStep);
+            if ( dryStep > routingStep ) routingStep = dryStep;
+        }
   
         // --- route flows through drainage system over current time step
         if ( DoRouting ) routing_execute(RouteModel, routingStep);             //(5.0.010 - LR)
@@ -710,6 +730,68 @@ char* getTmpName(char* fname)
 
 //=============================================================================
 
+FILE* openTmpFile(char* fname, char* tmpName)
+//
+//  Input:   fname = name of a file about to be written
+//  Output:  tmpName = name of the file opened (MAXFNAME+1 chars);
+//           returns a new file opened for binary output (or NULL)
+//  Purpose: creates a uniquely named file in the same directory as fname
+//           that can be written and then renamed to fname without
+//           clashing with other runs writing the same file.
+//
+{
+    FILE* f = NULL;
+
+    // --- for Windows systems, add the process ID to the file name
+    #ifdef WINDOWS
+      if ( snprintf(tmpName, MAXFNAME+1, "%s.%lu.tmp", fname,
+                    (unsigned long)GetCurrentProcessId()) > MAXFNAME )
+          return NULL;
+      f = fopen(tmpName, "wb");
+
+    // --- for non-Windows systems, add the process ID and a counter to the
+    //     file name, creating only a file that does not already exist
+    #else
+      int fd = -1;
+      int k;
+      for (k = 0; k < 100 && fd < 0; k++)
+      {
+          if ( snprintf(tmpName, MAXFNAME+1, "%s.%ld.%d.tmp", fname,
+                        (long)getpid(), k) > MAXFNAME ) return NULL;
+          fd = open(tmpName, O_WRONLY | O_CREAT | O_EXCL, 0666);
+          if ( fd < 0 && errno != EEXIST ) return NULL;
+      }
+      if ( fd < 0 ) return NULL;
+      if ( (f = fdopen(fd, "wb")) == NULL )
+      {
+          close(fd);
+          remove(tmpName);
+      }
+    #endif
+    return f;
+}
+
+//=============================================================================
+
+unsigned long long hashBytes(const void* buf, size_t n, unsigned long long hash)
+//
+//  Input:   buf = array of bytes
+//           n = number of bytes in buf
+//           hash = hash of any bytes that precede buf (0 if none)
+//  Output:  returns a 64-bit FNV-1a hash of all the bytes
+//  Purpose: computes a checksum of data saved to or read from a file.
+//
+{
+    const unsigned char* bytes = (const unsigned char *)buf;
+    size_t k;
+
+    if ( hash == 0 ) hash = 14695981039346656037ULL;
+    for (k = 0; k < n; k++) hash = (hash ^ bytes[k]) * 1099511628211ULL;
+    return hash;
+}
+
+//=============================================================================
+
 void getElapsedTime(DateTime aDate, int* days, int* hrs, int* mins)
 //
 //  Input:   aDate = simulation calendar date + time
@@ -25,6 +25,10 @@
 //-----------------------------------------------------------------------------
 int  table_getNextFileEntry(TTable* table, double* x, double* y);
 int  table_parseFileLine(char* line, TTable* table, double* x, double* y);
+static int getFirstPoint(TTable* table, TTableEntry** entry, double* x,
+           double* y);
+static int getNextPoint(TTable* table, TTableEntry** entry, double* x,
+           double* y);
 
 
 //=============================================================================
@@ -415,10 +419,11 @@ double table_lookup(TTable *table, double x)
 //        returned.
 //
 {
+    TTableEntry* entry;
     double x1,y1,x2,y2;
-    table_getFirstEntry(table, &x1, &y1);
+    getFirstPoint(table, &entry, &x1, &y1);
     if ( x <= x1 ) return y1;
-    while ( table_getNextEntry(table, &x2, &y2) )
+    while ( getNextPoint(table, &entry, &x2, &y2) )
     {
         if ( x <= x2 ) return table_interpolate(x, x1, y1, x2, y2);
         x1 = x2;
@@ -439,15 +444,16 @@ double table_lookupEx(TTable *table, double x)
 //           extrapolation outside of the table.
 //
 {
+    TTableEntry* entry;
     double x1,y1,x2,y2;
     double s = 0.0;
-    table_getFirstEntry(table, &x1, &y1);
+    getFirstPoint(table, &entry, &x1, &y1);
     if ( x <= x1 )
     {
         if (x1 > 0.0 ) return x/x1*y1;
         else return y1;
     }
-    while ( table_getNextEntry(table, &x2, &y2) )
+    while ( getNextPoint(table, &entry, &x2, &y2) )
     {
         if ( x2 != x1 ) s = (y2 - y1) / (x2 - x1);
         if ( x <= x2 ) return table_interpolate(x, x1, y1, x2, y2);
@@ -469,10 +475,11 @@ double table_intervalLookup(TTable *table, double x)
 //           whose x-value is > x.
 //
 {
+    TTableEntry* entry;
     double xx, yy;
-    table_getFirstEntry(table, &xx, &yy);
+    getFirstPoint(table, &entry, &xx, &yy);
     if ( x < xx ) return yy;
-    while ( table_getNextEntry(table, &xx, &yy) )
+    while ( getNextPoint(table, &entry, &xx, &yy) )
     {
         if ( x < xx ) return yy;
     }
@@ -494,10 +501,11 @@ double table_inverseLookup(TTable *table, double y)
 //        returned.
 //
 {
+    TTableEntry* entry;
     double x1,y1,x2,y2;
-    table_getFirstEntry(table, &x1, &y1);
+    getFirstPoint(table, &entry, &x1, &y1);
     if ( y <= y1 ) return x1;
-    while ( table_getNextEntry(table, &x2, &y2) )
+    while ( getNextPoint(table, &entry, &x2, &y2) )
     {
         if ( y <= y2 ) return table_interpolate(y, y1, x1, y2, x2);
         x1 = x2;
@@ -597,6 +605,7 @@ double  table_getArea(TTable* table, double x)
 //     a(i) = y(i)*dx + s*dx*dx/2
 //
 {
+    TTableEntry* entry;
     double x1, x2;
     double y1, y2;
     double dx = 0.0, dy = 0.0;
@@ -604,13 +613,13 @@ double  table_getArea(TTable* table, double x)
 
     // --- get area up to first table entry
     //     and see if x-value lies in this interval
-    table_getFirstEntry(table, &x1, &y1);
+    getFirstPoint(table, &entry, &x1, &y1);
     if ( x1 > 0.0 ) s = y1/x1;
     if ( x <= x1 ) return s*x*x/2.0;
     a = y1*x1/2.0;
     
     // --- add next table entry to area until target x-value is bracketed
-    while ( table_getNextEntry(table, &x2, &y2) )
+    while ( getNextPoint(table, &entry, &x2, &y2) )
     {
         dx = x2 - x1;
         dy = y2 - y1;
@@ -644,13 +653,14 @@ double  table_getInverseArea(TTable* table, double a)
 //  Refer to table_getArea function to see how area is computed.
 //
 {
+    TTableEntry* entry;
     double x1, x2;
     double y1, y2;
     double dx = 0.0, dy = 0.0;
     double a1, a2, s;
 
     // --- see if target area is below that of 1st table entry
-    table_getFirstEntry(table, &x1, &y1);
+    getFirstPoint(table, &entry, &x1, &y1);
     a1 = y1*x1/2.0;
     if ( a <= a1 )
     {
@@ -659,7 +669,7 @@ double  table_getInverseArea(TTable* table, double a)
     }
 
     // --- add next table entry to area until target area is bracketed
-    while ( table_getNextEntry(table, &x2, &y2) )
+    while ( getNextPoint(table, &entry, &x2, &y2) )
     {
         dx = x2 - x1;
         dy = y2 - y1;
@@ -790,3 +800,52 @@ int  table_parseFileLine(char* line, TTable* table, double* x, double* y)
     *y = yy;
     return TRUE;
 }
+
+//=============================================================================
+
+int getFirstPoint(TTable* table, TTableEntry** entry, double* x, double* y)
+//
+//  Input:   table = pointer to a TTable structure
+//           entry = local position pointer
+//  Output:  x = x-value of first table entry
+//           y = y-value of first table entry
+//           returns TRUE if successful, FALSE if not
+//  Purpose: retrieves the first x/y entry in a table.
+//
+//  NOTE: unlike table_getFirstEntry this leaves the table's own position
+//        pointer (thisEntry) alone, so the same curve can be looked up
+//        from several routing threads at once. Tables read from a file
+//        still use the shared file position.
+//
+{
+    *entry = NULL;
+    *x = 0.0;
+    *y = 0.0;
+    if ( table->file.mode == USE_FILE ) return table_getFirstEntry(table, x, y);
+    *entry = table->firstEntry;
+    if ( *entry == NULL ) return FALSE;
+    *x = (*entry)->x;
+    *y = (*entry)->y;
+    return TRUE;
+}
+
+//=============================================================================
+
+int getNextPoint(TTable* table, TTableEntry** entry, double* x, double* y)
+//
+//  Input:   table = pointer to a TTable structure
+//           entry = local position pointer
+//  Output:  x = x-value of next table entry
+//           y = y-value of next table entry
+//           returns TRUE if successful, FALSE if not
+//  Purpose: retrieves the table entry that follows the local position
+//           pointer and advances that pointer.
+//
+{
+    if ( table->file.mode == USE_FILE ) return table_getNextEntry(table, x, y);
+    if ( *entry == NULL || (*entry)->next == NULL ) return FALSE;
+    *entry = (*entry)->next;
+    *x = (*entry)->x;
+    *y = (*entry)->y;
+    return TRUE;
+}
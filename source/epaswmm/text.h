@@ -94,6 +94,11 @@
 #define  w_IGNORE_GWATER     "IGNORE_GROUNDWATER"                              //(5.0.014 - LR)
 #define  w_IGNORE_ROUTING    "IGNORE_ROUTING"                                  //(5.0.014 - LR)
 #define  w_IGNORE_QUALITY    "IGNORE_QUALITY"                                  //(5.0.014 - LR)
+#define  w_DYNWAVE_SOLVER    "DYNWAVE_SOLVER"
+#define  w_STEP_CLASSES      "STEP_CLASSES"
+#define  w_FAST_FORWARD_DRY  "FAST_FORWARD_DRY"
+#define  w_IMPLICIT_PONDING  "IMPLICIT_PONDING"
+#define  w_INPUT_CACHE       "INPUT_CACHE"
 
 // Flow Units
 #define  w_CFS               "CFS"
@@ -222,6 +227,10 @@
 #define  w_H_W               "H-W"                                             //(5.0.010 - LR)
 #define  w_D_W               "D-W"                                             //(5.0.010 - LR)
 
+// Dynamic Wave Solution Methods
+#define  w_PICARD            "PICARD"
+#define  w_NEWTON            "NEWTON"
+
 // Link Offset Options                                                         //(5.0.012 - LR)
 #define  w_ELEVATION         "ELEVATION"                                       //(5.0.012 - LR)
          // w_DEPTH defined previously.                                        //(5.0.012 - LR)
@@ -41,7 +41,8 @@ static int   LoopLinksLast;            // number of links in a loop
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)   
 //-----------------------------------------------------------------------------
-//  toposort_sortLinks (called by routing_open)
+//  toposort_sortLinks      (called by routing_open)
+//  toposort_partitionLinks (called by routing_open)
 
 //-----------------------------------------------------------------------------
 //  Local functions
@@ -54,6 +55,7 @@ static void findSpanningTree(int startNode);
 static void evalLoop(int startLink);
 static int  traceLoop(int i1, int i2, int k);
 static void checkDummyLinks(void);                                             //(5.0.014 - LR)
+static int  findRoot(int parent[], int i);
 
 //=============================================================================
 
@@ -534,3 +536,102 @@ void checkDummyLinks()
 }
 
 //=============================================================================
+
+int toposort_partitionLinks(int sortedLinks[], int partStart[], int nodePart[])
+//
+//  Input:   sortedLinks = array of link indexes in sorted order
+//  Output:  sortedLinks = links re-ordered into contiguous partitions,
+//           partStart = position in sortedLinks where each partition
+//                       begins (with an extra entry marking the end),
+//           nodePart = partition of each node (-1 if it has no links);
+//           returns number of partitions
+//  Purpose: groups links into independent sub-networks that share no nodes
+//           (e.g., the trees draining to separate outfalls).
+//
+//  Note: links keep their relative sorted order within each partition, so
+//        each partition is itself topologically sorted.
+//
+{
+    int  i, j, n1, n2, nParts = 0;
+    int* parent;                       // union-find parent of each node
+    int* part;                         // partition index of each root node
+    int* links;                        // copy of original sorted links
+
+    if ( Nobjects[LINK] == 0 ) return 0;
+    parent = (int *) calloc(Nobjects[NODE], sizeof(int));
+    part   = (int *) calloc(Nobjects[NODE], sizeof(int));
+    links  = (int *) calloc(Nobjects[LINK], sizeof(int));
+    if ( parent == NULL || part == NULL || links == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+    }
+    else
+    {
+        // --- join the end nodes of each link into a common set
+        for (i = 0; i < Nobjects[NODE]; i++) parent[i] = i;
+        for (j = 0; j < Nobjects[LINK]; j++)
+        {
+            n1 = findRoot(parent, Link[j].node1);
+            n2 = findRoot(parent, Link[j].node2);
+            if ( n1 != n2 ) parent[n2] = n1;
+        }
+
+        // --- number the sets in order of first appearance in sortedLinks
+        //     & count the links in each one
+        for (i = 0; i < Nobjects[NODE]; i++) part[i] = -1;
+        for (i = 0; i <= Nobjects[LINK]; i++) partStart[i] = 0;
+        for (i = 0; i < Nobjects[LINK]; i++)
+        {
+            links[i] = sortedLinks[i];
+            n1 = findRoot(parent, Link[links[i]].node1);
+            if ( part[n1] < 0 )
+            {
+                part[n1] = nParts;
+                nParts++;
+            }
+            partStart[part[n1]+1]++;
+        }
+        for (i = 0; i < nParts; i++) partStart[i+1] += partStart[i];
+
+        // --- place each link in its partition, preserving sorted order
+        for (i = 0; i < Nobjects[LINK]; i++)
+        {
+            n1 = part[findRoot(parent, Link[links[i]].node1)];
+            sortedLinks[partStart[n1]] = links[i];
+            partStart[n1]++;
+        }
+        for (i = nParts; i > 0; i--) partStart[i] = partStart[i-1];
+        partStart[0] = 0;
+
+        // --- assign each node the partition of its set
+        for (i = 0; i < Nobjects[NODE]; i++)
+        {
+            nodePart[i] = part[findRoot(parent, i)];
+        }
+    }
+    FREE(parent);
+    FREE(part);
+    FREE(links);
+    return nParts;
+}
+
+//=============================================================================
+
+int findRoot(int parent[], int i)
+//
+//  Input:   parent = union-find parent of each node
+//           i = node index
+//  Output:  returns index of root node of set containing node i
+//  Purpose: finds the set that a node belongs to, shortening the
+//           path to the root along the way.
+//
+{
+    while ( parent[i] != i )
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+//=============================================================================
@@ -76,6 +76,7 @@ double  Amax[] = {
 static double  Sstar;                // section factor 
 static TXsect* Xstar;                // pointer to a cross section object        
 static double  Qcritical;            // critical flow
+#pragma omp threadprivate(Sstar, Xstar, Qcritical)
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)